@@ -25,9 +25,10 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "py/objlist.h"
-#include "py/objstringio.h"
+#include "py/objstr.h"
 #include "py/parsenum.h"
 #include "py/runtime.h"
 #include "py/stream.h"
@@ -36,10 +37,53 @@
 
 #if MICROPY_PY_UJSON
 
+// dump collects the many small pieces the print path produces and writes
+// them to the stream MICROPY_PY_UJSON_DUMP_BUF_SIZE bytes at a time.
+typedef struct _ujson_dump_buf_t {
+    mp_obj_t stream;
+    size_t len;
+    byte buf[MICROPY_PY_UJSON_DUMP_BUF_SIZE];
+} ujson_dump_buf_t;
+
+STATIC void ujson_dump_flush(ujson_dump_buf_t *b) {
+    size_t len = b->len;
+    if (len > 0) {
+        // emptied first so that data isn't written again if writing fails
+        b->len = 0;
+        mp_stream_write(b->stream, b->buf, len, MP_STREAM_RW_WRITE);
+    }
+}
+
+STATIC void ujson_dump_strn(void *env, const char *str, size_t len) {
+    ujson_dump_buf_t *b = env;
+    if (b->len + len > sizeof(b->buf)) {
+        ujson_dump_flush(b);
+        if (len >= sizeof(b->buf)) {
+            mp_stream_write(b->stream, str, len, MP_STREAM_RW_WRITE);
+            return;
+        }
+    }
+    memcpy(b->buf + b->len, str, len);
+    b->len += len;
+}
+
 STATIC mp_obj_t mod_ujson_dump(mp_obj_t obj, mp_obj_t stream) {
     mp_get_stream_raise(stream, MP_STREAM_OP_WRITE);
-    mp_print_t print = {MP_OBJ_TO_PTR(stream), mp_stream_write_adaptor};
-    mp_obj_print_helper(&print, obj, PRINT_JSON);
+    ujson_dump_buf_t b;
+    b.stream = stream;
+    b.len = 0;
+    mp_print_t print = {&b, ujson_dump_strn};
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_obj_print_helper(&print, obj, PRINT_JSON);
+        nlr_pop();
+    } else {
+        // what was printed before the error is written, as it would be
+        // without the buffer
+        ujson_dump_flush(&b);
+        nlr_jump(nlr.ret_val);
+    }
+    ujson_dump_flush(&b);
     return mp_const_none;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(mod_ujson_dump_obj, mod_ujson_dump);
@@ -71,27 +115,147 @@ typedef struct _ujson_stream_t {
     mp_uint_t (*read)(mp_obj_t obj, void *buf, mp_uint_t size, int *errcode);
     int errcode;
     byte cur;
+    // the bytes after cur that are already in memory: a part of the stream
+    // read into buf, or the whole of the input for loads
+    const byte *ptr;
+    const byte *end;
+    byte *buf;
 } ujson_stream_t;
 
 #define S_EOF (0) // null is not allowed in json stream so is ok as EOF marker
 #define S_END(s) ((s).cur == S_EOF)
 #define S_CUR(s) ((s).cur)
-#define S_NEXT(s) (ujson_stream_next(&(s)))
+#define S_NEXT(s) ((s).ptr < (s).end ? ((s).cur = *(s).ptr++) : ujson_stream_next(&(s)))
 
 STATIC byte ujson_stream_next(ujson_stream_t *s) {
-    mp_uint_t ret = s->read(s->stream_obj, &s->cur, 1, &s->errcode);
-    if (s->errcode != 0) {
-        mp_raise_OSError(s->errcode);
+    mp_uint_t ret = 0;
+    if (s->read != NULL) {
+        ret = s->read(s->stream_obj, s->buf, MICROPY_PY_UJSON_LOAD_BUF_SIZE, &s->errcode);
+        if (s->errcode != 0) {
+            mp_raise_OSError(s->errcode);
+        }
     }
     if (ret == 0) {
         s->cur = S_EOF;
+        return S_EOF;
     }
+    s->ptr = s->buf;
+    s->end = s->buf + ret;
+    s->cur = *s->ptr++;
     return s->cur;
 }
 
-STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
-    const mp_stream_p_t *stream_p = mp_get_stream_raise(stream_obj, MP_STREAM_OP_READ);
-    ujson_stream_t s = {stream_obj, stream_p->read, 0, 0};
+// Parse the null, boolean, string or number that starts with cur, which has
+// been taken from the stream.  Returns MP_OBJ_NULL if it isn't one.
+STATIC mp_obj_t ujson_load_primitive(ujson_stream_t *s, vstr_t *vstr, byte cur, bool key) {
+    (void)key;
+    switch (cur) {
+        case 'n':
+            if (S_CUR(*s) == 'u' && S_NEXT(*s) == 'l' && S_NEXT(*s) == 'l') {
+                S_NEXT(*s);
+                return mp_const_none;
+            }
+            return MP_OBJ_NULL;
+        case 'f':
+            if (S_CUR(*s) == 'a' && S_NEXT(*s) == 'l' && S_NEXT(*s) == 's' && S_NEXT(*s) == 'e') {
+                S_NEXT(*s);
+                return mp_const_false;
+            }
+            return MP_OBJ_NULL;
+        case 't':
+            if (S_CUR(*s) == 'r' && S_NEXT(*s) == 'u' && S_NEXT(*s) == 'e') {
+                S_NEXT(*s);
+                return mp_const_true;
+            }
+            return MP_OBJ_NULL;
+        case '"':
+            vstr_reset(vstr);
+            for (; !S_END(*s) && S_CUR(*s) != '"';) {
+                byte c = S_CUR(*s);
+                if (c == '\\') {
+                    c = S_NEXT(*s);
+                    switch (c) {
+                        case 'b': c = 0x08; break;
+                        case 'f': c = 0x0c; break;
+                        case 'n': c = 0x0a; break;
+                        case 'r': c = 0x0d; break;
+                        case 't': c = 0x09; break;
+                        case 'u': {
+                            mp_uint_t num = 0;
+                            for (int i = 0; i < 4; i++) {
+                                c = (S_NEXT(*s) | 0x20) - '0';
+                                if (c > 9) {
+                                    c -= ('a' - ('9' + 1));
+                                }
+                                num = (num << 4) | c;
+                            }
+                            vstr_add_char(vstr, num);
+                            goto str_cont;
+                        }
+                    }
+                }
+                vstr_add_byte(vstr, c);
+                if (c != '\\') {
+                    // take the rest of a run of plain characters at once
+                    const byte *top = s->ptr;
+                    while (top < s->end && *top != '"' && *top != '\\' && *top != S_EOF) {
+                        top++;
+                    }
+                    vstr_add_strn(vstr, (const char*)s->ptr, top - s->ptr);
+                    s->ptr = top;
+                }
+            str_cont:
+                S_NEXT(*s);
+            }
+            if (S_END(*s)) {
+                return MP_OBJ_NULL;
+            }
+            S_NEXT(*s);
+            #if MICROPY_PY_UJSON_QSTR_KEYS_ONLY
+            if (!key) {
+                // not worth looking for as a qstr
+                return mp_obj_new_str_copy(&mp_type_str, (const byte*)vstr->buf, vstr->len);
+            }
+            #endif
+            return mp_obj_new_str(vstr->buf, vstr->len);
+        case '-':
+        case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9': {
+            bool flt = false;
+            vstr_reset(vstr);
+            vstr_add_byte(vstr, cur);
+            for (;;) {
+                cur = S_CUR(*s);
+                if (cur == '.' || cur == 'E' || cur == 'e') {
+                    flt = true;
+                } else if (cur == '-' || unichar_isdigit(cur)) {
+                    // pass
+                } else {
+                    break;
+                }
+                vstr_add_byte(vstr, cur);
+                if (s->ptr < s->end && unichar_isdigit(*s->ptr)) {
+                    // take the rest of a run of digits at once
+                    const byte *top = s->ptr + 1;
+                    while (top < s->end && unichar_isdigit(*top)) {
+                        top++;
+                    }
+                    vstr_add_strn(vstr, (const char*)s->ptr, top - s->ptr);
+                    s->ptr = top;
+                }
+                S_NEXT(*s);
+            }
+            if (flt) {
+                return mp_parse_num_decimal(vstr->buf, vstr->len, false, false, NULL);
+            } else {
+                return mp_parse_num_integer(vstr->buf, vstr->len, 10, NULL);
+            }
+        }
+        default:
+            return MP_OBJ_NULL;
+    }
+}
+
+STATIC mp_obj_t ujson_load(ujson_stream_t s) {
     vstr_t vstr;
     vstr_init(&vstr, 8);
     mp_obj_list_t stack; // we use a list as a simple stack for nested JSON
@@ -119,88 +283,16 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
             case '\r':
                 goto cont;
             case 'n':
-                if (S_CUR(s) == 'u' && S_NEXT(s) == 'l' && S_NEXT(s) == 'l') {
-                    S_NEXT(s);
-                    next = mp_const_none;
-                } else {
-                    goto fail;
-                }
-                break;
             case 'f':
-                if (S_CUR(s) == 'a' && S_NEXT(s) == 'l' && S_NEXT(s) == 's' && S_NEXT(s) == 'e') {
-                    S_NEXT(s);
-                    next = mp_const_false;
-                } else {
-                    goto fail;
-                }
-                break;
             case 't':
-                if (S_CUR(s) == 'r' && S_NEXT(s) == 'u' && S_NEXT(s) == 'e') {
-                    S_NEXT(s);
-                    next = mp_const_true;
-                } else {
-                    goto fail;
-                }
-                break;
             case '"':
-                vstr_reset(&vstr);
-                for (; !S_END(s) && S_CUR(s) != '"';) {
-                    byte c = S_CUR(s);
-                    if (c == '\\') {
-                        c = S_NEXT(s);
-                        switch (c) {
-                            case 'b': c = 0x08; break;
-                            case 'f': c = 0x0c; break;
-                            case 'n': c = 0x0a; break;
-                            case 'r': c = 0x0d; break;
-                            case 't': c = 0x09; break;
-                            case 'u': {
-                                mp_uint_t num = 0;
-                                for (int i = 0; i < 4; i++) {
-                                    c = (S_NEXT(s) | 0x20) - '0';
-                                    if (c > 9) {
-                                        c -= ('a' - ('9' + 1));
-                                    }
-                                    num = (num << 4) | c;
-                                }
-                                vstr_add_char(&vstr, num);
-                                goto str_cont;
-                            }
-                        }
-                    }
-                    vstr_add_byte(&vstr, c);
-                str_cont:
-                    S_NEXT(s);
-                }
-                if (S_END(s)) {
-                    goto fail;
-                }
-                S_NEXT(s);
-                next = mp_obj_new_str(vstr.buf, vstr.len);
-                break;
             case '-':
-            case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9': {
-                bool flt = false;
-                vstr_reset(&vstr);
-                for (;;) {
-                    vstr_add_byte(&vstr, cur);
-                    cur = S_CUR(s);
-                    if (cur == '.' || cur == 'E' || cur == 'e') {
-                        flt = true;
-                    } else if (cur == '-' || unichar_isdigit(cur)) {
-                        // pass
-                    } else {
-                        break;
-                    }
-                    S_NEXT(s);
-                }
-                if (flt) {
-                    next = mp_parse_num_decimal(vstr.buf, vstr.len, false, false, NULL);
-                } else {
-                    next = mp_parse_num_integer(vstr.buf, vstr.len, 10, NULL);
+            case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+                next = ujson_load_primitive(&s, &vstr, cur, stack_top_type == &mp_type_dict && stack_key == MP_OBJ_NULL);
+                if (next == MP_OBJ_NULL) {
+                    goto fail;
                 }
                 break;
-            }
             case '[':
                 next = mp_obj_new_list(0, NULL);
                 enter = true;
@@ -280,17 +372,177 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
     fail:
     mp_raise_ValueError(translate("syntax error in JSON"));
 }
+
+STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
+    const mp_stream_p_t *stream_p = mp_get_stream_raise(stream_obj, MP_STREAM_OP_READ);
+    byte buf[MICROPY_PY_UJSON_LOAD_BUF_SIZE];
+    ujson_stream_t s = {stream_obj, stream_p->read, 0, 0, buf, buf, buf};
+    return ujson_load(s);
+}
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_load_obj, mod_ujson_load);
 
 STATIC mp_obj_t mod_ujson_loads(mp_obj_t obj) {
     size_t len;
-    const char *buf = mp_obj_str_get_data(obj, &len);
-    vstr_t vstr = {len, len, (char*)buf, true};
-    mp_obj_stringio_t sio = {{&mp_type_stringio}, &vstr, 0, MP_OBJ_NULL};
-    return mod_ujson_load(MP_OBJ_FROM_PTR(&sio));
+    const byte *buf = (const byte*)mp_obj_str_get_data(obj, &len);
+    // the input is parsed where it is, with nothing to read once it runs out
+    ujson_stream_t s = {obj, NULL, 0, 0, buf, buf + len, NULL};
+    return ujson_load(s);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_loads_obj, mod_ujson_loads);
 
+#if MICROPY_PY_UJSON_TOKENIZE
+// tokenize(stream) parses a document a piece at a time, yielding an
+// (event, value) tuple for each piece, so that memory use is bounded by the
+// longest string in it rather than by the whole document.  Unlike load it
+// checks that commas, colons and brackets are where they belong.
+
+typedef struct _mp_obj_ujson_tokenizer_t {
+    mp_obj_base_t base;
+    ujson_stream_t s;
+    vstr_t vstr;
+    uint16_t depth;
+    bool started;
+    // for each enclosing container, whether it is an object
+    byte in_object[MICROPY_PY_UJSON_TOKENIZE_DEPTH / 8];
+    // what may come next: a key, a value, or a separator before either, and
+    // whether the innermost container has just been opened
+    bool want_key;
+    bool want_sep;
+    bool opened;
+    byte buf[MICROPY_PY_UJSON_LOAD_BUF_SIZE];
+} mp_obj_ujson_tokenizer_t;
+
+STATIC bool ujson_tokenizer_in_object(mp_obj_ujson_tokenizer_t *self) {
+    size_t d = self->depth - 1;
+    return self->depth > 0 && (self->in_object[d / 8] & (1 << (d % 8)));
+}
+
+STATIC mp_obj_t ujson_tokenizer_iternext(mp_obj_t self_in) {
+    mp_obj_ujson_tokenizer_t *self = MP_OBJ_TO_PTR(self_in);
+    ujson_stream_t *s = &self->s;
+    if (!self->started) {
+        self->started = true;
+        S_NEXT(*s);
+    }
+    for (;;) {
+        byte cur = S_CUR(*s);
+        if (S_END(*s)) {
+            if (self->depth > 0 || !self->want_sep) {
+                goto fail;
+            }
+            return MP_OBJ_STOP_ITERATION;
+        }
+        if (unichar_isspace(cur)) {
+            S_NEXT(*s);
+            continue;
+        }
+        if (self->depth == 0 && self->want_sep) {
+            // only whitespace may follow the document
+            goto fail;
+        }
+        S_NEXT(*s);
+        bool opened = self->opened;
+        self->opened = false;
+        qstr event;
+        mp_obj_t value = mp_const_none;
+        switch (cur) {
+            case ',':
+            case ':':
+                if (!self->want_sep || (cur == ':') != (ujson_tokenizer_in_object(self) && !self->want_key)) {
+                    goto fail;
+                }
+                self->want_sep = false;
+                continue;
+            case '[':
+            case '{': {
+                if (self->want_sep || self->want_key) {
+                    goto fail;
+                }
+                if (self->depth == MICROPY_PY_UJSON_TOKENIZE_DEPTH) {
+                    mp_raise_RuntimeError(translate("maximum recursion depth exceeded"));
+                }
+                size_t d = self->depth++;
+                if (cur == '{') {
+                    self->in_object[d / 8] |= 1 << (d % 8);
+                    self->want_key = true;
+                    event = MP_QSTR_start_object;
+                } else {
+                    self->in_object[d / 8] &= ~(1 << (d % 8));
+                    event = MP_QSTR_start_array;
+                }
+                self->opened = true;
+                break;
+            }
+            case ']':
+            case '}': {
+                bool in_object = ujson_tokenizer_in_object(self);
+                if (self->depth == 0 || in_object != (cur == '}')) {
+                    goto fail;
+                }
+                // the container must be empty or end with a whole value
+                if (!opened && !(self->want_sep && (!in_object || self->want_key))) {
+                    goto fail;
+                }
+                self->depth--;
+                event = in_object ? MP_QSTR_end_object : MP_QSTR_end_array;
+                goto value_done;
+            }
+            default:
+                if (self->want_sep || (self->want_key && cur != '"')) {
+                    goto fail;
+                }
+                value = ujson_load_primitive(s, &self->vstr, cur, self->want_key);
+                if (value == MP_OBJ_NULL) {
+                    goto fail;
+                }
+                if (self->want_key) {
+                    self->want_key = false;
+                    self->want_sep = true;
+                    event = MP_QSTR_key;
+                    break;
+                }
+                event = MP_QSTR_value;
+            value_done:
+                // a value ends an object member, so a key follows the comma
+                self->want_sep = true;
+                self->want_key = ujson_tokenizer_in_object(self);
+                break;
+        }
+        mp_obj_t items[2] = {MP_OBJ_NEW_QSTR(event), value};
+        return mp_obj_new_tuple(2, items);
+    }
+
+fail:
+    mp_raise_ValueError(translate("syntax error in JSON"));
+}
+
+STATIC const mp_obj_type_t ujson_tokenizer_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_tokenize,
+    .getiter = mp_identity_getiter,
+    .iternext = ujson_tokenizer_iternext,
+};
+
+STATIC mp_obj_t mod_ujson_tokenize(mp_obj_t stream_obj) {
+    const mp_stream_p_t *stream_p = mp_get_stream_raise(stream_obj, MP_STREAM_OP_READ);
+    mp_obj_ujson_tokenizer_t *o = m_new_obj(mp_obj_ujson_tokenizer_t);
+    o->base.type = &ujson_tokenizer_type;
+    o->s.stream_obj = stream_obj;
+    o->s.read = stream_p->read;
+    o->s.errcode = 0;
+    o->s.cur = 0;
+    o->s.ptr = o->s.end = o->s.buf = o->buf;
+    vstr_init(&o->vstr, 8);
+    o->depth = 0;
+    o->started = false;
+    o->want_key = false;
+    o->want_sep = false;
+    o->opened = false;
+    return MP_OBJ_FROM_PTR(o);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_tokenize_obj, mod_ujson_tokenize);
+#endif
+
 STATIC const mp_rom_map_elem_t mp_module_ujson_globals_table[] = {
 #if CIRCUITPY
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_json) },
@@ -301,6 +553,9 @@ STATIC const mp_rom_map_elem_t mp_module_ujson_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_dumps), MP_ROM_PTR(&mod_ujson_dumps_obj) },
     { MP_ROM_QSTR(MP_QSTR_load), MP_ROM_PTR(&mod_ujson_load_obj) },
     { MP_ROM_QSTR(MP_QSTR_loads), MP_ROM_PTR(&mod_ujson_loads_obj) },
+    #if MICROPY_PY_UJSON_TOKENIZE
+    { MP_ROM_QSTR(MP_QSTR_tokenize), MP_ROM_PTR(&mod_ujson_tokenize_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_ujson_globals, mp_module_ujson_globals_table);
@@ -43,6 +43,16 @@
 
 typedef struct _mp_obj_re_t {
     mp_obj_base_t base;
+    #if MICROPY_PY_URE_PIKEVM
+    // the pattern can branch so is matched with re1_5_pikevm
+    bool pikevm;
+    // thread lists for re1_5_pikevm, allocated by the first match
+    char *pikevm_mem;
+    #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+    // set while a match uses pikevm_mem
+    bool pikevm_busy;
+    #endif
+    #endif
     ByteProg re;
 } mp_obj_re_t;
 
@@ -171,6 +181,40 @@ STATIC void re_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t
     mp_printf(print, "<re %p>", self);
 }
 
+// caps must be all NULL on entry.
+STATIC int ure_exec_prog(mp_obj_re_t *self, Subject *subj, const char **caps, int caps_num, bool is_anchored) {
+    #if MICROPY_PY_URE_PIKEVM
+    if (self->pikevm) {
+        #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+        // Without the GIL another thread may be matching the same pattern,
+        // in which case this match has thread lists of its own.
+        if (__atomic_test_and_set(&self->pikevm_busy, __ATOMIC_ACQUIRE)) {
+            size_t mem_size = re1_5_pikevm_memsize(&self->re, caps_num);
+            char *mem = m_new(char, mem_size);
+            int res = re1_5_pikevm(&self->re, subj, caps, caps_num, is_anchored, mem);
+            m_del(char, mem, mem_size);
+            return res;
+        }
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) != 0) {
+            __atomic_clear(&self->pikevm_busy, __ATOMIC_RELEASE);
+            nlr_jump(nlr.ret_val);
+        }
+        #endif
+        if (self->pikevm_mem == NULL) {
+            self->pikevm_mem = m_new(char, re1_5_pikevm_memsize(&self->re, caps_num));
+        }
+        int res = re1_5_pikevm(&self->re, subj, caps, caps_num, is_anchored, self->pikevm_mem);
+        #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+        nlr_pop();
+        __atomic_clear(&self->pikevm_busy, __ATOMIC_RELEASE);
+        #endif
+        return res;
+    }
+    #endif
+    return re1_5_recursiveloopprog(&self->re, subj, caps, caps_num, is_anchored);
+}
+
 STATIC mp_obj_t ure_exec(bool is_anchored, uint n_args, const mp_obj_t *args) {
     (void)n_args;
     mp_obj_re_t *self = MP_OBJ_TO_PTR(args[0]);
@@ -211,7 +255,7 @@ STATIC mp_obj_t ure_exec(bool is_anchored, uint n_args, const mp_obj_t *args) {
     mp_obj_match_t *match = m_new_obj_var(mp_obj_match_t, char*, caps_num);
     // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
     memset((char*)match->caps, 0, caps_num * sizeof(char*));
-    int res = re1_5_recursiveloopprog(&self->re, &subj, match->caps, caps_num, is_anchored);
+    int res = ure_exec_prog(self, &subj, match->caps, caps_num, is_anchored);
     if (res == 0) {
         m_del_var(mp_obj_match_t, char*, caps_num, match);
         return mp_const_none;
@@ -252,7 +296,7 @@ STATIC mp_obj_t re_split(size_t n_args, const mp_obj_t *args) {
     while (true) {
         // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
         memset((char**)caps, 0, caps_num * sizeof(char*));
-        int res = re1_5_recursiveloopprog(&self->re, &subj, caps, caps_num, false);
+        int res = ure_exec_prog(self, &subj, caps, caps_num, false);
 
         // if we didn't have a match, or had an empty match, it's time to stop
         if (!res || caps[0] == caps[1]) {
@@ -307,7 +351,7 @@ STATIC mp_obj_t re_sub_helper(mp_obj_t self_in, size_t n_args, const mp_obj_t *a
     for (;;) {
         // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
         memset((char*)match->caps, 0, caps_num * sizeof(char*));
-        int res = re1_5_recursiveloopprog(&self->re, &subj, match->caps, caps_num, false);
+        int res = ure_exec_prog(self, &subj, match->caps, caps_num, false);
 
         // If we didn't have a match, or had an empty match, it's time to stop
         if (!res || match->caps[0] == match->caps[1]) {
@@ -434,16 +478,41 @@ error:
     if (flags & FLAG_DEBUG) {
         re1_5_dumpcode(&o->re);
     }
+    #if MICROPY_PY_URE_PIKEVM
+    // Patterns with alternatives or repeats run in linear time, without
+    // recursing, on thread lists kept from the first match.  Others can't
+    // backtrack so the recursive matcher is as good and needs no memory.
+    o->pikevm = re1_5_canbranch(&o->re);
+    o->pikevm_mem = NULL;
+    #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+    o->pikevm_busy = false;
+    #endif
+    #endif
     return MP_OBJ_FROM_PTR(o);
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_re_compile_obj, 1, 2, mod_re_compile);
 
+// The module-level functions compile a pattern for a single call, so give
+// back its thread lists instead of leaving them to the next collection.
+STATIC void mod_re_free_prog(mp_obj_t self_in) {
+    #if MICROPY_PY_URE_PIKEVM
+    mp_obj_re_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->pikevm_mem != NULL) {
+        m_del(char, self->pikevm_mem, re1_5_pikevm_memsize(&self->re, (self->re.sub + 1) * 2));
+        self->pikevm_mem = NULL;
+    }
+    #else
+    (void)self_in;
+    #endif
+}
+
 STATIC mp_obj_t mod_re_exec(bool is_anchored, uint n_args, const mp_obj_t *args) {
     (void)n_args;
     mp_obj_t self = mod_re_compile(1, args);
 
     const mp_obj_t args2[] = {self, args[1]};
     mp_obj_t match = ure_exec(is_anchored, 2, args2);
+    mod_re_free_prog(self);
     return match;
 }
 
@@ -460,7 +529,9 @@ MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_re_search_obj, 2, 4, mod_re_search);
 #if MICROPY_PY_URE_SUB
 STATIC mp_obj_t mod_re_sub(size_t n_args, const mp_obj_t *args) {
     mp_obj_t self = mod_re_compile(1, args);
-    return re_sub_helper(self, n_args, args);
+    mp_obj_t res = re_sub_helper(self, n_args, args);
+    mod_re_free_prog(self);
+    return res;
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_re_sub_obj, 3, 5, mod_re_sub);
 #endif
@@ -494,6 +565,9 @@ const mp_obj_module_t mp_module_ure = {
 #include "re1.5/compilecode.c"
 #include "re1.5/dumpcode.c"
 #include "re1.5/recursiveloop.c"
+#if MICROPY_PY_URE_PIKEVM
+#include "re1.5/pikevm.c"
+#endif
 #include "re1.5/charclass.c"
 
 #endif //MICROPY_PY_URE
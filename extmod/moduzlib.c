@@ -47,6 +47,8 @@
 typedef struct _mp_obj_decompio_t {
     mp_obj_base_t base;
     mp_obj_t src_stream;
+    // the caller's buffer used for the dictionary, if one was given
+    mp_obj_t window;
     TINF_DATA decomp;
     bool eof;
 } mp_obj_decompio_t;
@@ -70,13 +72,14 @@ STATIC int read_src_stream(TINF_DATA *data) {
 }
 
 STATIC mp_obj_t decompio_make_new(const mp_obj_type_t *type, size_t n_args, const mp_obj_t *args, mp_map_t *kw_args) {
-    mp_arg_check_num(n_args, kw_args, 1, 2, false);
+    mp_arg_check_num(n_args, kw_args, 1, 3, false);
     mp_get_stream_raise(args[0], MP_STREAM_OP_READ);
     mp_obj_decompio_t *o = m_new_obj(mp_obj_decompio_t);
     o->base.type = type;
     memset(&o->decomp, 0, sizeof(o->decomp));
     o->decomp.readSource = read_src_stream;
     o->src_stream = args[0];
+    o->window = MP_OBJ_NULL;
     o->eof = false;
 
     mp_int_t dict_opt = 0;
@@ -102,7 +105,21 @@ header_error:
         dict_sz = 1 << -dict_opt;
     }
 
-    uzlib_uncompress_init(&o->decomp, m_new(byte, dict_sz), dict_sz);
+    byte *dict;
+    if (n_args > 2) {
+        // the dictionary goes in the caller's buffer, which may be set aside
+        // early on so that no window has to be found in a fragmented heap
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(args[2], &bufinfo, MP_BUFFER_WRITE);
+        if (bufinfo.len < (size_t)dict_sz) {
+            mp_raise_ValueError(translate("buffer too small"));
+        }
+        o->window = args[2];
+        dict = bufinfo.buf;
+    } else {
+        dict = m_new(byte, dict_sz);
+    }
+    uzlib_uncompress_init(&o->decomp, dict, dict_sz);
     return MP_OBJ_FROM_PTR(o);
 }
 
@@ -150,12 +167,29 @@ STATIC mp_obj_t mod_uzlib_decompress(size_t n_args, const mp_obj_t *args) {
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
 
+    // The output goes into the caller's buffer if bufsize is one.  Else it
+    // goes into a buffer of bufsize bytes, or about the size of the input,
+    // which grows by half each time it fills.
+    mp_buffer_info_t destinfo;
+    bool into = n_args > 2 && mp_get_buffer(args[2], &destinfo, MP_BUFFER_WRITE);
+    mp_uint_t dest_buf_size;
+    byte *dest_buf;
+    // uzlib always writes a byte before it checks for room, so an empty
+    // buffer gets somewhere for that to go
+    byte spare;
+    if (into) {
+        dest_buf_size = destinfo.len;
+        dest_buf = dest_buf_size > 0 ? destinfo.buf : &spare;
+    } else {
+        mp_int_t size_hint = n_args > 2 ? mp_obj_get_int(args[2]) : 0;
+        dest_buf_size = size_hint > 0 ? (mp_uint_t)size_hint : (bufinfo.len + 15) & ~15;
+        dest_buf = m_new(byte, dest_buf_size);
+    }
+
     TINF_DATA *decomp = m_new_obj(TINF_DATA);
     memset(decomp, 0, sizeof(*decomp));
     DEBUG_printf("sizeof(TINF_DATA)=" UINT_FMT "\n", sizeof(*decomp));
     uzlib_uncompress_init(decomp, NULL, 0);
-    mp_uint_t dest_buf_size = (bufinfo.len + 15) & ~15;
-    byte *dest_buf = m_new(byte, dest_buf_size);
 
     decomp->dest = dest_buf;
     decomp->dest_limit = dest_buf+dest_buf_size;
@@ -184,14 +218,44 @@ STATIC mp_obj_t mod_uzlib_decompress(size_t n_args, const mp_obj_t *args) {
         if (st == TINF_DONE) {
             break;
         }
+        if (into) {
+            // uzlib stops when the buffer is full, before it reads the end of
+            // the stream, so go over the last byte again to see if that's all
+            if (dest_buf_size > 0) {
+                byte last = dest_buf[dest_buf_size - 1];
+                decomp->dest--;
+                st = uzlib_uncompress_chksum(decomp);
+                if (st < 0) {
+                    goto error;
+                }
+                if (st == TINF_DONE && decomp->dest == dest_buf + dest_buf_size - 1) {
+                    decomp->dest++;
+                    break;
+                }
+                dest_buf[dest_buf_size - 1] = last;
+            }
+            m_del_obj(TINF_DATA, decomp);
+            mp_raise_ValueError(translate("buffer too small"));
+        }
         size_t offset = decomp->dest - dest_buf;
-        dest_buf = m_renew(byte, dest_buf, dest_buf_size, dest_buf_size + 256);
-        dest_buf_size += 256;
+        size_t grow = MAX(dest_buf_size / 2, 256);
+        byte *new_buf = m_renew_maybe(byte, dest_buf, dest_buf_size, dest_buf_size + grow, true);
+        if (new_buf == NULL) {
+            // short of memory, so grow only by as much as it used to
+            grow = 256;
+            new_buf = m_renew(byte, dest_buf, dest_buf_size, dest_buf_size + grow);
+        }
+        dest_buf = new_buf;
+        dest_buf_size += grow;
         decomp->dest = dest_buf + offset;
-        decomp->dest_limit = dest_buf + offset + 256;
+        decomp->dest_limit = dest_buf + dest_buf_size;
     }
 
     mp_uint_t final_sz = decomp->dest - dest_buf;
+    if (into) {
+        m_del_obj(TINF_DATA, decomp);
+        return MP_OBJ_NEW_SMALL_INT(final_sz);
+    }
     DEBUG_printf("uzlib: Resizing from " UINT_FMT " to final size: " UINT_FMT " bytes\n", dest_buf_size, final_sz);
     dest_buf = (byte*)m_renew(byte, dest_buf, dest_buf_size, final_sz);
     mp_obj_t res = mp_obj_new_bytearray_by_ref(final_sz, dest_buf);
@@ -203,10 +267,347 @@ error:
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_uzlib_decompress_obj, 1, 3, mod_uzlib_decompress);
 
+#if MICROPY_PY_UZLIB_COMPRESS
+// CompIO is a write-only stream that deflates what is written to it into
+// another stream.  It keeps a window of 2**wbits bytes for back-references,
+// followed by what has been written but not yet compressed, and a hash table
+// of the last position each 3 bytes were seen at, with no chains.  Everything
+// is coded with the fixed Huffman codes, so no block has to be held back to
+// work out its own codes, and output goes out through a small buffer.
+
+#define COMP_MIN_MATCH (3)
+#define COMP_MAX_MATCH (258)
+
+enum { COMP_RAW, COMP_ZLIB, COMP_GZIP };
+
+typedef struct _mp_obj_compio_t {
+    mp_obj_base_t base;
+    mp_obj_t dest_stream;
+    byte *hist;
+    size_t hist_size;
+    size_t hist_len;
+    // the first byte in hist not yet compressed, and the offset in the
+    // uncompressed data of hist[0]
+    size_t pos;
+    uint32_t hist_offset;
+    uint32_t *hash;
+    byte hash_bits;
+    byte window_bits;
+    byte format;
+    bool closed;
+    uint32_t checksum;
+    uint32_t bits;
+    byte n_bits;
+    byte out_len;
+    byte out[MICROPY_PY_UZLIB_COMPRESS_BUF_SIZE];
+} mp_obj_compio_t;
+
+STATIC const uint16_t comp_length_base[] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+};
+STATIC const byte comp_length_extra[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+STATIC const uint16_t comp_dist_base[] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+};
+STATIC const byte comp_dist_extra[] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+
+STATIC void compio_write_out(mp_obj_compio_t *self) {
+    mp_stream_write(self->dest_stream, self->out, self->out_len, MP_STREAM_RW_WRITE);
+    self->out_len = 0;
+}
+
+STATIC void compio_put_byte(mp_obj_compio_t *self, byte b) {
+    self->out[self->out_len++] = b;
+    if (self->out_len == sizeof(self->out)) {
+        compio_write_out(self);
+    }
+}
+
+// Bits go out least significant first, at most 16 at a time.
+STATIC void compio_put_bits(mp_obj_compio_t *self, uint32_t value, int n) {
+    self->bits |= value << self->n_bits;
+    self->n_bits += n;
+    while (self->n_bits >= 8) {
+        compio_put_byte(self, self->bits);
+        self->bits >>= 8;
+        self->n_bits -= 8;
+    }
+}
+
+STATIC void compio_align(mp_obj_compio_t *self) {
+    if (self->n_bits > 0) {
+        compio_put_bits(self, 0, 8 - self->n_bits);
+    }
+}
+
+// Huffman codes go out most significant bit first.
+STATIC void compio_put_code(mp_obj_compio_t *self, uint32_t code, int n) {
+    uint32_t rev = 0;
+    for (int i = 0; i < n; i++) {
+        rev = (rev << 1) | (code & 1);
+        code >>= 1;
+    }
+    compio_put_bits(self, rev, n);
+}
+
+STATIC void compio_put_symbol(mp_obj_compio_t *self, unsigned sym) {
+    if (sym < 144) {
+        compio_put_code(self, 0x30 + sym, 8);
+    } else if (sym < 256) {
+        compio_put_code(self, 0x190 + sym - 144, 9);
+    } else if (sym < 280) {
+        compio_put_code(self, sym - 256, 7);
+    } else {
+        compio_put_code(self, 0xc0 + sym - 280, 8);
+    }
+}
+
+STATIC void compio_put_match(mp_obj_compio_t *self, size_t len, size_t dist) {
+    int i = MP_ARRAY_SIZE(comp_length_base) - 1;
+    while (comp_length_base[i] > len) {
+        i--;
+    }
+    compio_put_symbol(self, 257 + i);
+    compio_put_bits(self, len - comp_length_base[i], comp_length_extra[i]);
+    i = MP_ARRAY_SIZE(comp_dist_base) - 1;
+    while (comp_dist_base[i] > dist) {
+        i--;
+    }
+    compio_put_code(self, i, 5);
+    compio_put_bits(self, dist - comp_dist_base[i], comp_dist_extra[i]);
+}
+
+STATIC void compio_start_block(mp_obj_compio_t *self, bool final) {
+    compio_put_bits(self, final, 1);
+    compio_put_bits(self, 1, 2); // fixed Huffman codes
+}
+
+STATIC inline size_t compio_hash(mp_obj_compio_t *self, const byte *p) {
+    uint32_t v = p[0] | p[1] << 8 | p[2] << 16;
+    return (v * 2654435761u) >> (32 - self->hash_bits);
+}
+
+// Code the bytes from pos on, all of them if flush is set, else those that
+// have the longest possible match's worth of bytes after them.
+STATIC void compio_compress(mp_obj_compio_t *self, bool flush) {
+    byte *hist = self->hist;
+    size_t end = self->hist_len;
+    size_t limit = flush ? end : end > COMP_MAX_MATCH ? end - COMP_MAX_MATCH : 0;
+    size_t window = (size_t)1 << self->window_bits;
+    size_t pos = self->pos;
+    while (pos < limit) {
+        size_t len = 0;
+        uint32_t dist = 0;
+        if (end - pos >= COMP_MIN_MATCH) {
+            size_t h = compio_hash(self, hist + pos);
+            uint32_t offset = self->hist_offset + pos;
+            // whatever the table holds, the bytes are compared before use
+            dist = offset - self->hash[h];
+            self->hash[h] = offset;
+            if (dist >= 1 && dist <= window && dist <= pos) {
+                const byte *a = hist + pos;
+                const byte *b = a - dist;
+                size_t max = MIN(COMP_MAX_MATCH, end - pos);
+                while (len < max && a[len] == b[len]) {
+                    len++;
+                }
+            }
+        }
+        if (len >= COMP_MIN_MATCH) {
+            compio_put_match(self, len, dist);
+            for (size_t i = 1; i < len && pos + i + COMP_MIN_MATCH <= end; i++) {
+                self->hash[compio_hash(self, hist + pos + i)] = self->hist_offset + pos + i;
+            }
+            pos += len;
+        } else {
+            compio_put_symbol(self, hist[pos]);
+            pos += 1;
+        }
+    }
+    self->pos = pos;
+}
+
+STATIC mp_obj_t compio_make_new(const mp_obj_type_t *type, size_t n_args, const mp_obj_t *args, mp_map_t *kw_args) {
+    mp_arg_check_num(n_args, kw_args, 1, 2, false);
+    mp_get_stream_raise(args[0], MP_STREAM_OP_WRITE);
+    mp_int_t wbits = n_args > 1 ? mp_obj_get_int(args[1]) : 0;
+    byte format = COMP_ZLIB;
+    if (wbits == 0) {
+        wbits = MICROPY_PY_UZLIB_COMPRESS_WBITS;
+    } else if (wbits >= 16) {
+        format = COMP_GZIP;
+        wbits -= 16;
+    } else if (wbits < 0) {
+        format = COMP_RAW;
+        wbits = -wbits;
+    }
+    if (wbits < 8 || wbits > 15) {
+        mp_raise_ValueError(NULL);
+    }
+
+    mp_obj_compio_t *o = m_new_obj(mp_obj_compio_t);
+    o->base.type = type;
+    o->dest_stream = args[0];
+    o->window_bits = wbits;
+    o->hist_size = 2 * ((size_t)1 << wbits) + COMP_MAX_MATCH;
+    o->hist = m_new(byte, o->hist_size);
+    o->hist_len = 0;
+    o->pos = 0;
+    o->hist_offset = 0;
+    // one entry for every 4 bytes of the window
+    o->hash_bits = wbits - 2;
+    o->hash = m_new0(uint32_t, (size_t)1 << o->hash_bits);
+    o->format = format;
+    o->closed = false;
+    o->bits = 0;
+    o->n_bits = 0;
+    o->out_len = 0;
+
+    if (format == COMP_ZLIB) {
+        byte cmf = (wbits - 8) << 4 | 8;
+        compio_put_byte(o, cmf);
+        compio_put_byte(o, 31 - (cmf << 8) % 31);
+        o->checksum = 1;
+    } else if (format == COMP_GZIP) {
+        static const byte gzip_header[] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+        for (size_t i = 0; i < sizeof(gzip_header); i++) {
+            compio_put_byte(o, gzip_header[i]);
+        }
+        o->checksum = 0xffffffff;
+    }
+    compio_start_block(o, false);
+    return MP_OBJ_FROM_PTR(o);
+}
+
+STATIC mp_uint_t compio_write(mp_obj_t self_in, const void *buf_in, mp_uint_t size, int *errcode) {
+    mp_obj_compio_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->closed) {
+        *errcode = MP_EINVAL;
+        return MP_STREAM_ERROR;
+    }
+    const byte *buf = buf_in;
+    if (self->format == COMP_ZLIB) {
+        self->checksum = uzlib_adler32(buf, size, self->checksum);
+    } else if (self->format == COMP_GZIP) {
+        self->checksum = uzlib_crc32(buf, size, self->checksum);
+    }
+    for (mp_uint_t left = size; left > 0;) {
+        if (self->hist_len == self->hist_size) {
+            compio_compress(self, false);
+            // keep a window's worth of bytes before pos, which is now beyond it
+            size_t shift = self->pos - ((size_t)1 << self->window_bits);
+            memmove(self->hist, self->hist + shift, self->hist_len - shift);
+            self->hist_len -= shift;
+            self->pos -= shift;
+            self->hist_offset += shift;
+        }
+        size_t n = MIN(left, self->hist_size - self->hist_len);
+        memcpy(self->hist + self->hist_len, buf, n);
+        self->hist_len += n;
+        buf += n;
+        left -= n;
+    }
+    return size;
+}
+
+STATIC mp_uint_t compio_ioctl(mp_obj_t self_in, mp_uint_t request, uintptr_t arg, int *errcode) {
+    (void)arg;
+    mp_obj_compio_t *self = MP_OBJ_TO_PTR(self_in);
+    if (request == MP_STREAM_FLUSH) {
+        if (!self->closed) {
+            // end the block and follow it with an empty stored block, so a
+            // reader can decompress everything written so far
+            compio_compress(self, true);
+            compio_put_symbol(self, 256);
+            compio_put_bits(self, 0, 3);
+            compio_align(self);
+            compio_put_bits(self, 0, 16);
+            compio_put_bits(self, 0xffff, 16);
+            compio_start_block(self, false);
+            compio_write_out(self);
+        }
+        return 0;
+    } else if (request == MP_STREAM_CLOSE) {
+        if (!self->closed) {
+            compio_compress(self, true);
+            compio_put_symbol(self, 256);
+            // an empty last block, as the one open wasn't marked as the last
+            compio_start_block(self, true);
+            compio_put_symbol(self, 256);
+            compio_align(self);
+            uint32_t checksum = self->checksum;
+            if (self->format == COMP_ZLIB) {
+                for (int i = 24; i >= 0; i -= 8) {
+                    compio_put_byte(self, checksum >> i);
+                }
+            } else if (self->format == COMP_GZIP) {
+                checksum = ~checksum;
+                uint32_t isize = self->hist_offset + self->hist_len;
+                for (int i = 0; i < 32; i += 8) {
+                    compio_put_byte(self, checksum >> i);
+                }
+                for (int i = 0; i < 32; i += 8) {
+                    compio_put_byte(self, isize >> i);
+                }
+            }
+            compio_write_out(self);
+            self->closed = true;
+            m_del(byte, self->hist, self->hist_size);
+            m_del(uint32_t, self->hash, (size_t)1 << self->hash_bits);
+            self->hist = NULL;
+            self->hash = NULL;
+        }
+        return 0;
+    }
+    *errcode = MP_EINVAL;
+    return MP_STREAM_ERROR;
+}
+
+STATIC mp_obj_t compio___exit__(size_t n_args, const mp_obj_t *args) {
+    (void)n_args;
+    return mp_stream_close(args[0]);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(compio___exit___obj, 4, 4, compio___exit__);
+
+STATIC const mp_rom_map_elem_t compio_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&mp_stream_write_obj) },
+    { MP_ROM_QSTR(MP_QSTR_flush), MP_ROM_PTR(&mp_stream_flush_obj) },
+    { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&mp_stream_close_obj) },
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&mp_identity_obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&compio___exit___obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(compio_locals_dict, compio_locals_dict_table);
+
+STATIC const mp_stream_p_t compio_stream_p = {
+    .write = compio_write,
+    .ioctl = compio_ioctl,
+};
+
+STATIC const mp_obj_type_t compio_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_CompIO,
+    .make_new = compio_make_new,
+    .protocol = &compio_stream_p,
+    .locals_dict = (void*)&compio_locals_dict,
+};
+#endif
+
 STATIC const mp_rom_map_elem_t mp_module_uzlib_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_uzlib) },
     { MP_ROM_QSTR(MP_QSTR_decompress), MP_ROM_PTR(&mod_uzlib_decompress_obj) },
     { MP_ROM_QSTR(MP_QSTR_DecompIO), MP_ROM_PTR(&decompio_type) },
+    #if MICROPY_PY_UZLIB_COMPRESS
+    { MP_ROM_QSTR(MP_QSTR_CompIO), MP_ROM_PTR(&compio_type) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_uzlib_globals, mp_module_uzlib_globals_table);
@@ -31,3 +31,24 @@ int _re1_5_namedclassmatch(const char *pc, const char *sp)
     }
     return off;
 }
+
+// Find where the n literal characters of the Char instructions at pc next occur
+// in full, at or after sp and before end.
+const char *_re1_5_findprefix(const char *pc, int n, const char *sp, const char *end)
+{
+    while (end - sp >= n) {
+        sp = memchr(sp, pc[1], end - sp - n + 1);
+        if (sp == NULL) {
+            return NULL;
+        }
+        int i = 1;
+        while (i < n && sp[i] == pc[2 * i + 1]) {
+            i++;
+        }
+        if (i == n) {
+            return sp;
+        }
+        sp++;
+    }
+    return NULL;
+}
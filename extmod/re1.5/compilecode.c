@@ -7,6 +7,12 @@
 #define INSERT_CODE(at, num, pc) \
     ((code ? memmove(code + at + num, code + at, pc - at) : 0), pc += num)
 #define REL(at, to) (to - at - 2)
+// Jump offsets are stored in a signed byte, so longer jumps can't be compiled
+#define EMIT_REL(at, rel) do { \
+        int _rel = (rel); \
+        if (_rel < -128 || _rel > 127) return NULL; \
+        EMIT(at, _rel); \
+    } while (0)
 #define EMIT(at, byte) (code ? (code[at] = byte) : (at))
 #define PC (prog->bytelen)
 
@@ -133,7 +139,7 @@ static const char *_compilecode(const char *re, ByteProg *prog, int sizecode)
             } else {
                 EMIT(term, Split);
             }
-            EMIT(term + 1, REL(term, PC));
+            EMIT_REL(term + 1, REL(term, PC));
             prog->len++;
             term = PC;
             break;
@@ -141,7 +147,7 @@ static const char *_compilecode(const char *re, ByteProg *prog, int sizecode)
             if (PC == term) return NULL; // nothing to repeat
             INSERT_CODE(term, 2, PC);
             EMIT(PC, Jmp);
-            EMIT(PC + 1, REL(PC, term));
+            EMIT_REL(PC + 1, REL(PC, term));
             PC += 2;
             if (re[1] == '?') {
                 EMIT(term, RSplit);
@@ -149,7 +155,7 @@ static const char *_compilecode(const char *re, ByteProg *prog, int sizecode)
             } else {
                 EMIT(term, Split);
             }
-            EMIT(term + 1, REL(term, PC));
+            EMIT_REL(term + 1, REL(term, PC));
             prog->len += 2;
             term = PC;
             break;
@@ -161,20 +167,20 @@ static const char *_compilecode(const char *re, ByteProg *prog, int sizecode)
             } else {
                 EMIT(PC, RSplit);
             }
-            EMIT(PC + 1, REL(PC, term));
+            EMIT_REL(PC + 1, REL(PC, term));
             PC += 2;
             prog->len++;
             term = PC;
             break;
         case '|':
             if (alt_label) {
-                EMIT(alt_label, REL(alt_label, PC) + 1);
+                EMIT_REL(alt_label, REL(alt_label, PC) + 1);
             }
             INSERT_CODE(start, 2, PC);
             EMIT(PC++, Jmp);
             alt_label = PC++;
             EMIT(start, Split);
-            EMIT(start + 1, REL(start, PC));
+            EMIT_REL(start + 1, REL(start, PC));
             prog->len += 2;
             term = PC;
             break;
@@ -192,7 +198,7 @@ static const char *_compilecode(const char *re, ByteProg *prog, int sizecode)
     }
 
     if (alt_label) {
-        EMIT(alt_label, REL(alt_label, PC) + 1);
+        EMIT_REL(alt_label, REL(alt_label, PC) + 1);
     }
     return re;
 }
@@ -242,6 +248,51 @@ int re1_5_compilecode(ByteProg *prog, const char *re)
     return 0;
 }
 
+// Length of the literal that every match starts with.  pc is set to its first
+// Char instruction, and the rest follow two bytes apart.
+int re1_5_literalprefix(ByteProg *prog, const char **pc)
+{
+    const char *code = prog->insts + NON_ANCHORED_PREFIX;
+    int n = 0;
+    while (*code == Save) {
+        code += 2;
+    }
+    *pc = code;
+    while (code[2 * n] == Char) {
+        n++;
+    }
+    return n;
+}
+
+// Whether the program has alternatives to try, other than the loop in front
+// of it that implements search.
+int re1_5_canbranch(ByteProg *prog)
+{
+    int pc = NON_ANCHORED_PREFIX;
+    const char *code = prog->insts;
+    while (pc < prog->bytelen) {
+        switch (code[pc]) {
+        case Split:
+        case RSplit:
+            return 1;
+        case Class:
+        case ClassNot:
+            pc += 2 + (unsigned char)code[pc + 1] * 2;
+            break;
+        case Char:
+        case NamedClass:
+        case Jmp:
+        case Save:
+            pc += 2;
+            break;
+        default:
+            pc++;
+            break;
+        }
+    }
+    return 0;
+}
+
 #if 0
 int main(int argc, char *argv[])
 {
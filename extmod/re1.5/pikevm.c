@@ -0,0 +1,183 @@
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "re1.5.h"
+
+// Pike VM: all threads step through the input together, one byte at a time,
+// so the time taken is linear in the length of the subject.  Threads are kept
+// in priority order, and one that reaches a pc already reached at the same
+// position by a higher priority thread is dropped, which gives the same match
+// as the backtracking matchers.  A list holds at most one thread per
+// instruction, so the memory needed is known from the program alone.
+
+typedef struct Pike Pike;
+
+struct Pike
+{
+	ByteProg *prog;
+	Subject *input;
+	int nsubp;
+	unsigned step;
+	unsigned *mark;
+};
+
+typedef struct ThreadList ThreadList;
+
+struct ThreadList
+{
+	int n;
+	const char **t;	// pc followed by nsubp capture pointers, per thread
+};
+
+int
+re1_5_pikevm_memsize(ByteProg *prog, int nsubp)
+{
+	return 2 * prog->len * (nsubp + 1) * sizeof(char*) + prog->bytelen * sizeof(unsigned);
+}
+
+static void
+addthread(Pike *vm, ThreadList *l, const char *pc, const char *sp, const char **sub)
+{
+	const char *old;
+	const char **t;
+	int off;
+
+	re1_5_stack_chk();
+
+	for(;;) {
+		unsigned *mark = &vm->mark[pc - vm->prog->insts];
+		if(*mark == vm->step)
+			return;
+		*mark = vm->step;
+		switch(*pc) {
+		case Jmp:
+			off = (signed char)pc[1];
+			pc = pc + 2 + off;
+			continue;
+		case Split:
+			off = (signed char)pc[1];
+			addthread(vm, l, pc + 2, sp, sub);
+			pc = pc + 2 + off;
+			continue;
+		case RSplit:
+			off = (signed char)pc[1];
+			addthread(vm, l, pc + 2 + off, sp, sub);
+			pc += 2;
+			continue;
+		case Save:
+			off = (unsigned char)pc[1];
+			if(off >= vm->nsubp) {
+				pc += 2;
+				continue;
+			}
+			old = sub[off];
+			sub[off] = sp;
+			addthread(vm, l, pc + 2, sp, sub);
+			sub[off] = old;
+			return;
+		case Bol:
+			if(sp != vm->input->begin)
+				return;
+			pc++;
+			continue;
+		case Eol:
+			if(sp != vm->input->end)
+				return;
+			pc++;
+			continue;
+		}
+		// a consumer or Match, which waits in the list for the next byte
+		t = l->t + l->n++ * (vm->nsubp + 1);
+		t[0] = pc;
+		memcpy((char*)(t + 1), sub, vm->nsubp * sizeof(char*));
+		return;
+	}
+}
+
+// subp must be all nil on entry.  mem holds re1_5_pikevm_memsize() bytes.
+int
+re1_5_pikevm(ByteProg *prog, Subject *input, const char **subp, int nsubp, int is_anchored, char *mem)
+{
+	Pike vm;
+	ThreadList clist, nlist, tmp;
+	const char *start = prog->insts + NON_ANCHORED_PREFIX;
+	const char *prefix = nil;
+	const char *sp, *pc;
+	const char **t;
+	int i, nprefix, stride, matched;
+
+	stride = nsubp + 1;
+	vm.prog = prog;
+	vm.input = input;
+	vm.nsubp = nsubp;
+	vm.step = 1;
+	clist.t = (const char**)mem;
+	nlist.t = clist.t + prog->len * stride;
+	vm.mark = (unsigned*)(nlist.t + prog->len * stride);
+	memset(vm.mark, 0, prog->bytelen * sizeof(unsigned));
+
+	// A search starts a new thread at each position, behind those already
+	// running, for as long as nothing has matched.  This takes the place of
+	// the loop in front of the program, and can skip ahead to where the
+	// literal the pattern starts with is found.
+	nprefix = is_anchored ? 0 : re1_5_literalprefix(prog, &prefix);
+	matched = 0;
+	clist.n = 0;
+	for(sp = input->begin;; sp++) {
+		if(!matched && (!is_anchored || sp == input->begin)) {
+			if(nprefix > 0 && clist.n == 0) {
+				pc = _re1_5_findprefix(prefix, nprefix, sp, input->end);
+				if(pc == nil)
+					break;
+				if(pc != sp) {
+					sp = pc;
+					vm.step++;
+				}
+			}
+			if(nprefix == 0 || (sp < input->end && *sp == prefix[1]))
+				addthread(&vm, &clist, start, sp, subp);
+		}
+		if(clist.n == 0)
+			break;
+		vm.step++;
+		nlist.n = 0;
+		for(i = 0; i < clist.n; i++) {
+			t = clist.t + i * stride;
+			pc = t[0];
+			if(*pc == Match) {
+				memcpy((char*)subp, t + 1, nsubp * sizeof(char*));
+				matched = 1;
+				// threads after this one have lower priority
+				break;
+			}
+			if(sp >= input->end)
+				continue;
+			switch(*pc) {
+			case Char:
+				if(*sp == pc[1])
+					addthread(&vm, &nlist, pc + 2, sp + 1, t + 1);
+				break;
+			case Any:
+				addthread(&vm, &nlist, pc + 1, sp + 1, t + 1);
+				break;
+			case Class:
+			case ClassNot:
+				if(_re1_5_classmatch(pc + 1, sp))
+					addthread(&vm, &nlist, pc + 2 + *(unsigned char*)(pc + 1) * 2, sp + 1, t + 1);
+				break;
+			case NamedClass:
+				if(_re1_5_namedclassmatch(pc + 1, sp))
+					addthread(&vm, &nlist, pc + 2, sp + 1, t + 1);
+				break;
+			default:
+				re1_5_fatal("pikevm");
+			}
+		}
+		if(sp >= input->end)
+			break;
+		tmp = clist;
+		clist = nlist;
+		nlist = tmp;
+	}
+	return matched;
+}
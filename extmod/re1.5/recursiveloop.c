@@ -82,5 +82,19 @@ recursiveloop(char *pc, const char *sp, Subject *input, const char **subp, int n
 int
 re1_5_recursiveloopprog(ByteProg *prog, Subject *input, const char **subp, int nsubp, int is_anchored)
 {
+	const char *prefix;
+	const char *sp;
+	int n;
+
+	// A search only has to be tried where the literal the pattern starts
+	// with is found, in the same order as the loop in front of the program
+	// would try them.
+	if(!is_anchored && (n = re1_5_literalprefix(prog, &prefix)) > 0) {
+		for(sp = input->begin; (sp = _re1_5_findprefix(prefix, n, sp, input->end)) != nil; sp++) {
+			if(recursiveloop(prog->insts + NON_ANCHORED_PREFIX, sp, input, subp, nsubp))
+				return 1;
+		}
+		return 0;
+	}
 	return recursiveloop(HANDLE_ANCHORED(prog->insts, is_anchored), input->begin, input, subp, nsubp);
 }
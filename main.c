@@ -89,7 +89,38 @@ void do_str(const char *src, mp_parse_input_kind_t input_kind) {
     }
 }
 
-void start_mp(supervisor_allocation* heap) {
+#if MICROPY_GC_SNAPSHOT
+#include "py/gc_long_lived.h"
+
+STATIC bool heap_snapshot_read(void *data, void *buf, size_t len) {
+    UINT n;
+    return f_read((FIL*)data, buf, len, &n) == FR_OK && n == len;
+}
+
+// Start from the heap that micropython.heap_snapshot() wrote to
+// CIRCUITPY_HEAP_SNAPSHOT_FILE, if there is one, instead of importing the
+// modules again. Has to be done before anything else is allocated.
+STATIC void load_heap_snapshot(void) {
+    FATFS *fs = &((fs_user_mount_t *) MP_STATE_VM(vfs_mount_table)->obj)->fatfs;
+    FIL file;
+    if (f_open(fs, &file, CIRCUITPY_HEAP_SNAPSHOT_FILE, FA_READ) != FR_OK) {
+        return;
+    }
+    gc_snapshot_reader_t reader = { &file, heap_snapshot_read };
+    gc_snapshot_result_t res = gc_snapshot_load(&reader, f_size(&file));
+    f_close(&file);
+    if (res == GC_SNAPSHOT_READ_FAILED) {
+        // The heap was partly overwritten so start again from an empty one.
+        mp_deinit();
+        mp_init();
+    }
+    if (res != GC_SNAPSHOT_LOADED) {
+        serial_write_compressed(translate("Heap snapshot not usable, starting cold\n"));
+    }
+}
+#endif
+
+void start_mp(supervisor_allocation* heap, bool load_snapshot) {
     reset_status_led();
     autoreload_stop();
 
@@ -117,6 +148,13 @@ void start_mp(supervisor_allocation* heap) {
     gc_init(heap->ptr, heap->ptr + heap->length / 4);
     #endif
     mp_init();
+    #if MICROPY_GC_SNAPSHOT
+    if (load_snapshot) {
+        load_heap_snapshot();
+    }
+    #else
+    (void) load_snapshot;
+    #endif
     mp_obj_list_init(mp_sys_path, 0);
     mp_obj_list_append(mp_sys_path, MP_OBJ_NEW_QSTR(MP_QSTR_)); // current dir (or base dir of the script)
     mp_obj_list_append(mp_sys_path, MP_OBJ_NEW_QSTR(MP_QSTR__slash_));
@@ -232,7 +270,7 @@ bool run_code_py(safe_mode_t safe_mode) {
         stack_resize();
         filesystem_flush();
         supervisor_allocation* heap = allocate_remaining_memory();
-        start_mp(heap);
+        start_mp(heap, true);
         found_main = maybe_run_list(supported_filenames, &result);
         if (!found_main){
             found_main = maybe_run_list(double_extension_filenames, &result);
@@ -364,7 +402,7 @@ void __attribute__ ((noinline)) run_boot_py(safe_mode_t safe_mode) {
         // TODO(tannewt): Allocate temporary space to hold custom usb descriptors.
         filesystem_flush();
         supervisor_allocation* heap = allocate_remaining_memory();
-        start_mp(heap);
+        start_mp(heap, false);
 
         // TODO(tannewt): Re-add support for flashing boot error output.
         bool found_boot = maybe_run_list(boot_py_filenames, NULL);
@@ -387,7 +425,7 @@ int run_repl(void) {
     stack_resize();
     filesystem_flush();
     supervisor_allocation* heap = allocate_remaining_memory();
-    start_mp(heap);
+    start_mp(heap, true);
     autoreload_suspend();
     new_status_color(REPL_RUNNING);
     if (pyexec_mode_kind == PYEXEC_MODE_RAW_REPL) {
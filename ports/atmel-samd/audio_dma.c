@@ -339,14 +339,15 @@ void audio_dma_background(void) {
         }
 
         bool block_done = event_interrupt_active(dma->event_channel);
-        if (!block_done) {
-            continue;
-        }
 
         // audio_dma_load_next_block() can call Python code, which can call audio_dma_background()
         // recursively at the next background processing time. So disallow recursive calls to here.
         audio_dma_pending[i] = true;
-        audio_dma_load_next_block(dma);
+        if (block_done) {
+            audio_dma_load_next_block(dma);
+        }
+        // Read ahead while the current blocks play so the next one is ready when it's needed.
+        audiosample_prefetch(dma->sample);
         audio_dma_pending[i] = false;
     }
 }
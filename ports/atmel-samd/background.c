@@ -30,6 +30,7 @@
 #include "supervisor/filesystem.h"
 #include "supervisor/usb.h"
 
+#include "py/gc.h"
 #include "py/runtime.h"
 #include "shared-module/network/__init__.h"
 #include "supervisor/shared/stack.h"
@@ -68,6 +69,9 @@ void run_background_tasks(void) {
     #endif
     filesystem_background();
     usb_background();
+    #if MICROPY_GC_INCREMENTAL
+    gc_sweep_step();
+    #endif
     running_background_tasks = false;
     assert_heap_ok();
 
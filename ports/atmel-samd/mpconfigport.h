@@ -68,6 +68,8 @@
 #define MICROPY_PY_IO                               (1)
 #define MICROPY_PY_UJSON                            (1)
 #define MICROPY_PY_REVERSE_SPECIAL_METHODS          (1)
+#define MICROPY_GC_SNAPSHOT                         (1)
+#define MICROPY_PY_URE_PIKEVM                       (1)
 //      MICROPY_PY_UERRNO_LIST - Use the default
 #endif
 
@@ -37,6 +37,7 @@ void tick_init(void);
 void tick_delay(uint32_t us);
 
 void current_tick(uint64_t* ms, uint32_t* us_until_ms);
+uint32_t ticks_us(void);
 // Do not call this with interrupts disabled because it may be waiting for
 // ticks_ms to increment.
 void wait_until(uint64_t ms, uint32_t us_until_ms);
@@ -24,6 +24,7 @@
  * THE SOFTWARE.
  */
 
+#include "py/gc.h"
 #include "py/runtime.h"
 #include "supervisor/filesystem.h"
 #include "supervisor/usb.h"
@@ -58,6 +59,9 @@ void run_background_tasks(void) {
     #if CIRCUITPY_DISPLAYIO
     displayio_background();
     #endif
+    #if MICROPY_GC_INCREMENTAL
+    gc_sweep_step();
+    #endif
     running_background_tasks = false;
 
     assert_heap_ok();
@@ -142,6 +142,8 @@ STATIC void audiopwmout_background_obj(audiopwmio_pwmaudioout_obj_t *self) {
     } else if(!self->paused && !self->single_buffer) {
         if(self->pwm->EVENTS_SEQSTARTED[0]) fill_buffers(self, 1);
         if(self->pwm->EVENTS_SEQSTARTED[1]) fill_buffers(self, 0);
+        // Read ahead while the current sequences play.
+        audiosample_prefetch(self->sample);
     }
 }
 
@@ -78,6 +78,14 @@ void current_tick(uint64_t* ms, uint32_t* us_until_ms) {
     *us_until_ms = SysTick->VAL / ticks_per_us;
 }
 
+// Microseconds since startup, wrapping every 71 minutes.
+uint32_t ticks_us(void) {
+    uint64_t ms;
+    uint32_t us_until_ms;
+    current_tick(&ms, &us_until_ms);
+    return ms * 1000 + (1000 - us_until_ms);
+}
+
 void wait_until(uint64_t ms, uint32_t us_until_ms) {
     uint32_t ticks_per_us = common_hal_mcu_processor_get_frequency() / 1000 / 1000;
     while(ticks_ms <= ms && SysTick->VAL / ticks_per_us >= us_until_ms) {}
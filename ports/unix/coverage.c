@@ -379,14 +379,26 @@ STATIC mp_obj_t extra_coverage(void) {
         // call mp_execute_bytecode with invalide bytecode (should raise NotImplementedError)
         mp_obj_fun_bc_t fun_bc;
         fun_bc.bytecode = (const byte*)"\x01"; // just needed for n_state
+        #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+        fun_bc.qstr_link = NULL;
+        #endif
         mp_code_state_t *code_state = m_new_obj_var(mp_code_state_t, mp_obj_t, 1);
         code_state->fun_bc = &fun_bc;
-        code_state->ip = (const byte*)"\x00"; // just needed for an invalid opcode
+        code_state->ip = (const byte*)"\x6f"; // just needed for an invalid opcode
         code_state->sp = &code_state->state[0];
         code_state->exc_sp = NULL;
         code_state->old_globals = NULL;
         mp_vm_return_kind_t ret = mp_execute_bytecode(code_state, MP_OBJ_NULL);
         mp_printf(&mp_plat_print, "%d %d\n", ret, mp_obj_get_type(code_state->state[0]) == &mp_type_NotImplementedError);
+
+        #if MICROPY_OPT_QUICKEN_BYTECODE
+        // a quickened opcode in bytecode outside the heap, which is never quickened
+        code_state->ip = (const byte*)"\x0a";
+        code_state->sp = &code_state->state[0];
+        code_state->exc_sp = NULL;
+        ret = mp_execute_bytecode(code_state, MP_OBJ_NULL);
+        mp_printf(&mp_plat_print, "%d %d\n", ret, mp_obj_get_type(code_state->state[0]) == &mp_type_NotImplementedError);
+        #endif
     }
 
     // scheduler
@@ -37,4 +37,13 @@ typedef struct _mp_obj_fdfile_t {
 extern const mp_obj_type_t mp_type_fileio;
 extern const mp_obj_type_t mp_type_textio;
 
+#if MICROPY_PY_USELECT_EPOLL
+// Counts the fds closed by file and socket objects, so that uselect.poll
+// knows when to look for them in its epoll sets.
+extern unsigned int mp_unix_fd_close_count;
+#define MP_UNIX_FD_CLOSED() __atomic_add_fetch(&mp_unix_fd_close_count, 1, __ATOMIC_RELAXED)
+#else
+#define MP_UNIX_FD_CLOSED()
+#endif
+
 #endif // MICROPY_INCLUDED_UNIX_FDFILE_H
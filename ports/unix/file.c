@@ -121,6 +121,7 @@ STATIC mp_uint_t fdfile_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg, i
             return 0;
         case MP_STREAM_CLOSE:
             close(o->fd);
+            MP_UNIX_FD_CLOSED();
             #ifdef MICROPY_CPYTHON_COMPAT
             o->fd = -1;
             #endif
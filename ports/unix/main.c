@@ -34,6 +34,7 @@
 #include <ctype.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <signal.h>
 
@@ -43,6 +44,7 @@
 #include "py/builtin.h"
 #include "py/repl.h"
 #include "py/gc.h"
+#include "py/gc_long_lived.h"
 #include "py/stackctrl.h"
 #include "py/mphal.h"
 #include "py/mpthread.h"
@@ -55,6 +57,9 @@
 // Command line options, with their defaults
 STATIC bool compile_only = false;
 STATIC uint emit_opt = MP_EMIT_OPT_NONE;
+#if MICROPY_GC_SNAPSHOT
+STATIC const char *snapshot_file = NULL;
+#endif
 
 #if MICROPY_ENABLE_GC
 // Heap size of GC heap (if enabled)
@@ -322,6 +327,12 @@ STATIC int usage(char **argv) {
 , heap_size);
     impl_opts_cnt++;
 #endif
+#if MICROPY_GC_SNAPSHOT
+    printf(
+"  snapshot=<file> -- start from a heap saved by micropython.heap_snapshot()\n"
+);
+    impl_opts_cnt++;
+#endif
 
     if (impl_opts_cnt == 0) {
         printf("  (none)\n");
@@ -330,6 +341,44 @@ STATIC int usage(char **argv) {
     return 1;
 }
 
+#if MICROPY_GC_SNAPSHOT
+STATIC bool snapshot_read(void *data, void *buf, size_t len) {
+    int fd = *(int*)data;
+    while (len > 0) {
+        ssize_t n = read(fd, buf, len);
+        if (n <= 0) {
+            return false;
+        }
+        buf = (byte*)buf + n;
+        len -= n;
+    }
+    return true;
+}
+
+// Restore the heap saved by micropython.heap_snapshot(), which has to be done
+// before anything else is allocated.  A missing file just means a cold start.
+STATIC void load_snapshot(const char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    gc_snapshot_result_t res = GC_SNAPSHOT_REJECTED;
+    if (fstat(fd, &st) == 0) {
+        gc_snapshot_reader_t reader = { &fd, snapshot_read };
+        res = gc_snapshot_load(&reader, st.st_size);
+    }
+    close(fd);
+    if (res == GC_SNAPSHOT_READ_FAILED) {
+        mp_deinit();
+        mp_init();
+    }
+    if (res != GC_SNAPSHOT_LOADED) {
+        fprintf(stderr, "%s: heap snapshot not usable, starting cold\n", filename);
+    }
+}
+#endif
+
 // Process options which set interpreter init options
 STATIC void pre_process_options(int argc, char **argv) {
     for (int a = 1; a < argc; a++) {
@@ -380,6 +429,10 @@ STATIC void pre_process_options(int argc, char **argv) {
                     if (heap_size < 700) {
                         goto invalid_arg;
                     }
+#endif
+#if MICROPY_GC_SNAPSHOT
+                } else if (strncmp(argv[a + 1], "snapshot=", sizeof("snapshot=") - 1) == 0) {
+                    snapshot_file = argv[a + 1] + sizeof("snapshot=") - 1;
 #endif
                 } else {
 invalid_arg:
@@ -450,6 +503,12 @@ MP_NOINLINE int main_(int argc, char **argv) {
 
     mp_init();
 
+    #if MICROPY_GC_SNAPSHOT
+    if (snapshot_file != NULL) {
+        load_snapshot(snapshot_file);
+    }
+    #endif
+
     #if MICROPY_VFS_POSIX
     {
         // Mount the host FS at the root of our internal VFS
@@ -32,6 +32,11 @@
 #include <stdio.h>
 #include <errno.h>
 #include <poll.h>
+#include <unistd.h>
+#if MICROPY_PY_USELECT_EPOLL
+#include <fcntl.h>
+#include <sys/epoll.h>
+#endif
 
 #include "py/runtime.h"
 #include "py/obj.h"
@@ -57,11 +62,24 @@ typedef struct _mp_obj_poll_t {
     unsigned short len;
     struct pollfd *entries;
     mp_obj_t *obj_map;
+    // indices of the entries found ready by the last poll, in order
+    unsigned short *ready;
     short iter_cnt;
     short iter_idx;
     int flags;
     // callee-owned tuple
     mp_obj_t ret_tuple;
+    #if MICROPY_PY_USELECT_EPOLL
+    // The kernel keeps the set of entries and reports only the ready ones, so
+    // a poll costs little more however many are registered.  -1 if there is
+    // no epoll set, or if it refused an fd (a regular file) and poll(2) is used.
+    int epfd;
+    struct epoll_event *events;
+    // number of entries with a closed fd, which have revents == POLLNVAL
+    unsigned short n_nval;
+    // mp_unix_fd_close_count when the fds were last checked
+    unsigned int fd_close_count;
+    #endif
 } mp_obj_poll_t;
 
 STATIC int get_fd(mp_obj_t fdlike) {
@@ -80,6 +98,70 @@ STATIC int get_fd(mp_obj_t fdlike) {
     return fd;
 }
 
+#if MICROPY_PY_USELECT_EPOLL
+STATIC void poll_epoll_close(mp_obj_poll_t *self) {
+    if (self->epfd >= 0) {
+        close(self->epfd);
+        self->epfd = -1;
+    }
+}
+
+// Bring the epoll set up to date with entry i, or give it up for poll(2).
+STATIC void poll_epoll_ctl(mp_obj_poll_t *self, int op, struct pollfd *entry) {
+    if (self->epfd < 0) {
+        return;
+    }
+    struct epoll_event ev;
+    ev.events = entry->events;
+    ev.data.u32 = entry - self->entries;
+    int res = epoll_ctl(self->epfd, op, entry->fd, &ev);
+    if (res == -1 && errno == ENOENT && op == EPOLL_CTL_MOD) {
+        // the fd was closed and opened again without being unregistered
+        res = epoll_ctl(self->epfd, EPOLL_CTL_ADD, entry->fd, &ev);
+    }
+    if (res == -1 && errno == EBADF && op != EPOLL_CTL_DEL) {
+        // the fd is closed; poll reports it with POLLNVAL, as poll(2) would
+        if (entry->revents != POLLNVAL) {
+            entry->revents = POLLNVAL;
+            self->n_nval++;
+        }
+        return;
+    }
+    if (entry->revents == POLLNVAL) {
+        entry->revents = 0;
+        self->n_nval--;
+    }
+    if (res == -1 && op != EPOLL_CTL_DEL) {
+        poll_epoll_close(self);
+    }
+}
+
+unsigned int mp_unix_fd_close_count;
+
+// The kernel drops a closed fd from the epoll set without telling anyone, so
+// look for registered fds that have been closed, or opened again, since the
+// last poll.  That takes a syscall for each fd, so it's only done before a
+// wait, after file or socket objects have closed an fd, or while an fd is
+// known to be closed.
+STATIC void poll_epoll_check_fds(mp_obj_poll_t *self, int timeout) {
+    unsigned int close_count = __atomic_load_n(&mp_unix_fd_close_count, __ATOMIC_RELAXED);
+    if (timeout == 0 && self->n_nval == 0 && self->fd_close_count == close_count) {
+        return;
+    }
+    self->fd_close_count = close_count;
+    struct pollfd *entry = self->entries;
+    for (int i = 0; i < self->len && self->epfd >= 0; i++, entry++) {
+        if (entry->fd == -1) {
+            continue;
+        }
+        bool closed = fcntl(entry->fd, F_GETFD) == -1 && errno == EBADF;
+        if (closed != (entry->revents == POLLNVAL)) {
+            poll_epoll_ctl(self, EPOLL_CTL_ADD, entry);
+        }
+    }
+}
+#endif
+
 /// \method register(obj[, eventmask])
 STATIC mp_obj_t poll_register(size_t n_args, const mp_obj_t *args) {
     mp_obj_poll_t *self = MP_OBJ_TO_PTR(args[0]);
@@ -100,6 +182,9 @@ STATIC mp_obj_t poll_register(size_t n_args, const mp_obj_t *args) {
         int entry_fd = entry->fd;
         if (entry_fd == fd) {
             entry->events = flags;
+            #if MICROPY_PY_USELECT_EPOLL
+            poll_epoll_ctl(self, EPOLL_CTL_MOD, entry);
+            #endif
             return mp_const_false;
         }
         if (entry_fd == -1) {
@@ -113,6 +198,10 @@ STATIC mp_obj_t poll_register(size_t n_args, const mp_obj_t *args) {
             if (self->obj_map) {
                 self->obj_map = m_renew(mp_obj_t, self->obj_map, self->alloc, self->alloc + 4);
             }
+            self->ready = m_renew(unsigned short, self->ready, self->alloc, self->alloc + 4);
+            #if MICROPY_PY_USELECT_EPOLL
+            self->events = m_renew(struct epoll_event, self->events, self->alloc, self->alloc + 4);
+            #endif
             self->alloc += 4;
         }
         free_slot = &self->entries[self->len++];
@@ -128,6 +217,9 @@ STATIC mp_obj_t poll_register(size_t n_args, const mp_obj_t *args) {
     free_slot->fd = fd;
     free_slot->events = flags;
     free_slot->revents = 0;
+    #if MICROPY_PY_USELECT_EPOLL
+    poll_epoll_ctl(self, EPOLL_CTL_ADD, free_slot);
+    #endif
     return mp_const_true;
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(poll_register_obj, 2, 3, poll_register);
@@ -139,6 +231,9 @@ STATIC mp_obj_t poll_unregister(mp_obj_t self_in, mp_obj_t obj_in) {
     int fd = get_fd(obj_in);
     for (int i = self->len - 1; i >= 0; i--) {
         if (entries->fd == fd) {
+            #if MICROPY_PY_USELECT_EPOLL
+            poll_epoll_ctl(self, EPOLL_CTL_DEL, entries);
+            #endif
             entries->fd = -1;
             if (self->obj_map) {
                 self->obj_map[entries - self->entries] = MP_OBJ_NULL;
@@ -161,6 +256,9 @@ STATIC mp_obj_t poll_modify(mp_obj_t self_in, mp_obj_t obj_in, mp_obj_t eventmas
     for (int i = self->len - 1; i >= 0; i--) {
         if (entries->fd == fd) {
             entries->events = mp_obj_get_int(eventmask_in);
+            #if MICROPY_PY_USELECT_EPOLL
+            poll_epoll_ctl(self, EPOLL_CTL_MOD, entries);
+            #endif
             break;
         }
         entries++;
@@ -191,8 +289,50 @@ STATIC int poll_poll_internal(size_t n_args, const mp_obj_t *args) {
 
     self->flags = flags;
 
+    #if MICROPY_PY_USELECT_EPOLL
+    poll_epoll_check_fds(self, timeout);
+    if (self->epfd >= 0) {
+        if (self->n_nval > 0) {
+            // closed fds are ready straight away
+            timeout = 0;
+        }
+        int n_events = epoll_wait(self->epfd, self->events, self->len > 0 ? self->len : 1, timeout);
+        RAISE_ERRNO(n_events, errno);
+        int n_ready = 0;
+        if (self->n_nval > 0) {
+            for (int i = 0; i < self->len; i++) {
+                if (self->entries[i].revents == POLLNVAL) {
+                    self->ready[n_ready++] = i;
+                }
+            }
+        }
+        // report the entries in the order they were registered, as poll(2) does
+        for (int i = 0; i < n_events; i++) {
+            unsigned short idx = self->events[i].data.u32;
+            if (self->entries[idx].revents == POLLNVAL) {
+                // still in the set through a dup of the closed fd
+                continue;
+            }
+            self->entries[idx].revents = self->events[i].events;
+            int j = n_ready++;
+            for (; j > 0 && self->ready[j - 1] > idx; j--) {
+                self->ready[j] = self->ready[j - 1];
+            }
+            self->ready[j] = idx;
+        }
+        return n_ready;
+    }
+    #endif
+
     int n_ready = poll(self->entries, self->len, timeout);
     RAISE_ERRNO(n_ready, errno);
+    int ret_i = 0;
+    struct pollfd *entries = self->entries;
+    for (int i = 0; i < self->len && ret_i < n_ready; i++, entries++) {
+        if (entries->revents != 0) {
+            self->ready[ret_i++] = i;
+        }
+    }
     return n_ready;
 }
 
@@ -208,22 +348,23 @@ STATIC mp_obj_t poll_poll(size_t n_args, const mp_obj_t *args) {
     mp_obj_poll_t *self = MP_OBJ_TO_PTR(args[0]);
 
     mp_obj_list_t *ret_list = MP_OBJ_TO_PTR(mp_obj_new_list(n_ready, NULL));
-    int ret_i = 0;
-    struct pollfd *entries = self->entries;
-    for (int i = 0; i < self->len; i++, entries++) {
-        if (entries->revents != 0) {
-            mp_obj_tuple_t *t = MP_OBJ_TO_PTR(mp_obj_new_tuple(2, NULL));
-            // If there's an object stored, return it, otherwise raw fd
-            if (self->obj_map && self->obj_map[i] != MP_OBJ_NULL) {
-                t->items[0] = self->obj_map[i];
-            } else {
-                t->items[0] = MP_OBJ_NEW_SMALL_INT(entries->fd);
-            }
-            t->items[1] = MP_OBJ_NEW_SMALL_INT(entries->revents);
-            ret_list->items[ret_i++] = MP_OBJ_FROM_PTR(t);
-            if (self->flags & FLAG_ONESHOT) {
-                entries->events = 0;
-            }
+    for (int ret_i = 0; ret_i < n_ready; ret_i++) {
+        int i = self->ready[ret_i];
+        struct pollfd *entries = &self->entries[i];
+        mp_obj_tuple_t *t = MP_OBJ_TO_PTR(mp_obj_new_tuple(2, NULL));
+        // If there's an object stored, return it, otherwise raw fd
+        if (self->obj_map && self->obj_map[i] != MP_OBJ_NULL) {
+            t->items[0] = self->obj_map[i];
+        } else {
+            t->items[0] = MP_OBJ_NEW_SMALL_INT(entries->fd);
+        }
+        t->items[1] = MP_OBJ_NEW_SMALL_INT(entries->revents);
+        ret_list->items[ret_i] = MP_OBJ_FROM_PTR(t);
+        if (self->flags & FLAG_ONESHOT) {
+            entries->events = 0;
+            #if MICROPY_PY_USELECT_EPOLL
+            poll_epoll_ctl(self, EPOLL_CTL_MOD, entries);
+            #endif
         }
     }
 
@@ -255,29 +396,32 @@ STATIC mp_obj_t poll_iternext(mp_obj_t self_in) {
 
     self->iter_cnt--;
 
-    struct pollfd *entries = self->entries + self->iter_idx;
-    for (int i = self->iter_idx; i < self->len; i++, entries++) {
-        self->iter_idx++;
-        if (entries->revents != 0) {
-            mp_obj_tuple_t *t = MP_OBJ_TO_PTR(self->ret_tuple);
-            // If there's an object stored, return it, otherwise raw fd
-            if (self->obj_map && self->obj_map[i] != MP_OBJ_NULL) {
-                t->items[0] = self->obj_map[i];
-            } else {
-                t->items[0] = MP_OBJ_NEW_SMALL_INT(entries->fd);
-            }
-            t->items[1] = MP_OBJ_NEW_SMALL_INT(entries->revents);
-            if (self->flags & FLAG_ONESHOT) {
-                entries->events = 0;
-            }
-            return MP_OBJ_FROM_PTR(t);
-        }
+    int i = self->ready[self->iter_idx++];
+    struct pollfd *entries = &self->entries[i];
+    mp_obj_tuple_t *t = MP_OBJ_TO_PTR(self->ret_tuple);
+    // If there's an object stored, return it, otherwise raw fd
+    if (self->obj_map && self->obj_map[i] != MP_OBJ_NULL) {
+        t->items[0] = self->obj_map[i];
+    } else {
+        t->items[0] = MP_OBJ_NEW_SMALL_INT(entries->fd);
+    }
+    t->items[1] = MP_OBJ_NEW_SMALL_INT(entries->revents);
+    if (self->flags & FLAG_ONESHOT) {
+        entries->events = 0;
+        #if MICROPY_PY_USELECT_EPOLL
+        poll_epoll_ctl(self, EPOLL_CTL_MOD, entries);
+        #endif
     }
+    return MP_OBJ_FROM_PTR(t);
+}
 
-    assert(!"inconsistent number of poll active entries");
-    self->iter_cnt = 0;
-    return MP_OBJ_STOP_ITERATION;
+#if MICROPY_PY_USELECT_EPOLL
+STATIC mp_obj_t poll_del(mp_obj_t self_in) {
+    poll_epoll_close(MP_OBJ_TO_PTR(self_in));
+    return mp_const_none;
 }
+MP_DEFINE_CONST_FUN_OBJ_1(poll_del_obj, poll_del);
+#endif
 
 #if DEBUG
 STATIC mp_obj_t poll_dump(mp_obj_t self_in) {
@@ -304,6 +448,9 @@ STATIC const mp_rom_map_elem_t poll_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_modify), MP_ROM_PTR(&poll_modify_obj) },
     { MP_ROM_QSTR(MP_QSTR_poll), MP_ROM_PTR(&poll_poll_obj) },
     { MP_ROM_QSTR(MP_QSTR_ipoll), MP_ROM_PTR(&poll_ipoll_obj) },
+    #if MICROPY_PY_USELECT_EPOLL
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&poll_del_obj) },
+    #endif
     #if DEBUG
     { MP_ROM_QSTR(MP_QSTR_dump), MP_ROM_PTR(&poll_dump_obj) },
     #endif
@@ -323,14 +470,25 @@ STATIC mp_obj_t select_poll(size_t n_args, const mp_obj_t *args) {
     if (n_args > 0) {
         alloc = mp_obj_get_int(args[0]);
     }
+    #if MICROPY_PY_USELECT_EPOLL
+    mp_obj_poll_t *poll = m_new_obj_with_finaliser(mp_obj_poll_t);
+    #else
     mp_obj_poll_t *poll = m_new_obj(mp_obj_poll_t);
+    #endif
     poll->base.type = &mp_type_poll;
     poll->entries = m_new(struct pollfd, alloc);
     poll->alloc = alloc;
     poll->len = 0;
     poll->obj_map = NULL;
+    poll->ready = m_new(unsigned short, alloc);
     poll->iter_cnt = 0;
     poll->ret_tuple = MP_OBJ_NULL;
+    #if MICROPY_PY_USELECT_EPOLL
+    poll->events = m_new(struct epoll_event, alloc);
+    poll->epfd = epoll_create1(EPOLL_CLOEXEC);
+    poll->n_nval = 0;
+    poll->fd_close_count = mp_unix_fd_close_count;
+    #endif
     return MP_OBJ_FROM_PTR(poll);
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_select_poll_obj, 0, 1, select_poll);
@@ -46,6 +46,7 @@
 #include "py/mphal.h"
 
 #include "supervisor/shared/translate.h"
+#include "fdfile.h"
 
 /*
   The idea of this module is to implement reasonable minimum of
@@ -123,6 +124,7 @@ STATIC mp_uint_t socket_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg, i
             // file descriptor. If you're interested to catch I/O errors before
             // closing fd, fsync() it.
             close(self->fd);
+            MP_UNIX_FD_CLOSED();
             return 0;
 
         default:
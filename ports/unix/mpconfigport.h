@@ -28,6 +28,7 @@
 
 #define MICROPY_ALLOC_PATH_MAX      (PATH_MAX)
 #define MICROPY_PERSISTENT_CODE_LOAD (1)
+#define MICROPY_PERSISTENT_CODE_LOAD_MAPPED (1)
 #if !defined(MICROPY_EMIT_X64) && defined(__x86_64__)
     #define MICROPY_EMIT_X64        (1)
 #endif
@@ -70,6 +71,15 @@
 #ifndef MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE (1)
 #endif
+#define MICROPY_OPT_TYPE_ATTR_CACHE (1)
+#define MICROPY_QSTR_HASH_INDEX     (1)
+#define MICROPY_OPT_MAP_LOOKUP_CACHE (1)
+#define MICROPY_OPT_MAP_ORDERED_INDEX (1)
+#define MICROPY_OPT_QUICKEN_BYTECODE (1)
+#define MICROPY_OPT_SUPERINSTRUCTIONS (1)
+#define MICROPY_GC_INCREMENTAL      (1)
+#define MICROPY_GC_TLAB             (MICROPY_PY_THREAD)
+#define MICROPY_GC_SNAPSHOT         (1)
 #define MICROPY_CAN_OVERRIDE_BUILTINS (1)
 #define MICROPY_PY_FUNCTION_ATTRS   (1)
 #define MICROPY_PY_DESCRIPTORS      (1)
@@ -120,8 +130,11 @@
 #define MICROPY_PY_UERRNO           (1)
 #define MICROPY_PY_UCTYPES          (1)
 #define MICROPY_PY_UZLIB            (1)
+#define MICROPY_PY_UZLIB_COMPRESS   (1)
 #define MICROPY_PY_UJSON            (1)
+#define MICROPY_PY_UJSON_TOKENIZE   (1)
 #define MICROPY_PY_URE              (1)
+#define MICROPY_PY_URE_PIKEVM       (1)
 #define MICROPY_PY_UHEAPQ           (1)
 #define MICROPY_PY_UTIMEQ           (1)
 #define MICROPY_PY_UHASHLIB         (1)
@@ -134,6 +147,14 @@
 #ifndef MICROPY_PY_USELECT_POSIX
 #define MICROPY_PY_USELECT_POSIX    (1)
 #endif
+// Wait on an epoll set in uselect.poll objects, where there is one
+#ifndef MICROPY_PY_USELECT_EPOLL
+#ifdef __linux__
+#define MICROPY_PY_USELECT_EPOLL    (MICROPY_PY_USELECT_POSIX)
+#else
+#define MICROPY_PY_USELECT_EPOLL    (0)
+#endif
+#endif
 #define MICROPY_PY_WEBSOCKET        (1)
 #define MICROPY_PY_MACHINE          (1)
 #define MICROPY_PY_MACHINE_PULSE    (1)
@@ -155,6 +176,14 @@
 
 extern const struct _mp_print_t mp_stderr_print;
 
+#ifdef __linux__
+// Bounds of the executable, so that a heap snapshot can be restored when it is
+// loaded at another address.
+extern char __executable_start[], _end[];
+#define MICROPY_GC_SNAPSHOT_IMAGE_START (__executable_start)
+#define MICROPY_GC_SNAPSHOT_IMAGE_END (_end)
+#endif
+
 // Define to 1 to use undertested inefficient GC helper implementation
 // (if more efficient arch-specific one is not available).
 #ifndef MICROPY_GCREGS_SETJMP
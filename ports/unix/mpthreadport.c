@@ -70,6 +70,9 @@ STATIC void mp_thread_gc(int signo, siginfo_t *info, void *context) {
         void **ptrs = (void**)(void*)MP_STATE_THREAD(pystack_start);
         gc_collect_root(ptrs, (MP_STATE_THREAD(pystack_cur) - MP_STATE_THREAD(pystack_start)) / sizeof(void*));
         #endif
+        #if MICROPY_GC_TLAB
+        gc_collect_tlab();
+        #endif
         thread_signal_done = 1;
     }
 }
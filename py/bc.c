@@ -307,6 +307,9 @@ continue2:;
 //     MP_BC_LOAD_GLOBAL
 //     MP_BC_LOAD_ATTR
 //     MP_BC_STORE_ATTR
+// The superinstructions in 0x48-0x4f carry their operands as extra bytes too.
+// The quickened opcodes in 0x00-0x0b are left undefined because they only ever
+// appear in bytecode that the VM has already started executing.
 #define OC4(a, b, c, d) (a | (b << 2) | (c << 4) | (d << 6))
 #define U (0) // undefined opcode
 #define B (MP_OPCODE_BYTE) // single byte
@@ -332,8 +335,8 @@ STATIC const byte opcode_format_table[64] = {
     OC4(U, O, B, O), // 0x3c-0x3f
     OC4(O, B, B, O), // 0x40-0x43
     OC4(B, B, O, B), // 0x44-0x47
-    OC4(U, U, U, U), // 0x48-0x4b
-    OC4(U, U, U, U), // 0x4c-0x4f
+    OC4(B, B, O, O), // 0x48-0x4b
+    OC4(O, O, B, B), // 0x4c-0x4f
     OC4(V, V, U, V), // 0x50-0x53
     OC4(B, U, V, V), // 0x54-0x57
     OC4(V, V, V, B), // 0x58-0x5b
@@ -398,7 +401,7 @@ uint mp_opcode_format(const byte *ip, size_t *opcode_size) {
     if (f == MP_OPCODE_QSTR) {
         ip += 3;
     } else {
-        int extra_byte = (
+        int extra_bytes = (
             *ip == MP_BC_RAISE_VARARGS
             || *ip == MP_BC_MAKE_CLOSURE
             || *ip == MP_BC_MAKE_CLOSURE_DEFARGS
@@ -409,6 +412,15 @@ uint mp_opcode_format(const byte *ip, size_t *opcode_size) {
             || *ip == MP_BC_STORE_ATTR
             #endif
         );
+        if (*ip == MP_BC_LOAD_FAST_LOAD_FAST
+            || *ip == MP_BC_BINARY_OP_POP_JUMP_IF_TRUE
+            || *ip == MP_BC_BINARY_OP_POP_JUMP_IF_FALSE) {
+            extra_bytes = 1;
+        } else if (*ip == MP_BC_BINARY_OP_SMALL_INT
+            || *ip == MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_TRUE
+            || *ip == MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_FALSE) {
+            extra_bytes = 2;
+        }
         ip += 1;
         if (f == MP_OPCODE_VAR_UINT) {
             while ((*ip++ & 0x80) != 0) {
@@ -416,7 +428,7 @@ uint mp_opcode_format(const byte *ip, size_t *opcode_size) {
         } else if (f == MP_OPCODE_OFFSET) {
             ip += 2;
         }
-        ip += extra_byte;
+        ip += extra_bytes;
     }
     *opcode_size = ip - ip_start;
     return f;
@@ -82,6 +82,17 @@
 #define MP_BC_UNWIND_JUMP        (0x46) // rel byte code offset, 16-bit signed, in excess; then a byte
 #define MP_BC_GET_ITER_STACK     (0x47)
 
+// Superinstructions, emitted in place of common opcode sequences when
+// MICROPY_OPT_SUPERINSTRUCTIONS is enabled.
+#define MP_BC_LOAD_FAST_LOAD_FAST        (0x48) // byte: local (0-15) << 4 | local (0-15)
+#define MP_BC_BINARY_OP_SMALL_INT        (0x49) // byte: op; byte: small int + 16 (-16..47)
+#define MP_BC_BINARY_OP_POP_JUMP_IF_TRUE  (0x4a) // byte: op; rel byte code offset, 16-bit signed, in excess
+#define MP_BC_BINARY_OP_POP_JUMP_IF_FALSE (0x4b) // byte: op; rel byte code offset, 16-bit signed, in excess
+#define MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_TRUE  (0x4c) // byte: op; byte: small int + 16; rel byte code offset, 16-bit signed, in excess
+#define MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_FALSE (0x4d) // byte: op; byte: small int + 16; rel byte code offset, 16-bit signed, in excess
+#define MP_BC_DUP_TOP_TWO_LOAD_SUBSCR    (0x4e)
+#define MP_BC_ROT_THREE_STORE_SUBSCR     (0x4f)
+
 #define MP_BC_BUILD_TUPLE        (0x50) // uint
 #define MP_BC_BUILD_LIST         (0x51) // uint
 #define MP_BC_BUILD_MAP          (0x53) // uint
@@ -116,4 +127,23 @@
 #define MP_BC_UNARY_OP_MULTI             (0xd0) // + op(<MP_UNARY_OP_NUM_BYTECODE)
 #define MP_BC_BINARY_OP_MULTI            (0xd7) // + op(<MP_BINARY_OP_NUM_BYTECODE)
 
+// Quickened byte-codes.  These are never emitted by the compiler nor stored in
+// .mpy files: with MICROPY_OPT_QUICKEN_BYTECODE the VM rewrites the generic
+// opcode in RAM-resident bytecode to one of these once it has seen the operand
+// types they specialise on, and writes the generic opcode back if it later
+// sees different types.  Each one has the same size and stack effect as the
+// opcode it replaces.
+#define MP_BC_QUICK_BINARY_OP_LESS_SMALL_INT          (0x00)
+#define MP_BC_QUICK_BINARY_OP_MORE_SMALL_INT          (0x01)
+#define MP_BC_QUICK_BINARY_OP_EQUAL_SMALL_INT         (0x02)
+#define MP_BC_QUICK_BINARY_OP_LESS_EQUAL_SMALL_INT    (0x03)
+#define MP_BC_QUICK_BINARY_OP_MORE_EQUAL_SMALL_INT    (0x04)
+#define MP_BC_QUICK_BINARY_OP_NOT_EQUAL_SMALL_INT     (0x05)
+#define MP_BC_QUICK_BINARY_OP_ADD_SMALL_INT           (0x06)
+#define MP_BC_QUICK_BINARY_OP_SUBTRACT_SMALL_INT      (0x07)
+#define MP_BC_QUICK_BINARY_OP_INPLACE_ADD_SMALL_INT   (0x08)
+#define MP_BC_QUICK_BINARY_OP_INPLACE_SUBTRACT_SMALL_INT (0x09)
+#define MP_BC_QUICK_LOAD_SUBSCR_LIST                  (0x0a)
+#define MP_BC_QUICK_STORE_SUBSCR_LIST                 (0x0b)
+
 #endif // MICROPY_INCLUDED_PY_BC0_H
@@ -195,6 +195,15 @@ typedef long mp_off_t;
 #define MICROPY_PY_URE_MATCH_GROUPS           (CIRCUITPY_FULL_BUILD)
 #define MICROPY_PY_URE_MATCH_SPAN_START_END   (CIRCUITPY_FULL_BUILD)
 #define MICROPY_PY_URE_SUB                    (CIRCUITPY_FULL_BUILD)
+#define MICROPY_PY_UJSON_TOKENIZE             (CIRCUITPY_FULL_BUILD)
+#define MICROPY_OPT_TYPE_ATTR_CACHE           (CIRCUITPY_FULL_BUILD)
+#define MICROPY_OPT_TYPE_ATTR_CACHE_SIZE      (32)
+#define MICROPY_QSTR_HASH_INDEX               (CIRCUITPY_FULL_BUILD)
+#define MICROPY_OPT_MAP_LOOKUP_CACHE          (CIRCUITPY_FULL_BUILD)
+#define MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE     (64)
+#define MICROPY_OPT_MAP_ORDERED_INDEX         (CIRCUITPY_FULL_BUILD)
+#define MICROPY_OPT_QUICKEN_BYTECODE          (CIRCUITPY_FULL_BUILD)
+#define MICROPY_OPT_SUPERINSTRUCTIONS         (CIRCUITPY_FULL_BUILD)
 
 // LONGINT_IMPL_xxx are defined in the Makefile.
 //
@@ -308,6 +317,11 @@ extern const struct _mp_obj_module_t terminalio_module;
 #define FONTIO_MODULE       { MP_OBJ_NEW_QSTR(MP_QSTR_fontio), (mp_obj_t)&fontio_module },
 #define TERMINALIO_MODULE      { MP_OBJ_NEW_QSTR(MP_QSTR_terminalio), (mp_obj_t)&terminalio_module },
 #define CIRCUITPY_DISPLAY_LIMIT (1)
+// Size of each Display's refresh buffer in uint32_ts. Larger buffers update more of the display
+// per region command.
+#ifndef CIRCUITPY_DISPLAY_REFRESH_BUFFER_SIZE
+#define CIRCUITPY_DISPLAY_REFRESH_BUFFER_SIZE (128)
+#endif
 #else
 #define DISPLAYIO_MODULE
 #define FONTIO_MODULE
@@ -647,6 +661,12 @@ extern const struct _mp_obj_module_t ustack_module;
 void run_background_tasks(void);
 #define RUN_BACKGROUND_TASKS (run_background_tasks())
 
+// Incremental GC is opt-in per board. Background tasks may allocate, such as the flash write
+// cache, so they don't run between mark slices and only the sweep is spread out, by
+// run_background_tasks. Slices are timed from the port's SysTick.
+uint32_t ticks_us(void);
+#define MICROPY_GC_INCREMENTAL_TICKS_US() ticks_us()
+
 // TODO: Used in wiznet5k driver, but may not be needed in the long run.
 #define MICROPY_THREAD_YIELD()
 
@@ -656,5 +676,7 @@ void run_background_tasks(void);
 #define CIRCUITPY_AUTORELOAD_DELAY_MS 500
 #define CIRCUITPY_FILESYSTEM_FLUSH_INTERVAL_MS 1000
 #define CIRCUITPY_BOOT_OUTPUT_FILE "/boot_out.txt"
+// Heap restored on soft reload when the port enables MICROPY_GC_SNAPSHOT.
+#define CIRCUITPY_HEAP_SNAPSHOT_FILE "/heap.snapshot"
 
 #endif  // __INCLUDED_MPCONFIG_CIRCUITPY_H
@@ -52,6 +52,12 @@ ifndef CIRCUITPY_DEFAULT_BUILD
   endif
 endif
 
+# Full builds execute superinstructions (MICROPY_OPT_SUPERINSTRUCTIONS), so
+# their frozen modules are compiled to use them.
+ifeq ($(CIRCUITPY_FULL_BUILD),1)
+  MPY_CROSS_FLAGS += -msuperinstructions
+endif
+
 
 
 # All builtin modules are listed below, with default values (0 for off, 1 for on)
@@ -55,6 +55,11 @@ struct _emit_t {
     mp_uint_t last_source_line_offset;
     mp_uint_t last_source_line;
 
+    // The last instruction emitted, if the next one may be fused with it
+    // into a superinstruction; fuse_opcode is 0 if there is no such candidate.
+    size_t fuse_offset;
+    byte fuse_opcode;
+
     mp_uint_t max_num_labels;
     mp_uint_t *label_offsets;
 
@@ -171,6 +176,9 @@ STATIC void emit_write_code_info_bytes_lines(emit_t *emit, mp_uint_t bytes_to_sk
 // all functions must go through this one to emit byte code
 STATIC byte *emit_get_cur_to_write_bytecode(emit_t *emit, int num_bytes_to_write) {
     //printf("emit %d\n", num_bytes_to_write);
+    // any instruction written ends a sequence that could be fused; the callers
+    // that can start one record it after writing
+    emit->fuse_opcode = 0;
     if (emit->pass < MP_PASS_EMIT) {
         emit->bytecode_offset += num_bytes_to_write;
         return emit->dummy_data;
@@ -182,6 +190,26 @@ STATIC byte *emit_get_cur_to_write_bytecode(emit_t *emit, int num_bytes_to_write
     }
 }
 
+// The instruction that the one about to be emitted may be fused with, or 0.
+#define EMIT_FUSE_OPCODE(emit) (MICROPY_OPT_SUPERINSTRUCTIONS_DYNAMIC ? (emit)->fuse_opcode : 0)
+
+// Record that the instruction just written at offset may be fused with the next.
+STATIC void emit_bc_fuse_candidate(emit_t *emit, size_t offset, byte opcode) {
+    if (MICROPY_OPT_SUPERINSTRUCTIONS_DYNAMIC) {
+        emit->fuse_offset = offset;
+        emit->fuse_opcode = opcode;
+    }
+}
+
+// Replace the opcode of the fusion candidate with a superinstruction; the rest
+// of the superinstruction is then written after it as normal.
+STATIC void emit_bc_fuse(emit_t *emit, byte opcode) {
+    if (emit->pass == MP_PASS_EMIT) {
+        emit->code_base[emit->code_info_size + emit->fuse_offset] = opcode;
+    }
+    emit->fuse_opcode = 0;
+}
+
 STATIC void emit_write_bytecode_byte(emit_t *emit, byte b1) {
     byte *c = emit_get_cur_to_write_bytecode(emit, 1);
     c[0] = b1;
@@ -293,17 +321,21 @@ STATIC void emit_write_bytecode_byte_unsigned_label(emit_t *emit, byte b1, mp_ui
 }
 
 // signed labels are relative to ip following this instruction, stored as 16 bits, in excess
-STATIC void emit_write_bytecode_byte_signed_label(emit_t *emit, byte b1, mp_uint_t label) {
+STATIC void emit_write_bytecode_signed_label(emit_t *emit, mp_uint_t label) {
     int bytecode_offset;
     if (emit->pass < MP_PASS_EMIT) {
         bytecode_offset = 0;
     } else {
-        bytecode_offset = emit->label_offsets[label] - emit->bytecode_offset - 3 + 0x8000;
+        bytecode_offset = emit->label_offsets[label] - emit->bytecode_offset - 2 + 0x8000;
     }
-    byte *c = emit_get_cur_to_write_bytecode(emit, 3);
-    c[0] = b1;
-    c[1] = bytecode_offset;
-    c[2] = bytecode_offset >> 8;
+    byte *c = emit_get_cur_to_write_bytecode(emit, 2);
+    c[0] = bytecode_offset;
+    c[1] = bytecode_offset >> 8;
+}
+
+STATIC void emit_write_bytecode_byte_signed_label(emit_t *emit, byte b1, mp_uint_t label) {
+    emit_write_bytecode_byte(emit, b1);
+    emit_write_bytecode_signed_label(emit, label);
 }
 
 void mp_emit_bc_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
@@ -313,6 +345,7 @@ void mp_emit_bc_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
     emit->scope = scope;
     emit->last_source_line_offset = 0;
     emit->last_source_line = 1;
+    emit->fuse_opcode = 0;
     #ifndef NDEBUG
     // With debugging enabled labels are checked for unique assignment
     if (pass < MP_PASS_EMIT && emit->label_offsets != NULL) {
@@ -481,6 +514,8 @@ void mp_emit_bc_set_source_line(emit_t *emit, mp_uint_t source_line) {
         emit_write_code_info_bytes_lines(emit, bytes_to_skip, lines_to_skip);
         emit->last_source_line_offset = emit->bytecode_offset;
         emit->last_source_line = source_line;
+        // don't fuse across lines, so each instruction maps to a single line
+        emit->fuse_opcode = 0;
     }
 #else
     (void)emit;
@@ -494,6 +529,8 @@ void mp_emit_bc_label_assign(emit_t *emit, mp_uint_t l) {
         return;
     }
     assert(l < emit->max_num_labels);
+    // a jump may land here, so this can't be in the middle of a superinstruction
+    emit->fuse_opcode = 0;
     if (emit->pass < MP_PASS_EMIT) {
         // assign label offset
         assert(emit->label_offsets[l] == (mp_uint_t)-1);
@@ -535,7 +572,9 @@ void mp_emit_bc_load_const_tok(emit_t *emit, mp_token_kind_t tok) {
 void mp_emit_bc_load_const_small_int(emit_t *emit, mp_int_t arg) {
     emit_bc_pre(emit, 1);
     if (-16 <= arg && arg <= 47) {
+        size_t offset = emit->bytecode_offset;
         emit_write_bytecode_byte(emit, MP_BC_LOAD_CONST_SMALL_INT_MULTI + 16 + arg);
+        emit_bc_fuse_candidate(emit, offset, MP_BC_LOAD_CONST_SMALL_INT_MULTI + 16 + arg);
     } else {
         emit_write_bytecode_byte_int(emit, MP_BC_LOAD_CONST_SMALL_INT, arg);
     }
@@ -562,7 +601,15 @@ void mp_emit_bc_load_local(emit_t *emit, qstr qst, mp_uint_t local_num, int kind
     (void)qst;
     emit_bc_pre(emit, 1);
     if (kind == MP_EMIT_IDOP_LOCAL_FAST && local_num <= 15) {
-        emit_write_bytecode_byte(emit, MP_BC_LOAD_FAST_MULTI + local_num);
+        byte prev = EMIT_FUSE_OPCODE(emit);
+        if (prev >= MP_BC_LOAD_FAST_MULTI && prev < MP_BC_LOAD_FAST_MULTI + 16) {
+            emit_bc_fuse(emit, MP_BC_LOAD_FAST_LOAD_FAST);
+            emit_write_bytecode_byte(emit, (prev - MP_BC_LOAD_FAST_MULTI) << 4 | local_num);
+        } else {
+            size_t offset = emit->bytecode_offset;
+            emit_write_bytecode_byte(emit, MP_BC_LOAD_FAST_MULTI + local_num);
+            emit_bc_fuse_candidate(emit, offset, MP_BC_LOAD_FAST_MULTI + local_num);
+        }
     } else {
         emit_write_bytecode_byte_uint(emit, MP_BC_LOAD_FAST_N + kind, local_num);
     }
@@ -592,14 +639,22 @@ void mp_emit_bc_load_build_class(emit_t *emit) {
 void mp_emit_bc_subscr(emit_t *emit, int kind) {
     if (kind == MP_EMIT_SUBSCR_LOAD) {
         emit_bc_pre(emit, -1);
-        emit_write_bytecode_byte(emit, MP_BC_LOAD_SUBSCR);
+        if (EMIT_FUSE_OPCODE(emit) == MP_BC_DUP_TOP_TWO) {
+            emit_bc_fuse(emit, MP_BC_DUP_TOP_TWO_LOAD_SUBSCR);
+        } else {
+            emit_write_bytecode_byte(emit, MP_BC_LOAD_SUBSCR);
+        }
     } else {
         if (kind == MP_EMIT_SUBSCR_DELETE) {
             mp_emit_bc_load_null(emit);
             mp_emit_bc_rot_three(emit);
         }
         emit_bc_pre(emit, -3);
-        emit_write_bytecode_byte(emit, MP_BC_STORE_SUBSCR);
+        if (EMIT_FUSE_OPCODE(emit) == MP_BC_ROT_THREE) {
+            emit_bc_fuse(emit, MP_BC_ROT_THREE_STORE_SUBSCR);
+        } else {
+            emit_write_bytecode_byte(emit, MP_BC_STORE_SUBSCR);
+        }
     }
 }
 
@@ -660,7 +715,9 @@ void mp_emit_bc_dup_top(emit_t *emit) {
 
 void mp_emit_bc_dup_top_two(emit_t *emit) {
     emit_bc_pre(emit, 2);
+    size_t offset = emit->bytecode_offset;
     emit_write_bytecode_byte(emit, MP_BC_DUP_TOP_TWO);
+    emit_bc_fuse_candidate(emit, offset, MP_BC_DUP_TOP_TWO);
 }
 
 void mp_emit_bc_pop_top(emit_t *emit) {
@@ -675,7 +732,9 @@ void mp_emit_bc_rot_two(emit_t *emit) {
 
 void mp_emit_bc_rot_three(emit_t *emit) {
     emit_bc_pre(emit, 0);
+    size_t offset = emit->bytecode_offset;
     emit_write_bytecode_byte(emit, MP_BC_ROT_THREE);
+    emit_bc_fuse_candidate(emit, offset, MP_BC_ROT_THREE);
 }
 
 void mp_emit_bc_jump(emit_t *emit, mp_uint_t label) {
@@ -685,7 +744,14 @@ void mp_emit_bc_jump(emit_t *emit, mp_uint_t label) {
 
 void mp_emit_bc_pop_jump_if(emit_t *emit, bool cond, mp_uint_t label) {
     emit_bc_pre(emit, -1);
-    if (cond) {
+    byte prev = EMIT_FUSE_OPCODE(emit);
+    if (prev >= MP_BC_BINARY_OP_MULTI && prev < MP_BC_BINARY_OP_MULTI + MP_BINARY_OP_NUM_BYTECODE) {
+        emit_bc_fuse(emit, cond ? MP_BC_BINARY_OP_POP_JUMP_IF_TRUE : MP_BC_BINARY_OP_POP_JUMP_IF_FALSE);
+        emit_write_bytecode_byte_signed_label(emit, prev - MP_BC_BINARY_OP_MULTI, label);
+    } else if (prev == MP_BC_BINARY_OP_SMALL_INT) {
+        emit_bc_fuse(emit, cond ? MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_TRUE : MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_FALSE);
+        emit_write_bytecode_signed_label(emit, label);
+    } else if (cond) {
         emit_write_bytecode_byte_signed_label(emit, MP_BC_POP_JUMP_IF_TRUE, label);
     } else {
         emit_write_bytecode_byte_signed_label(emit, MP_BC_POP_JUMP_IF_FALSE, label);
@@ -786,7 +852,17 @@ void mp_emit_bc_binary_op(emit_t *emit, mp_binary_op_t op) {
         op = MP_BINARY_OP_IS;
     }
     emit_bc_pre(emit, -1);
-    emit_write_bytecode_byte(emit, MP_BC_BINARY_OP_MULTI + op);
+    byte prev = EMIT_FUSE_OPCODE(emit);
+    if (prev >= MP_BC_LOAD_CONST_SMALL_INT_MULTI && prev < MP_BC_LOAD_CONST_SMALL_INT_MULTI + 64) {
+        size_t offset = emit->fuse_offset;
+        emit_bc_fuse(emit, MP_BC_BINARY_OP_SMALL_INT);
+        emit_write_bytecode_byte_byte(emit, op, prev - MP_BC_LOAD_CONST_SMALL_INT_MULTI);
+        emit_bc_fuse_candidate(emit, offset, MP_BC_BINARY_OP_SMALL_INT);
+    } else {
+        size_t offset = emit->bytecode_offset;
+        emit_write_bytecode_byte(emit, MP_BC_BINARY_OP_MULTI + op);
+        emit_bc_fuse_candidate(emit, offset, MP_BC_BINARY_OP_MULTI + op);
+    }
     if (invert) {
         emit_bc_pre(emit, 0);
         emit_write_bytecode_byte(emit, MP_BC_UNARY_OP_MULTI + MP_UNARY_OP_NOT);
@@ -47,6 +47,9 @@ typedef struct _mp_raw_code_t {
         struct {
             const byte *bytecode;
             const mp_uint_t *const_table;
+            #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+            const uint16_t *qstr_link;
+            #endif
             #if MICROPY_PERSISTENT_CODE_SAVE
             mp_uint_t bc_len;
             uint16_t n_obj;
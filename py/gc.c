@@ -30,6 +30,9 @@
 
 #include "py/gc.h"
 #include "py/runtime.h"
+#if MICROPY_GC_INCREMENTAL
+#include "py/mphal.h"
+#endif
 
 #include "supervisor/shared/safe_mode.h"
 
@@ -100,6 +103,16 @@
 #define GC_EXIT()
 #endif
 
+#if MICROPY_GC_TLAB
+STATIC inline mp_state_thread_t *gc_tlab_thread(void) {
+    #if MICROPY_PY_THREAD
+    return mp_thread_get_state();
+    #else
+    return &mp_state_ctx.thread;
+    #endif
+}
+#endif
+
 #ifdef LOG_HEAP_ACTIVITY
 volatile uint32_t change_me;
 #pragma GCC push_options
@@ -111,6 +124,161 @@ void __attribute__ ((noinline)) gc_log_change(uint32_t start_block, uint32_t len
 #pragma GCC pop_options
 #endif
 
+#define GC_SMALL_ALLOC_HINTS (MP_ARRAY_SIZE(MP_STATE_MEM(gc_small_alloc_hint)))
+#define GC_NO_BLOCK ((size_t)-1)
+
+// Blocks from block onwards have just been freed, so a run of n free blocks
+// may now start as early as n - 1 blocks before it.
+STATIC void gc_lower_small_alloc_hints(size_t block) {
+    for (size_t i = 0; i < GC_SMALL_ALLOC_HINTS; i++) {
+        size_t hint = block > i ? block - i : 0;
+        if (hint < MP_STATE_MEM(gc_small_alloc_hint)[i]) {
+            MP_STATE_MEM(gc_small_alloc_hint)[i] = hint;
+        }
+    }
+}
+
+STATIC void gc_reset_small_alloc_hints(void) {
+    for (size_t i = 0; i < GC_SMALL_ALLOC_HINTS; i++) {
+        MP_STATE_MEM(gc_small_alloc_hint)[i] = 0;
+    }
+}
+
+#if MICROPY_GC_INCREMENTAL
+// Without a write barrier the VM can't run while marking, so an incremental
+// collection still marks to completion, but it does so in slices with
+// MICROPY_GC_INCREMENTAL_YIELD run between them.  Sweeping is safe to
+// interleave with the VM because unmarked blocks can never become reachable
+// again, so after an automatic collection it is left to gc_alloc and the
+// background loop.
+
+#define GC_SWEEP_PENDING() (MP_STATE_MEM(gc_sweep_block) < MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB)
+
+STATIC void gc_slice_begin(void) {
+    MP_STATE_MEM(gc_slice_work) = 0;
+    MP_STATE_MEM(gc_slice_start) = MICROPY_GC_INCREMENTAL_TICKS_US();
+}
+
+STATIC void gc_slice_end(void) {
+    mp_uint_t pause = MICROPY_GC_INCREMENTAL_TICKS_US() - MP_STATE_MEM(gc_slice_start);
+    if (pause > MP_STATE_MEM(gc_pause_max_us)) {
+        MP_STATE_MEM(gc_pause_max_us) = pause;
+    }
+    MP_STATE_MEM(gc_pause_slices)++;
+}
+
+// Account for n_blocks of marking or sweeping.  Every gc_slice_blocks blocks the
+// clock is checked, and once the slice has run for gc_max_pause_us it ends and
+// the port's yield hook runs before the next one starts.
+STATIC void gc_slice_work(size_t n_blocks) {
+    if (MP_STATE_MEM(gc_slice_blocks) == 0) {
+        return;
+    }
+    MP_STATE_MEM(gc_slice_work) += n_blocks;
+    if (MP_STATE_MEM(gc_slice_work) < MP_STATE_MEM(gc_slice_blocks)) {
+        return;
+    }
+    MP_STATE_MEM(gc_slice_work) = 0;
+    if (MICROPY_GC_INCREMENTAL_TICKS_US() - MP_STATE_MEM(gc_slice_start) < MP_STATE_MEM(gc_max_pause_us)) {
+        return;
+    }
+    gc_slice_end();
+    MP_STATE_MEM(gc_slice_yielding) = true;
+    MICROPY_GC_INCREMENTAL_YIELD();
+    MP_STATE_MEM(gc_slice_yielding) = false;
+    gc_slice_begin();
+}
+#define GC_SLICE_WORK(n_blocks) gc_slice_work(n_blocks)
+#else
+#define GC_SLICE_WORK(n_blocks)
+#endif
+
+// Returns a mask with bit k set when the k'th block covered by the n_atb
+// (at most 4) ATBs starting at index atb is free.
+STATIC inline uint32_t gc_atb_free_mask(size_t atb, size_t n_atb) {
+    const byte *table = MP_STATE_MEM(gc_alloc_table_start) + atb;
+    uint32_t w = 0;
+    for (size_t i = 0; i < n_atb; i++) {
+        w |= (uint32_t)table[i] << (8 * i);
+    }
+    // a block is free when both of its bits are clear
+    w = ~(w | (w >> 1)) & 0x55555555;
+    // gather the even bits together
+    w = (w | (w >> 1)) & 0x33333333;
+    w = (w | (w >> 2)) & 0x0f0f0f0f;
+    w = (w | (w >> 4)) & 0x00ff00ff;
+    w = (w | (w >> 8)) & 0x0000ffff;
+    return w & (((uint32_t)1 << (n_atb * BLOCKS_PER_ATB)) - 1);
+}
+
+// Find the first run of n_blocks free blocks scanning up from start_block to the
+// end of ATB last_atb, 16 blocks at a time.  Gives up on reaching a used block at
+// or above stop_block.  Returns the first block of the run or GC_NO_BLOCK.
+STATIC size_t gc_find_free_up(size_t start_block, size_t last_atb, size_t n_blocks, size_t stop_block) {
+    size_t n_free = 0;
+    size_t pos = start_block % (4 * BLOCKS_PER_ATB);
+    for (size_t atb = start_block / BLOCKS_PER_ATB & ~(size_t)3; atb <= last_atb; atb += 4, pos = 0) {
+        size_t n_atb = MIN(4, last_atb - atb + 1);
+        size_t width = n_atb * BLOCKS_PER_ATB;
+        size_t base = atb * BLOCKS_PER_ATB;
+        uint32_t free_mask = gc_atb_free_mask(atb, n_atb);
+        while (pos < width) {
+            uint32_t rest = free_mask >> pos;
+            if (rest & 1) {
+                // ~rest has bits set above width so this stops there
+                size_t run = __builtin_ctz(~rest);
+                if (n_free + run >= n_blocks) {
+                    return base + pos - n_free;
+                }
+                n_free += run;
+                pos += run;
+            } else {
+                size_t used = rest == 0 ? width - pos : (size_t)__builtin_ctz(rest);
+                if (base + pos + used > stop_block) {
+                    return GC_NO_BLOCK;
+                }
+                n_free = 0;
+                pos += used;
+            }
+        }
+    }
+    return GC_NO_BLOCK;
+}
+
+// Like gc_find_free_up but scans down from the top of ATB last_atb to the bottom of
+// ATB first_atb, giving up on reaching a used block below stop_block.
+STATIC size_t gc_find_free_down(size_t first_atb, size_t last_atb, size_t n_blocks, size_t stop_block) {
+    size_t n_free = 0;
+    for (size_t top = last_atb + 1; top > first_atb; ) {
+        size_t n_atb = MIN(4, top - first_atb);
+        size_t width = n_atb * BLOCKS_PER_ATB;
+        top -= n_atb;
+        size_t base = top * BLOCKS_PER_ATB;
+        // put the highest block in the top bit
+        uint32_t free_mask = gc_atb_free_mask(top, n_atb) << (32 - width);
+        for (size_t pos = 0; pos < width; ) {
+            uint32_t rest = free_mask << pos;
+            if (rest & 0x80000000) {
+                // ~rest has bits set below width so this stops there
+                size_t run = __builtin_clz(~rest);
+                if (n_free + run >= n_blocks) {
+                    return base + width - pos - (n_blocks - n_free);
+                }
+                n_free += run;
+                pos += run;
+            } else {
+                size_t used = rest == 0 ? width - pos : (size_t)__builtin_clz(rest);
+                if (base + width - pos - used < stop_block) {
+                    return GC_NO_BLOCK;
+                }
+                n_free = 0;
+                pos += used;
+            }
+        }
+    }
+    return GC_NO_BLOCK;
+}
+
 // TODO waste less memory; currently requires that all entries in alloc_table have a corresponding block in pool
 void gc_init(void *start, void *end) {
     // align end pointer on block boundary
@@ -156,6 +324,22 @@ void gc_init(void *start, void *end) {
     MP_STATE_MEM(gc_first_free_atb_index) = 0;
     // Set last free ATB index to the end of the heap.
     MP_STATE_MEM(gc_last_free_atb_index) = MP_STATE_MEM(gc_alloc_table_byte_len) - 1;
+    gc_reset_small_alloc_hints();
+    #if MICROPY_GC_TLAB
+    MP_STATE_MEM(gc_tlab_exhausted) = false;
+    MP_STATE_THREAD(gc_tlab_cur) = NULL;
+    MP_STATE_THREAD(gc_tlab_end) = NULL;
+    #endif
+    #if MICROPY_GC_INCREMENTAL
+    // nothing to sweep yet
+    MP_STATE_MEM(gc_sweep_block) = MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB;
+    MP_STATE_MEM(gc_defer_sweep) = false;
+    MP_STATE_MEM(gc_slice_blocks) = MICROPY_GC_INCREMENTAL_SLICE_BYTES / BYTES_PER_BLOCK;
+    MP_STATE_MEM(gc_max_pause_us) = MICROPY_GC_INCREMENTAL_MAX_PAUSE_US;
+    MP_STATE_MEM(gc_slice_yielding) = false;
+    MP_STATE_MEM(gc_pause_slices) = 0;
+    MP_STATE_MEM(gc_pause_max_us) = 0;
+    #endif
     // Set the lowest long lived ptr to the end of the heap to start. This will be lowered as long
     // lived objects are allocated.
     MP_STATE_MEM(gc_lowest_long_lived_ptr) = (void*) PTR_FROM_BLOCK(MP_STATE_MEM(gc_alloc_table_byte_len * BLOCKS_PER_ATB));
@@ -257,6 +441,7 @@ STATIC void gc_mark_subtree(size_t block) {
                 }
             }
         }
+        GC_SLICE_WORK(n_blocks);
 
         // Are there any blocks on the stack?
         if (sp == 0) {
@@ -282,14 +467,19 @@ STATIC void gc_deal_with_stack_overflow(void) {
     }
 }
 
-STATIC void gc_sweep(void) {
-    #if MICROPY_PY_GC_COLLECT_RETVAL
-    MP_STATE_MEM(gc_collected) = 0;
-    #endif
-    // free unmarked heads and their tails
+// Free unmarked heads and their tails and turn marked heads back into plain
+// heads, starting from block.  Stops at the first block at or after limit that
+// isn't the tail of a chain being freed, and returns it, so that a partial sweep
+// never leaves half a dead chain behind.
+STATIC size_t gc_sweep(size_t block, size_t limit) {
+    size_t first_freed = GC_NO_BLOCK;
     int free_tail = 0;
-    for (size_t block = 0; block < MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB; block++) {
-        switch (ATB_GET_KIND(block)) {
+    for (; block < MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB; block++) {
+        size_t kind = ATB_GET_KIND(block);
+        if (block >= limit && !(free_tail && kind == AT_TAIL)) {
+            break;
+        }
+        switch (kind) {
             case AT_HEAD:
 #if MICROPY_ENABLE_FINALISER
                 if (FTB_GET(block)) {
@@ -313,6 +503,9 @@ STATIC void gc_sweep(void) {
                     FTB_CLEAR(block);
                 }
 #endif
+                if (first_freed == GC_NO_BLOCK) {
+                    first_freed = block;
+                }
                 free_tail = 1;
                 ATB_ANY_TO_FREE(block);
                 #if CLEAR_ON_SWEEP
@@ -343,7 +536,53 @@ STATIC void gc_sweep(void) {
                 break;
         }
     }
+
+    // the allocator may have moved past the blocks freed here
+    if (first_freed != GC_NO_BLOCK) {
+        if (first_freed / BLOCKS_PER_ATB < MP_STATE_MEM(gc_first_free_atb_index)) {
+            MP_STATE_MEM(gc_first_free_atb_index) = first_freed / BLOCKS_PER_ATB;
+        }
+        if ((block - 1) / BLOCKS_PER_ATB > MP_STATE_MEM(gc_last_free_atb_index)) {
+            MP_STATE_MEM(gc_last_free_atb_index) = (block - 1) / BLOCKS_PER_ATB;
+        }
+        gc_lower_small_alloc_hints(first_freed);
+        #if MICROPY_GC_TLAB
+        MP_STATE_MEM(gc_tlab_exhausted) = false;
+        #endif
+    }
+    return block;
+}
+
+#if MICROPY_GC_INCREMENTAL
+// Sweep the next gc_slice_blocks blocks left over from the last collection, or
+// all of them when collecting stop-the-world.  The caller must hold the GC.
+STATIC void gc_sweep_slice(void) {
+    if (!GC_SWEEP_PENDING()) {
+        return;
+    }
+    size_t block = MP_STATE_MEM(gc_sweep_block);
+    size_t limit = MP_STATE_MEM(gc_slice_blocks) == 0 ? GC_NO_BLOCK : block + MP_STATE_MEM(gc_slice_blocks);
+    MP_STATE_MEM(gc_lock_depth)++;
+    gc_slice_begin();
+    MP_STATE_MEM(gc_sweep_block) = gc_sweep(block, limit);
+    gc_slice_end();
+    MP_STATE_MEM(gc_lock_depth)--;
+}
+
+STATIC void gc_sweep_finish(void) {
+    while (GC_SWEEP_PENDING()) {
+        gc_sweep_slice();
+    }
+}
+
+void gc_sweep_step(void) {
+    GC_ENTER();
+    if (MP_STATE_MEM(gc_lock_depth) == 0) {
+        gc_sweep_slice();
+    }
+    GC_EXIT();
 }
+#endif
 
 // Mark can handle NULL pointers because it verifies the pointer is within the heap bounds.
 STATIC void gc_mark(void* ptr) {
@@ -361,6 +600,11 @@ STATIC void gc_mark(void* ptr) {
 void gc_collect_start(void) {
     GC_ENTER();
     MP_STATE_MEM(gc_lock_depth)++;
+    #if MICROPY_GC_INCREMENTAL
+    // heads still marked from the last collection would hide their children
+    gc_sweep_finish();
+    gc_slice_begin();
+    #endif
     #if MICROPY_GC_ALLOC_THRESHOLD
     MP_STATE_MEM(gc_alloc_amount) = 0;
     #endif
@@ -376,6 +620,10 @@ void gc_collect_start(void) {
 
     gc_mark(MP_STATE_MEM(permanent_pointers));
 
+    #if MICROPY_GC_TLAB
+    gc_collect_tlab();
+    #endif
+
     #if MICROPY_ENABLE_PYSTACK
     // Trace root pointers from the Python stack.
     ptrs = (void**)(void*)MP_STATE_THREAD(pystack_start);
@@ -387,6 +635,18 @@ void gc_collect_ptr(void *ptr) {
     gc_mark(ptr);
 }
 
+#if MICROPY_GC_TLAB
+// The heads left in a thread's buffer are unreachable, so they must be marked
+// to stay set aside.  The thread can't take one below gc_tlab_cur as it is read
+// here, and anything it took before is found through its stack if still live.
+void gc_collect_tlab(void) {
+    mp_state_thread_t *ts = gc_tlab_thread();
+    for (byte *ptr = ts->gc_tlab_cur; ptr < ts->gc_tlab_end; ptr += BYTES_PER_BLOCK) {
+        gc_mark(ptr);
+    }
+}
+#endif
+
 void gc_collect_root(void **ptrs, size_t len) {
     for (size_t i = 0; i < len; i++) {
         void *ptr = ptrs[i];
@@ -396,9 +656,27 @@ void gc_collect_root(void **ptrs, size_t len) {
 
 void gc_collect_end(void) {
     gc_deal_with_stack_overflow();
-    gc_sweep();
+    #if MICROPY_PY_GC_COLLECT_RETVAL
+    MP_STATE_MEM(gc_collected) = 0;
+    #endif
+    #if MICROPY_GC_INCREMENTAL
+    MP_STATE_MEM(gc_sweep_block) = 0;
+    if (!MP_STATE_MEM(gc_defer_sweep) || MP_STATE_MEM(gc_slice_blocks) == 0) {
+        while (GC_SWEEP_PENDING()) {
+            size_t block = MP_STATE_MEM(gc_sweep_block);
+            size_t limit = MP_STATE_MEM(gc_slice_blocks) == 0 ? GC_NO_BLOCK : block + MP_STATE_MEM(gc_slice_blocks);
+            MP_STATE_MEM(gc_sweep_block) = gc_sweep(block, limit);
+            GC_SLICE_WORK(MP_STATE_MEM(gc_sweep_block) - block);
+        }
+    }
+    MP_STATE_MEM(gc_defer_sweep) = false;
+    gc_slice_end();
+    #else
+    gc_sweep(0, GC_NO_BLOCK);
+    #endif
     MP_STATE_MEM(gc_first_free_atb_index) = 0;
     MP_STATE_MEM(gc_last_free_atb_index) = MP_STATE_MEM(gc_alloc_table_byte_len) - 1;
+    gc_reset_small_alloc_hints();
     MP_STATE_MEM(gc_lock_depth)--;
     GC_EXIT();
 }
@@ -406,12 +684,27 @@ void gc_collect_end(void) {
 void gc_sweep_all(void) {
     GC_ENTER();
     MP_STATE_MEM(gc_lock_depth)++;
+    #if MICROPY_GC_INCREMENTAL
+    // unmark the heads the last sweep hasn't reached so they are freed too
+    gc_sweep_finish();
+    gc_slice_begin();
+    #endif
     MP_STATE_MEM(gc_stack_overflow) = 0;
+    #if MICROPY_GC_TLAB
+    // the buffer is swept along with everything else
+    MP_STATE_THREAD(gc_tlab_cur) = NULL;
+    MP_STATE_THREAD(gc_tlab_end) = NULL;
+    #endif
     gc_collect_end();
 }
 
 void gc_info(gc_info_t *info) {
     GC_ENTER();
+    #if MICROPY_GC_INCREMENTAL
+    if (MP_STATE_MEM(gc_lock_depth) == 0) {
+        gc_sweep_finish();
+    }
+    #endif
     info->total = MP_STATE_MEM(gc_pool_end) - MP_STATE_MEM(gc_pool_start);
     info->used = 0;
     info->free = 0;
@@ -430,6 +723,7 @@ void gc_info(gc_info_t *info) {
                 break;
 
             case AT_HEAD:
+            case AT_MARK: // not swept yet
                 info->used += 1;
                 len = 1;
                 break;
@@ -438,10 +732,6 @@ void gc_info(gc_info_t *info) {
                 info->used += 1;
                 len += 1;
                 break;
-
-            case AT_MARK:
-                // shouldn't happen
-                break;
         }
 
         block++;
@@ -451,7 +741,7 @@ void gc_info(gc_info_t *info) {
             kind = ATB_GET_KIND(block);
         }
 
-        if (finish || kind == AT_FREE || kind == AT_HEAD) {
+        if (finish || kind != AT_TAIL) {
             if (len == 1) {
                 info->num_1block += 1;
             } else if (len == 2) {
@@ -460,7 +750,7 @@ void gc_info(gc_info_t *info) {
             if (len > info->max_block) {
                 info->max_block = len;
             }
-            if (finish || kind == AT_HEAD) {
+            if (finish || kind != AT_FREE) {
                 if (len_free > info->max_free) {
                     info->max_free = len_free;
                 }
@@ -474,6 +764,66 @@ void gc_info(gc_info_t *info) {
     GC_EXIT();
 }
 
+// Collections triggered by an allocation leave the sweep to later allocations so
+// that their pause ends with the mark.
+STATIC void gc_collect_for_alloc(void) {
+    #if MICROPY_GC_INCREMENTAL
+    MP_STATE_MEM(gc_defer_sweep) = true;
+    #endif
+    gc_collect();
+}
+
+#if MICROPY_GC_TLAB
+// Set aside a run of free blocks for the calling thread, each made a head of
+// its own so that handing one out later needs no change to the allocation
+// table and so no lock.  The run starts at the first free block, however short
+// it is, so that holes are filled from the bottom of the heap just as single
+// block allocations without a buffer fill them.  Never collects to find one:
+// if the heap is that full the thread goes back to allocating through the
+// mutex until blocks are freed.
+STATIC void gc_tlab_refill(mp_state_thread_t *ts) {
+    GC_ENTER();
+    if (MP_STATE_MEM(gc_lock_depth) > 0 || MP_STATE_MEM(gc_tlab_exhausted)
+        #if MICROPY_GC_ALLOC_THRESHOLD
+        || MP_STATE_MEM(gc_alloc_amount) >= MP_STATE_MEM(gc_alloc_threshold)
+        #endif
+        ) {
+        GC_EXIT();
+        return;
+    }
+    size_t stop_block = BLOCK_FROM_PTR(MP_STATE_MEM(gc_lowest_long_lived_ptr));
+    size_t start_block = gc_find_free_up(MP_STATE_MEM(gc_first_free_atb_index) * BLOCKS_PER_ATB,
+        MP_STATE_MEM(gc_last_free_atb_index), 1, stop_block);
+    if (start_block == GC_NO_BLOCK || start_block >= stop_block) {
+        MP_STATE_MEM(gc_tlab_exhausted) = true;
+        GC_EXIT();
+        return;
+    }
+    size_t end_block = MIN(MIN(start_block + MICROPY_GC_TLAB_BLOCKS, stop_block),
+        MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB);
+    size_t n_blocks = 0;
+    for (size_t bl = start_block; bl < end_block && ATB_GET_KIND(bl) == AT_FREE; bl++, n_blocks++) {
+        ATB_FREE_TO_HEAD(bl);
+        #if MICROPY_GC_INCREMENTAL
+        if (bl >= MP_STATE_MEM(gc_sweep_block)) {
+            ATB_HEAD_TO_MARK(bl);
+        }
+        #endif
+    }
+    // nothing is free between the first free block and the end of the buffer
+    MP_STATE_MEM(gc_first_free_atb_index) = (start_block + n_blocks) / BLOCKS_PER_ATB;
+    #if MICROPY_GC_ALLOC_THRESHOLD
+    MP_STATE_MEM(gc_alloc_amount) += n_blocks;
+    #endif
+    byte *ptr = (byte*)PTR_FROM_BLOCK(start_block);
+    // set while holding the GC so no collection can miss the buffer
+    ts->gc_tlab_cur = ptr;
+    ts->gc_tlab_end = ptr + n_blocks * BYTES_PER_BLOCK;
+    GC_EXIT();
+    memset(ptr, 0, n_blocks * BYTES_PER_BLOCK);
+}
+#endif
+
 // We place long lived objects at the end of the heap rather than the start. This reduces
 // fragmentation by localizing the heap churn to one portion of memory (the start of the heap.)
 void *gc_alloc(size_t n_bytes, bool has_finaliser, bool long_lived) {
@@ -489,104 +839,123 @@ void *gc_alloc(size_t n_bytes, bool has_finaliser, bool long_lived) {
         reset_into_safe_mode(GC_ALLOC_OUTSIDE_VM);
     }
 
+    #if MICROPY_GC_TLAB
+    if (n_blocks == 1 && !has_finaliser && !long_lived) {
+        mp_state_thread_t *ts = gc_tlab_thread();
+        if (ts->gc_tlab_cur == ts->gc_tlab_end && !MP_STATE_MEM(gc_tlab_exhausted)) {
+            gc_tlab_refill(ts);
+        }
+        // A locked heap (which includes one being collected) must go through
+        // the mutex, but the buffer itself is safe to use at any point.
+        byte *ptr = ts->gc_tlab_cur;
+        if (ptr < ts->gc_tlab_end && MP_STATE_MEM(gc_lock_depth) == 0) {
+            ts->gc_tlab_cur = ptr + BYTES_PER_BLOCK;
+            return ptr;
+        }
+    }
+    #endif
+
     GC_ENTER();
 
     // check if GC is locked
     if (MP_STATE_MEM(gc_lock_depth) > 0) {
+        #if MICROPY_GC_INCREMENTAL
+        // The heap is mid-collection, so this allocation would fail.
+        assert(!MP_STATE_MEM(gc_slice_yielding));
+        #endif
         GC_EXIT();
         return NULL;
     }
 
-    size_t found_block = 0xffffffff;
-    size_t end_block;
     size_t start_block;
-    size_t n_free;
     bool collected = !MP_STATE_MEM(gc_auto_collect_enabled);
 
     #if MICROPY_GC_ALLOC_THRESHOLD
     if (!collected && MP_STATE_MEM(gc_alloc_amount) >= MP_STATE_MEM(gc_alloc_threshold)) {
         GC_EXIT();
-        gc_collect();
+        gc_collect_for_alloc();
         collected = 1;
         GC_ENTER();
         collected = true;
     }
     #endif
 
-    bool keep_looking = true;
-
     // When we start searching on the other side of the crossover block we make sure to
     // perform a collect. That way we'll get the closest free block in our section.
     size_t crossover_block = BLOCK_FROM_PTR(MP_STATE_MEM(gc_lowest_long_lived_ptr));
-    while (keep_looking) {
-        int8_t direction = 1;
-        size_t start = MP_STATE_MEM(gc_first_free_atb_index);
-        if (long_lived) {
-            direction = -1;
-            start = MP_STATE_MEM(gc_last_free_atb_index);
-        }
-        n_free = 0;
+    // Only blocks from search_lo up to search_hi can have been freed since the last search.
+    size_t search_lo = 0;
+    size_t search_hi = GC_NO_BLOCK;
+    for (;;) {
         // look for a run of n_blocks available blocks
-        for (size_t i = start; keep_looking && MP_STATE_MEM(gc_first_free_atb_index) <= i && i <= MP_STATE_MEM(gc_last_free_atb_index); i += direction) {
-            byte a = MP_STATE_MEM(gc_alloc_table_start)[i];
-            // Four ATB states are packed into a single byte.
-            int j = 0;
-            if (direction == -1) {
-                j = 3;
-            }
-            for (; keep_looking && 0 <= j && j <= 3; j += direction) {
-                if ((a & (0x3 << (j * 2))) == 0) {
-                    if (++n_free >= n_blocks) {
-                        found_block = i * BLOCKS_PER_ATB + j;
-                        keep_looking = false;
-                    }
-                } else {
-                    if (!collected) {
-                        size_t block = i * BLOCKS_PER_ATB + j;
-                        if ((direction == 1 && block >= crossover_block) ||
-                                (direction == -1 && block < crossover_block)) {
-                            keep_looking = false;
-                        }
-                    }
-                    n_free = 0;
+        if (!long_lived) {
+            size_t start = MP_STATE_MEM(gc_first_free_atb_index) * BLOCKS_PER_ATB;
+            // Small allocations can start from where the last one of the same size
+            // left off, but not past the crossover so we still collect before it.
+            if (n_blocks <= GC_SMALL_ALLOC_HINTS) {
+                size_t hint = MP_STATE_MEM(gc_small_alloc_hint)[n_blocks - 1];
+                if (!collected && hint > crossover_block) {
+                    hint = crossover_block;
+                }
+                if (hint > start) {
+                    start = hint;
                 }
             }
+            start_block = gc_find_free_up(MAX(start, search_lo), MP_STATE_MEM(gc_last_free_atb_index), n_blocks,
+                MIN(collected ? GC_NO_BLOCK : crossover_block, search_hi));
+        } else {
+            start_block = gc_find_free_down(MP_STATE_MEM(gc_first_free_atb_index),
+                MIN(MP_STATE_MEM(gc_last_free_atb_index), ATB_FROM_BLOCK(search_hi)), n_blocks,
+                MAX(collected ? 0 : crossover_block, search_lo));
         }
-        if (n_free >= n_blocks) {
+        if (start_block != GC_NO_BLOCK) {
             break;
         }
 
+        #if MICROPY_GC_INCREMENTAL
+        if (GC_SWEEP_PENDING()) {
+            // Reclaim more of what the last collection found before starting
+            // another.  Any new run must take in some of the blocks just swept.
+            size_t block = MP_STATE_MEM(gc_sweep_block);
+            gc_sweep_slice();
+            search_lo = block > n_blocks ? block - n_blocks : 0;
+            search_hi = MP_STATE_MEM(gc_sweep_block) + n_blocks;
+            continue;
+        }
+        #endif
+
         GC_EXIT();
         // nothing found!
         if (collected) {
             return NULL;
         }
         DEBUG_printf("gc_alloc(" UINT_FMT "): no free mem, triggering GC\n", n_bytes);
-        gc_collect();
+        gc_collect_for_alloc();
         collected = true;
+        search_lo = 0;
+        search_hi = GC_NO_BLOCK;
         // Try again since we've hopefully freed up space.
-        keep_looking = true;
         GC_ENTER();
     }
-    assert(found_block != 0xffffffff);
+    size_t end_block = start_block + n_blocks - 1;
 
-    // Found free space ending at found_block inclusive.
-    // Also, set last free ATB index to block after last block we found, for start of
-    // next scan.  To reduce fragmentation, we only do this if we were looking
+    // Found free space from start_block to end_block inclusive.
+    // Also, set first/last free ATB index to block after last block we found, for start
+    // of next scan.  To reduce fragmentation, we only do this if we were looking
     // for a single free block, which guarantees that there are no free blocks
     // before this one.  Also, whenever we free or shrink a block we must check
     // if this index needs adjusting (see gc_realloc and gc_free).
     if (!long_lived) {
-        end_block = found_block;
-        start_block = found_block - n_free + 1;
         if (n_blocks == 1) {
-            MP_STATE_MEM(gc_first_free_atb_index) = (found_block + 1) / BLOCKS_PER_ATB;
+            MP_STATE_MEM(gc_first_free_atb_index) = (end_block + 1) / BLOCKS_PER_ATB;
+        }
+        // there is no run of n_blocks free blocks before this one
+        if (n_blocks <= GC_SMALL_ALLOC_HINTS) {
+            MP_STATE_MEM(gc_small_alloc_hint)[n_blocks - 1] = end_block + 1;
         }
     } else {
-        start_block = found_block;
-        end_block = found_block + n_free - 1;
         if (n_blocks == 1) {
-            MP_STATE_MEM(gc_last_free_atb_index) = (found_block - 1) / BLOCKS_PER_ATB;
+            MP_STATE_MEM(gc_last_free_atb_index) = (start_block - 1) / BLOCKS_PER_ATB;
         }
     }
 
@@ -596,6 +965,12 @@ void *gc_alloc(size_t n_bytes, bool has_finaliser, bool long_lived) {
 
     // mark first block as used head
     ATB_FREE_TO_HEAD(start_block);
+    #if MICROPY_GC_INCREMENTAL
+    if (start_block >= MP_STATE_MEM(gc_sweep_block)) {
+        // the pending sweep hasn't reached it, so it must look live
+        ATB_HEAD_TO_MARK(start_block);
+    }
+    #endif
 
     // mark rest of blocks as used tail
     // TODO for a run of many blocks can make this more efficient
@@ -681,7 +1056,7 @@ void gc_free(void *ptr) {
         // get the GC block number corresponding to this pointer
         assert(VERIFY_PTR(ptr));
         size_t block = BLOCK_FROM_PTR(ptr);
-        assert(ATB_GET_KIND(block) == AT_HEAD);
+        assert(ATB_GET_KIND(block) == AT_HEAD || ATB_GET_KIND(block) == AT_MARK);
 
         #if MICROPY_ENABLE_FINALISER
         FTB_CLEAR(block);
@@ -694,6 +1069,7 @@ void gc_free(void *ptr) {
         if (block / BLOCKS_PER_ATB > MP_STATE_MEM(gc_last_free_atb_index)) {
             MP_STATE_MEM(gc_last_free_atb_index) = block / BLOCKS_PER_ATB;
         }
+        gc_lower_small_alloc_hints(block);
 
         // free head and all of its tail blocks
             #ifdef LOG_HEAP_ACTIVITY
@@ -716,7 +1092,8 @@ size_t gc_nbytes(const void *ptr) {
     GC_ENTER();
     if (VERIFY_PTR(ptr)) {
         size_t block = BLOCK_FROM_PTR(ptr);
-        if (ATB_GET_KIND(block) == AT_HEAD) {
+        // a marked head is live but not swept yet
+        if (ATB_GET_KIND(block) == AT_HEAD || ATB_GET_KIND(block) == AT_MARK) {
             // work out number of consecutive blocks in the chain starting with this on
             size_t n_blocks = 0;
             do {
@@ -829,7 +1206,7 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     // get the GC block number corresponding to this pointer
     assert(VERIFY_PTR(ptr));
     size_t block = BLOCK_FROM_PTR(ptr);
-    assert(ATB_GET_KIND(block) == AT_HEAD);
+    assert(ATB_GET_KIND(block) == AT_HEAD || ATB_GET_KIND(block) == AT_MARK);
 
     // compute number of new blocks that are requested
     size_t new_blocks = (n_bytes + BYTES_PER_BLOCK - 1) / BYTES_PER_BLOCK;
@@ -880,6 +1257,7 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
         if ((block + new_blocks) / BLOCKS_PER_ATB > MP_STATE_MEM(gc_last_free_atb_index)) {
             MP_STATE_MEM(gc_last_free_atb_index) = (block + new_blocks) / BLOCKS_PER_ATB;
         }
+        gc_lower_small_alloc_hints(block + new_blocks);
 
         GC_EXIT();
 
@@ -981,6 +1359,316 @@ bool gc_never_free(void *ptr) {
     return true;
 }
 
+#if MICROPY_GC_SNAPSHOT
+// A heap snapshot holds the allocations that the walk of gc_long_lived.c
+// reached from the snapshot roots, with their allocation table bytes and a
+// map with a bit for each of their words that holds a pointer.  Allocations
+// at the bottom of the pool and the long-lived ones at the top are put back
+// at the bottom and the top of the pool, which may be a different size, so
+// each part is relocated on its own.  Finaliser bits are not kept: objects
+// with finalisers hold things outside the heap that don't survive a restart.
+#define GC_SNAPSHOT_MAP_LEN(n_blocks) (((n_blocks) * WORDS_PER_BLOCK + 7) / 8)
+
+size_t gc_snapshot_ptr_map_len(void) {
+    return GC_SNAPSHOT_MAP_LEN(MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB);
+}
+
+// The caller must hold the heap lock until gc_snapshot_walk_end, so that the
+// heap doesn't change while the walk marks the allocations that it reaches.
+// ptr_map must have room for gc_snapshot_ptr_map_len bytes.
+void gc_snapshot_walk_begin(gc_snapshot_walk_t *w, byte *ptr_map) {
+    GC_ENTER();
+    #if MICROPY_GC_INCREMENTAL
+    gc_sweep_finish();
+    #endif
+    gc_snapshot_extent_t *ext = &w->ext;
+    ext->pool_start = (uintptr_t)MP_STATE_MEM(gc_pool_start);
+    ext->n_blocks = MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB;
+    // both parts are whole allocation table bytes
+    size_t high = BLOCK_FROM_PTR(MP_STATE_MEM(gc_lowest_long_lived_ptr)) / BLOCKS_PER_ATB * BLOCKS_PER_ATB;
+    // and no allocation is split between them
+    while (high > 0 && high < ext->n_blocks && ATB_GET_KIND(high) == AT_TAIL) {
+        high -= BLOCKS_PER_ATB;
+    }
+    size_t low = high;
+    while (low > 0 && ATB_GET_KIND(low - 1) == AT_FREE) {
+        low--;
+    }
+    ext->n_low = (low + BLOCKS_PER_ATB - 1) / BLOCKS_PER_ATB * BLOCKS_PER_ATB;
+    ext->n_high = ext->n_blocks - high;
+    GC_EXIT();
+    w->ptr_map = ptr_map;
+    memset(ptr_map, 0, GC_SNAPSHOT_MAP_LEN(ext->n_low + ext->n_high));
+}
+
+// Mark the allocation that starts at ptr, or that ptr points into if interior
+// is true, as held by the snapshot.  Returns false if there is no such
+// allocation in the heap or it is already held.
+bool gc_snapshot_walk_visit(const void *ptr, bool interior) {
+    if (ptr < (void*)MP_STATE_MEM(gc_pool_start) || ptr >= (void*)MP_STATE_MEM(gc_pool_end)) {
+        return false;
+    }
+    if (!interior && !VERIFY_PTR(ptr)) {
+        return false;
+    }
+    bool visited = false;
+    GC_ENTER();
+    size_t block = BLOCK_FROM_PTR(ptr);
+    while (interior && block > 0 && ATB_GET_KIND(block) == AT_TAIL) {
+        block--;
+    }
+    if (ATB_GET_KIND(block) == AT_HEAD) {
+        ATB_HEAD_TO_MARK(block);
+        visited = true;
+    }
+    GC_EXIT();
+    return visited;
+}
+
+// Note that the word at field holds a pointer, if the snapshot holds it.
+void gc_snapshot_walk_ptr(gc_snapshot_walk_t *w, const void *field) {
+    if (field < (void*)MP_STATE_MEM(gc_pool_start) || field >= (void*)MP_STATE_MEM(gc_pool_end)) {
+        return;
+    }
+    size_t word = ((const byte*)field - MP_STATE_MEM(gc_pool_start)) / BYTES_PER_WORD;
+    size_t high_word = (w->ext.n_blocks - w->ext.n_high) * WORDS_PER_BLOCK;
+    if (word >= high_word) {
+        word = word - high_word + w->ext.n_low * WORDS_PER_BLOCK;
+    } else if (word >= w->ext.n_low * WORDS_PER_BLOCK) {
+        return;
+    }
+    w->ptr_map[word / 8] |= 1 << (word & 7);
+}
+
+void gc_snapshot_walk_end(void) {
+    GC_ENTER();
+    size_t n_blocks = MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB;
+    for (size_t block = 0; block < n_blocks; block++) {
+        if (ATB_GET_KIND(block) == AT_MARK) {
+            ATB_MARK_TO_HEAD(block);
+        }
+    }
+    GC_EXIT();
+}
+
+// Whether the snapshot holds block, given whether it holds the one before.
+STATIC bool gc_snapshot_holds(size_t block, bool prev_held) {
+    int kind = ATB_GET_KIND(block);
+    return kind == AT_MARK || (kind == AT_TAIL && prev_held);
+}
+
+// Allocations that the walk didn't reach are saved as free blocks.
+STATIC void gc_snapshot_save_atb(const mp_print_t *print, size_t block, size_t end) {
+    byte buf[32];
+    size_t n = 0;
+    bool held = false;
+    while (block < end) {
+        byte atb = 0;
+        for (size_t i = 0; i < BLOCKS_PER_ATB; i++, block++) {
+            held = gc_snapshot_holds(block, held);
+            if (held) {
+                atb |= (ATB_GET_KIND(block) == AT_MARK ? AT_HEAD : AT_TAIL) << BLOCK_SHIFT(block);
+            }
+        }
+        buf[n++] = atb;
+        if (n == sizeof(buf) || block == end) {
+            print->print_strn(print->data, (const char*)buf, n);
+            n = 0;
+        }
+    }
+}
+
+STATIC void gc_snapshot_save_blocks(const mp_print_t *print, size_t block, size_t end) {
+    bool held = false;
+    while (block < end) {
+        held = gc_snapshot_holds(block, held);
+        if (!held) {
+            block++;
+            continue;
+        }
+        size_t run = block + 1;
+        while (run < end && ATB_GET_KIND(run) == AT_TAIL) {
+            run++;
+        }
+        print->print_strn(print->data, (const char*)PTR_FROM_BLOCK(block), (run - block) * BYTES_PER_BLOCK);
+        block = run;
+    }
+}
+
+STATIC size_t gc_snapshot_count_held(size_t block, size_t end) {
+    size_t n = 0;
+    bool held = false;
+    for (; block < end; block++) {
+        held = gc_snapshot_holds(block, held);
+        n += held;
+    }
+    return n;
+}
+
+// Write out the allocations marked by the walk, before it ends.  The caller
+// holds the heap lock so that writing doesn't change the heap.  The map of
+// pointers goes last so that it can be read in pieces once the blocks are in
+// place.
+void gc_snapshot_save_heap(const mp_print_t *print, const gc_snapshot_walk_t *w) {
+    gc_snapshot_extent_t ext = w->ext;
+    size_t high = ext.n_blocks - ext.n_high;
+    ext.n_used = gc_snapshot_count_held(0, ext.n_low) + gc_snapshot_count_held(high, ext.n_blocks);
+    print->print_strn(print->data, (const char*)&ext, sizeof(ext));
+    gc_snapshot_save_atb(print, 0, ext.n_low);
+    gc_snapshot_save_atb(print, high, ext.n_blocks);
+    gc_snapshot_save_blocks(print, 0, ext.n_low);
+    gc_snapshot_save_blocks(print, high, ext.n_blocks);
+    print->print_strn(print->data, (const char*)w->ptr_map, GC_SNAPSHOT_MAP_LEN(ext.n_low + ext.n_high));
+}
+
+STATIC size_t gc_snapshot_count_used(size_t block, size_t end) {
+    size_t n = 0;
+    for (; block < end; block++) {
+        if (ATB_GET_KIND(block) != AT_FREE) {
+            n++;
+        }
+    }
+    return n;
+}
+
+STATIC bool gc_snapshot_load_blocks(const gc_snapshot_reader_t *reader, size_t block, size_t end) {
+    while (block < end) {
+        if (ATB_GET_KIND(block) == AT_FREE) {
+            block++;
+            continue;
+        }
+        size_t run = block;
+        while (run < end && ATB_GET_KIND(run) != AT_FREE) {
+            run++;
+        }
+        if (!reader->read(reader->data, (void*)PTR_FROM_BLOCK(block), (run - block) * BYTES_PER_BLOCK)) {
+            return false;
+        }
+        block = run;
+    }
+    return true;
+}
+
+STATIC void gc_snapshot_add_reloc(gc_snapshot_reloc_t *reloc, uintptr_t start, uintptr_t end, uintptr_t new_start) {
+    if (start != new_start && start != end) {
+        reloc->range[reloc->n].start = start;
+        reloc->range[reloc->n].end = end;
+        reloc->range[reloc->n].delta = new_start - start;
+        reloc->n++;
+    }
+}
+
+// Only the words that the map says hold pointers are moved.
+STATIC bool gc_snapshot_load_ptr_map(const gc_snapshot_reader_t *reader, size_t map_len, size_t n_low, size_t high, const gc_snapshot_reloc_t *reloc) {
+    byte map[32];
+    size_t n_low_words = n_low * WORDS_PER_BLOCK;
+    for (size_t i = 0; i < map_len; i += sizeof(map)) {
+        size_t n = MIN(sizeof(map), map_len - i);
+        if (!reader->read(reader->data, map, n)) {
+            return false;
+        }
+        for (size_t j = 0; j < n; j++) {
+            for (size_t bit = 0; map[j] >> bit != 0; bit++) {
+                if ((map[j] >> bit) & 1) {
+                    size_t word = (i + j) * 8 + bit;
+                    void **ptr = word < n_low_words
+                        ? (void**)PTR_FROM_BLOCK(0) + word
+                        : (void**)PTR_FROM_BLOCK(high) + (word - n_low_words);
+                    gc_snapshot_relocate(reloc, ptr, 1);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Replace the contents of the heap with the len bytes of a snapshot that
+// reader gives, moving pointers out of the ranges in reloc and out of the
+// saved heap.  The sizes of the parts are checked against len before the heap
+// is changed, and everything is read straight into place.  Objects allocated
+// before are lost.
+gc_snapshot_result_t gc_snapshot_load_heap(const gc_snapshot_reader_t *reader, size_t len, gc_snapshot_reloc_t *reloc) {
+    gc_snapshot_extent_t ext;
+    if (len < sizeof(ext) || !reader->read(reader->data, &ext, sizeof(ext))) {
+        return GC_SNAPSHOT_REJECTED;
+    }
+    len -= sizeof(ext);
+    size_t n_blocks = MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB;
+    if (ext.n_low % BLOCKS_PER_ATB != 0 || ext.n_high % BLOCKS_PER_ATB != 0
+        || ext.n_low > n_blocks || ext.n_high > n_blocks - ext.n_low
+        || ext.n_low + ext.n_high > ext.n_blocks || ext.n_used > ext.n_low + ext.n_high) {
+        return GC_SNAPSHOT_REJECTED;
+    }
+    size_t n_low_atb = ext.n_low / BLOCKS_PER_ATB;
+    size_t n_high_atb = ext.n_high / BLOCKS_PER_ATB;
+    size_t map_len = GC_SNAPSHOT_MAP_LEN(ext.n_low + ext.n_high);
+    if (len != n_low_atb + n_high_atb + ext.n_used * BYTES_PER_BLOCK + map_len) {
+        return GC_SNAPSHOT_REJECTED;
+    }
+
+    GC_ENTER();
+    size_t high = n_blocks - ext.n_high;
+    byte *atb = MP_STATE_MEM(gc_alloc_table_start);
+    memset(atb, 0, MP_STATE_MEM(gc_alloc_table_byte_len));
+    #if MICROPY_ENABLE_FINALISER
+    memset(MP_STATE_MEM(gc_finaliser_table_start), 0, (MP_STATE_MEM(gc_alloc_table_byte_len) * BLOCKS_PER_ATB + BLOCKS_PER_FTB - 1) / BLOCKS_PER_FTB);
+    #endif
+    bool ok = reader->read(reader->data, atb, n_low_atb)
+        && reader->read(reader->data, atb + high / BLOCKS_PER_ATB, n_high_atb)
+        && gc_snapshot_count_used(0, ext.n_low) + gc_snapshot_count_used(high, n_blocks) == ext.n_used
+        && gc_snapshot_load_blocks(reader, 0, ext.n_low)
+        && gc_snapshot_load_blocks(reader, high, n_blocks);
+    if (ok) {
+        uintptr_t old_high = ext.pool_start + (ext.n_blocks - ext.n_high) * BYTES_PER_BLOCK;
+        gc_snapshot_add_reloc(reloc, ext.pool_start, ext.pool_start + ext.n_low * BYTES_PER_BLOCK, PTR_FROM_BLOCK(0));
+        gc_snapshot_add_reloc(reloc, old_high, old_high + ext.n_high * BYTES_PER_BLOCK, PTR_FROM_BLOCK(high));
+        ok = reloc->n == 0 || gc_snapshot_load_ptr_map(reader, map_len, ext.n_low, high, reloc);
+    }
+    if (!ok) {
+        // what has been read is no use, so leave the heap empty
+        memset(atb, 0, MP_STATE_MEM(gc_alloc_table_byte_len));
+        high = n_blocks;
+    }
+
+    // the rest is as after gc_init
+    MP_STATE_MEM(gc_first_free_atb_index) = 0;
+    MP_STATE_MEM(gc_last_free_atb_index) = MP_STATE_MEM(gc_alloc_table_byte_len) - 1;
+    gc_reset_small_alloc_hints();
+    #if MICROPY_GC_TLAB
+    MP_STATE_MEM(gc_tlab_exhausted) = false;
+    MP_STATE_THREAD(gc_tlab_cur) = NULL;
+    MP_STATE_THREAD(gc_tlab_end) = NULL;
+    #endif
+    #if MICROPY_GC_INCREMENTAL
+    MP_STATE_MEM(gc_sweep_block) = n_blocks;
+    MP_STATE_MEM(gc_defer_sweep) = false;
+    #endif
+    #if MICROPY_GC_ALLOC_THRESHOLD
+    MP_STATE_MEM(gc_alloc_amount) = 0;
+    #endif
+    MP_STATE_MEM(gc_lowest_long_lived_ptr) = (void*)PTR_FROM_BLOCK(high);
+    GC_EXIT();
+    return ok ? GC_SNAPSHOT_LOADED : GC_SNAPSHOT_READ_FAILED;
+}
+
+// Moves each of the pointers that is in one of the ranges.  Nothing is moved
+// when the heap and image haven't.
+void gc_snapshot_relocate(const gc_snapshot_reloc_t *reloc, void **ptrs, size_t len) {
+    if (reloc->n == 0) {
+        return;
+    }
+    for (size_t i = 0; i < len; i++) {
+        uintptr_t p = (uintptr_t)ptrs[i];
+        for (size_t r = 0; r < reloc->n; r++) {
+            if (p >= reloc->range[r].start && p < reloc->range[r].end) {
+                ptrs[i] = (void*)(p + reloc->range[r].delta);
+                break;
+            }
+        }
+    }
+}
+#endif
+
 void gc_dump_info(void) {
     gc_info_t info;
     gc_info(&info);
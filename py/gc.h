@@ -30,6 +30,7 @@
 
 #include "py/mpconfig.h"
 #include "py/misc.h"
+#include "py/mpprint.h"
 
 void gc_init(void *start, void *end);
 void gc_deinit(void);
@@ -47,11 +48,22 @@ void gc_collect_ptr(void *ptr);
 void gc_collect_root(void **ptrs, size_t len);
 void gc_collect_end(void);
 
+#if MICROPY_GC_TLAB
+// Mark the calling thread's unused allocation buffer; call it while the thread
+// is held for its stack to be scanned.
+void gc_collect_tlab(void);
+#endif
+
 void *gc_alloc(size_t n_bytes, bool has_finaliser, bool long_lived);
 
 // Use this function to sweep the whole heap and run all finalisers
 void gc_sweep_all(void);
 
+#if MICROPY_GC_INCREMENTAL
+// Sweep a slice of the heap left over from an automatic collection.
+void gc_sweep_step(void);
+#endif
+
 void gc_free(void *ptr); // does not call finaliser
 size_t gc_nbytes(const void *ptr);
 bool gc_has_finaliser(const void *ptr);
@@ -72,6 +84,59 @@ typedef struct _gc_info_t {
     size_t max_block;
 } gc_info_t;
 
+#if MICROPY_GC_SNAPSHOT
+// Address ranges that pointers restored from a heap snapshot are moved out of.
+typedef struct _gc_snapshot_reloc_t {
+    size_t n;
+    struct {
+        uintptr_t start;
+        uintptr_t end;
+        intptr_t delta;
+    } range[3];
+} gc_snapshot_reloc_t;
+
+// The part of the heap that a snapshot holds: the blocks at the bottom of the
+// pool and the long-lived ones at the top.
+typedef struct _gc_snapshot_extent_t {
+    uintptr_t pool_start;
+    size_t n_blocks;
+    size_t n_low;
+    size_t n_high;
+    // blocks of those that are in use
+    size_t n_used;
+} gc_snapshot_extent_t;
+
+// Where a snapshot is restored from.  read fills buf with the next len bytes,
+// and returns false if it can't.
+typedef struct _gc_snapshot_reader_t {
+    void *data;
+    bool (*read)(void *data, void *buf, size_t len);
+} gc_snapshot_reader_t;
+
+typedef enum _gc_snapshot_result_t {
+    GC_SNAPSHOT_LOADED,
+    // the snapshot is from another build or doesn't fit, and nothing changed
+    GC_SNAPSHOT_REJECTED,
+    // the snapshot couldn't be read to the end, so the heap is lost and the
+    // VM has to be started again
+    GC_SNAPSHOT_READ_FAILED,
+} gc_snapshot_result_t;
+
+typedef struct _gc_snapshot_walk_t {
+    gc_snapshot_extent_t ext;
+    byte *ptr_map;
+} gc_snapshot_walk_t;
+
+size_t gc_snapshot_ptr_map_len(void);
+void gc_snapshot_walk_begin(gc_snapshot_walk_t *w, byte *ptr_map);
+bool gc_snapshot_walk_visit(const void *ptr, bool interior);
+void gc_snapshot_walk_ptr(gc_snapshot_walk_t *w, const void *field);
+void gc_snapshot_walk_end(void);
+void gc_snapshot_save_heap(const mp_print_t *print, const gc_snapshot_walk_t *w);
+gc_snapshot_result_t gc_snapshot_load_heap(const gc_snapshot_reader_t *reader, size_t len, gc_snapshot_reloc_t *reloc);
+void gc_snapshot_relocate(const gc_snapshot_reloc_t *reloc, void **ptrs, size_t len);
+#endif
+
 void gc_info(gc_info_t *info);
 void gc_dump_info(void);
 void gc_dump_alloc_table(void);
@@ -48,17 +48,22 @@ mp_obj_fun_bc_t *make_fun_bc_long_lived(mp_obj_fun_bc_t *fun_bc, uint8_t max_dep
         if (raw_code->kind == MP_CODE_BYTECODE) {
             raw_code->data.u_byte.bytecode = gc_make_long_lived((byte*) raw_code->data.u_byte.bytecode);
             raw_code->data.u_byte.const_table = gc_make_long_lived((byte*) raw_code->data.u_byte.const_table);
+            #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+            raw_code->data.u_byte.qstr_link = gc_make_long_lived((uint16_t*) raw_code->data.u_byte.qstr_link);
+            #endif
         }
         ((mp_uint_t *) fun_bc->const_table)[i] = (mp_uint_t) make_obj_long_lived(
             (mp_obj_t) fun_bc->const_table[i], max_depth - 1);
 
     }
     fun_bc->const_table = gc_make_long_lived((mp_uint_t*) fun_bc->const_table);
+    #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+    fun_bc->qstr_link = gc_make_long_lived((uint16_t*) fun_bc->qstr_link);
+    #endif
     // extra_args stores keyword only argument default values.
-    size_t words = gc_nbytes(fun_bc) / sizeof(mp_uint_t*);
-    // Functions (mp_obj_fun_bc_t) have four pointers (base, globals, bytecode and const_table)
-    // before the variable length extra_args so remove them from the length.
-    for (size_t i = 0; i < words - 4; i++) {
+    // Skip the fixed fields (base, globals, bytecode, ...) before the variable length extra_args.
+    size_t words = (gc_nbytes(fun_bc) - offsetof(mp_obj_fun_bc_t, extra_args)) / sizeof(mp_uint_t*);
+    for (size_t i = 0; i < words; i++) {
         if (fun_bc->extra_args[i] == NULL) {
             continue;
         }
@@ -142,3 +147,504 @@ mp_obj_t make_obj_long_lived(mp_obj_t obj, uint8_t max_depth){
         return gc_make_long_lived(obj);
     }
 }
+
+#if MICROPY_GC_SNAPSHOT
+
+#include <string.h>
+
+#include "py/bc.h"
+#include "py/bc0.h"
+#include "py/nlr.h"
+#include "py/objarray.h"
+#include "py/objexcept.h"
+#include "py/objint.h"
+#include "py/objlist.h"
+#include "py/objnamedtuple.h"
+#include "py/objtype.h"
+#include "py/runtime.h"
+#include "py/stackctrl.h"
+
+#include "supervisor/shared/translate.h"
+
+// The walk below finds the constant objects of bytecode by their index, so
+// bytecode mustn't hold pointers itself.
+#if !MICROPY_PERSISTENT_CODE
+#error "MICROPY_GC_SNAPSHOT requires MICROPY_PERSISTENT_CODE"
+#endif
+
+// A snapshot is a header, the roots below and the heap (see
+// gc_snapshot_save_heap).  It can only be restored by the same build, which is
+// checked by the offsets of a few symbols into the image.  If the port gives
+// the bounds of the image then it may be loaded at another address, otherwise
+// everything outside the heap must be where it was.
+#define GC_SNAPSHOT_MAGIC (0x70616e73) // "snap"
+#define GC_SNAPSHOT_VERSION (3)
+
+#ifdef MICROPY_GC_SNAPSHOT_IMAGE_START
+#define GC_SNAPSHOT_IMAGE_START ((uintptr_t)(MICROPY_GC_SNAPSHOT_IMAGE_START))
+#define GC_SNAPSHOT_IMAGE_END ((uintptr_t)(MICROPY_GC_SNAPSHOT_IMAGE_END))
+#else
+#define GC_SNAPSHOT_IMAGE_START ((uintptr_t)0)
+#define GC_SNAPSHOT_IMAGE_END ((uintptr_t)0)
+#endif
+
+typedef struct _gc_snapshot_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t bytes_per_block;
+    size_t state_size;
+    uintptr_t image_start;
+    uintptr_t image_end;
+    uintptr_t markers[3];
+} gc_snapshot_header_t;
+
+// Everything outside the heap that the loaded modules and interned strings
+// are reached from.  Port root pointers aren't kept.
+typedef struct _gc_snapshot_roots_t {
+    qstr_pool_t *last_pool;
+    byte *qstr_last_chunk;
+    size_t qstr_last_alloc;
+    size_t qstr_last_used;
+    #if MICROPY_QSTR_HASH_INDEX
+    uint16_t *qstr_index;
+    size_t qstr_index_alloc;
+    size_t qstr_index_top;
+    #endif
+    mp_obj_dict_t loaded_modules_dict;
+    #if MICROPY_CAN_OVERRIDE_BUILTINS
+    mp_obj_dict_t *builtins_override_dict;
+    #endif
+    void **permanent_pointers;
+} gc_snapshot_roots_t;
+
+STATIC void gc_snapshot_make_header(gc_snapshot_header_t *header) {
+    memset(header, 0, sizeof(*header));
+    header->magic = GC_SNAPSHOT_MAGIC;
+    header->version = GC_SNAPSHOT_VERSION;
+    header->bytes_per_block = MICROPY_BYTES_PER_GC_BLOCK;
+    header->state_size = sizeof(mp_state_ctx_t);
+    header->image_start = GC_SNAPSHOT_IMAGE_START;
+    header->image_end = GC_SNAPSHOT_IMAGE_END;
+    header->markers[0] = (uintptr_t)&mp_type_type - header->image_start;
+    header->markers[1] = (uintptr_t)&mp_state_ctx - header->image_start;
+    header->markers[2] = (uintptr_t)&gc_snapshot_make_header - header->image_start;
+}
+
+// Only the heap reached from the roots is saved, and only the words that the
+// walk knows to be pointers are moved when it is restored, so that raw data
+// is left alone.  Objects of a type that the walk doesn't know, and native
+// code, which is outside the heap, can't be saved.
+typedef struct _gc_snapshot_walker_t {
+    gc_snapshot_walk_t heap;
+    // why the heap can't be saved, if it can't
+    const compressed_string_t *error;
+    qstr error_arg;
+} gc_snapshot_walker_t;
+
+STATIC void gc_snapshot_refuse(gc_snapshot_walker_t *w, const compressed_string_t *error, qstr arg) {
+    if (w->error == NULL) {
+        w->error = error;
+        w->error_arg = arg;
+    }
+}
+
+// A pointer to raw data, which may point into its allocation.
+STATIC void gc_snapshot_walk_data(gc_snapshot_walker_t *w, const void *field) {
+    gc_snapshot_walk_ptr(&w->heap, field);
+    gc_snapshot_walk_visit(*(void *const *)field, true);
+}
+
+// A pointer to an array whose elements are walked by the caller, if this
+// returns true, as it does the first time the array is reached.
+STATIC bool gc_snapshot_walk_array(gc_snapshot_walker_t *w, const void *field) {
+    gc_snapshot_walk_ptr(&w->heap, field);
+    return gc_snapshot_walk_visit(*(void *const *)field, false);
+}
+
+STATIC void gc_snapshot_walk_fields(gc_snapshot_walker_t *w, mp_obj_base_t *o);
+
+STATIC void gc_snapshot_walk_objs(gc_snapshot_walker_t *w, const mp_obj_t *slots, size_t n) {
+    for (size_t i = 0; i < n && w->error == NULL; i++) {
+        mp_obj_t o = slots[i];
+        if (o == MP_OBJ_NULL || !MP_OBJ_IS_OBJ(o)) {
+            continue;
+        }
+        gc_snapshot_walk_ptr(&w->heap, &slots[i]);
+        if (gc_snapshot_walk_visit(MP_OBJ_TO_PTR(o), false)) {
+            gc_snapshot_walk_fields(w, MP_OBJ_TO_PTR(o));
+        }
+    }
+}
+
+STATIC void gc_snapshot_walk_map(gc_snapshot_walker_t *w, mp_map_t *map) {
+    // an indexed table has a hash index after its elements, which is left as
+    // it is
+    if (gc_snapshot_walk_array(w, &map->table)) {
+        for (size_t i = 0; i < map->alloc; i++) {
+            if (MP_MAP_SLOT_IS_FILLED(map, i)) {
+                gc_snapshot_walk_objs(w, &map->table[i].key, 2);
+            }
+        }
+    }
+}
+
+STATIC void gc_snapshot_walk_raw_code(gc_snapshot_walker_t *w, mp_raw_code_t *const *field);
+
+// The constant table of bytecode holds the names of its arguments and the
+// objects that it loads, and then the raw code of the functions that it makes.
+STATIC void gc_snapshot_walk_code(gc_snapshot_walker_t *w, const byte *const *bytecode, const mp_uint_t *const *const_table) {
+    gc_snapshot_walk_data(w, bytecode);
+    if (!gc_snapshot_walk_array(w, const_table)) {
+        return;
+    }
+    size_t bc_len = gc_nbytes(*bytecode);
+    if (bc_len == 0) {
+        gc_snapshot_refuse(w, translate("can't snapshot code run in place"), MP_QSTR_);
+        return;
+    }
+    size_t n = gc_nbytes(*const_table) / sizeof(mp_uint_t);
+    size_t n_obj = n;
+    const byte *ip = *bytecode;
+    const byte *top = ip + bc_len;
+    mp_decode_uint(&ip); // n_state
+    mp_decode_uint(&ip); // n_exc_stack
+    ip += 4; // scope_flags, n_pos_args, n_kwonly_args, n_def_pos_args
+    ip += mp_decode_uint_value(ip); // code_info_size
+    while (*ip++ != 255) { // closure cells
+    }
+    while (ip < top) {
+        size_t sz;
+        mp_opcode_format(ip, &sz);
+        if (*ip >= MP_BC_MAKE_FUNCTION && *ip <= MP_BC_MAKE_CLOSURE_DEFARGS && ip + sz <= top) {
+            const byte *arg = ip + 1;
+            size_t i = mp_decode_uint(&arg);
+            if (i < n_obj) {
+                n_obj = i;
+            }
+        }
+        ip += sz;
+    }
+    gc_snapshot_walk_objs(w, (const mp_obj_t*)*const_table, n_obj);
+    for (size_t i = n_obj; i < n; i++) {
+        gc_snapshot_walk_raw_code(w, (mp_raw_code_t *const *)&(*const_table)[i]);
+    }
+}
+
+STATIC void gc_snapshot_walk_raw_code(gc_snapshot_walker_t *w, mp_raw_code_t *const *field) {
+    mp_raw_code_t *rc = *field;
+    gc_snapshot_walk_ptr(&w->heap, field);
+    if (rc == NULL || !gc_snapshot_walk_visit(rc, false)) {
+        return;
+    }
+    if (rc->kind == MP_CODE_BYTECODE) {
+        gc_snapshot_walk_code(w, &rc->data.u_byte.bytecode, &rc->data.u_byte.const_table);
+        #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+        gc_snapshot_walk_data(w, &rc->data.u_byte.qstr_link);
+        #endif
+    } else if (rc->kind != MP_CODE_UNUSED && rc->kind != MP_CODE_RESERVED) {
+        gc_snapshot_refuse(w, translate("can't snapshot native code"), MP_QSTR_);
+    }
+}
+
+// Walk the fields of o, which has just been reached.
+STATIC void gc_snapshot_walk_fields(gc_snapshot_walker_t *w, mp_obj_base_t *o) {
+    #if MICROPY_STACK_CHECK
+    if (mp_stack_usage() >= MP_STATE_THREAD(stack_limit)) {
+        gc_snapshot_refuse(w, translate("maximum recursion depth exceeded"), MP_QSTR_);
+        return;
+    }
+    #endif
+    gc_snapshot_walk_objs(w, (const mp_obj_t*)&o->type, 1);
+    const mp_obj_type_t *type = o->type;
+    size_t n_words = gc_nbytes(o) / sizeof(mp_obj_t);
+    if (type == &mp_type_type) {
+        mp_obj_type_t *t = (mp_obj_type_t*)o;
+        // the slots are functions in the image
+        gc_snapshot_walk_ptr(&w->heap, &t->print);
+        gc_snapshot_walk_ptr(&w->heap, &t->make_new);
+        gc_snapshot_walk_ptr(&w->heap, &t->call);
+        gc_snapshot_walk_ptr(&w->heap, &t->unary_op);
+        gc_snapshot_walk_ptr(&w->heap, &t->binary_op);
+        gc_snapshot_walk_ptr(&w->heap, &t->attr);
+        gc_snapshot_walk_ptr(&w->heap, &t->subscr);
+        gc_snapshot_walk_ptr(&w->heap, &t->getiter);
+        gc_snapshot_walk_ptr(&w->heap, &t->iternext);
+        gc_snapshot_walk_ptr(&w->heap, &t->buffer_p.get_buffer);
+        gc_snapshot_walk_ptr(&w->heap, &t->protocol);
+        gc_snapshot_walk_objs(w, (const mp_obj_t*)&t->parent, 1);
+        gc_snapshot_walk_objs(w, (const mp_obj_t*)&t->locals_dict, 1);
+    } else if (mp_obj_is_instance_type(type)) {
+        mp_obj_instance_t *inst = (mp_obj_instance_t*)o;
+        gc_snapshot_walk_map(w, &inst->members);
+        gc_snapshot_walk_objs(w, inst->subobj, n_words - offsetof(mp_obj_instance_t, subobj) / sizeof(mp_obj_t));
+    } else if (type == &mp_type_fun_bc) {
+        mp_obj_fun_bc_t *fun = (mp_obj_fun_bc_t*)o;
+        gc_snapshot_walk_objs(w, (const mp_obj_t*)&fun->globals, 1);
+        gc_snapshot_walk_code(w, &fun->bytecode, &fun->const_table);
+        #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+        gc_snapshot_walk_data(w, &fun->qstr_link);
+        #endif
+        gc_snapshot_walk_objs(w, fun->extra_args, n_words - offsetof(mp_obj_fun_bc_t, extra_args) / sizeof(mp_obj_t));
+    #if MICROPY_EMIT_NATIVE || MICROPY_EMIT_INLINE_ASM
+    } else if (0
+        #if MICROPY_EMIT_NATIVE
+        || type == &mp_type_fun_native || type == &mp_type_fun_viper
+        #endif
+        #if MICROPY_EMIT_INLINE_ASM
+        || type == &mp_type_fun_asm
+        #endif
+        ) {
+        gc_snapshot_refuse(w, translate("can't snapshot native code"), MP_QSTR_);
+    #endif
+    } else if (type == &mp_type_dict
+        #if MICROPY_PY_COLLECTIONS_ORDEREDDICT
+        || type == &mp_type_ordereddict
+        #endif
+        ) {
+        gc_snapshot_walk_map(w, &((mp_obj_dict_t*)o)->map);
+    } else if (type == &mp_type_tuple
+        #if MICROPY_PY_COLLECTIONS
+        || type->make_new == namedtuple_make_new
+        #endif
+        ) {
+        mp_obj_tuple_t *t = (mp_obj_tuple_t*)o;
+        gc_snapshot_walk_objs(w, t->items, t->len);
+    #if MICROPY_PY_ATTRTUPLE
+    } else if (type == &mp_type_attrtuple) {
+        // the names of the fields follow the items
+        mp_obj_tuple_t *t = (mp_obj_tuple_t*)o;
+        gc_snapshot_walk_objs(w, t->items, t->len);
+        gc_snapshot_walk_ptr(&w->heap, &t->items[t->len]);
+    #endif
+    } else if (type == &mp_type_list) {
+        mp_obj_list_t *list = (mp_obj_list_t*)o;
+        if (gc_snapshot_walk_array(w, &list->items)) {
+            gc_snapshot_walk_objs(w, list->items, list->len);
+        }
+    #if MICROPY_PY_BUILTINS_SET
+    } else if (type == &mp_type_set
+        #if MICROPY_PY_BUILTINS_FROZENSET
+        || type == &mp_type_frozenset
+        #endif
+        ) {
+        mp_set_t *set = &((mp_obj_set_t*)o)->set;
+        if (gc_snapshot_walk_array(w, &set->table)) {
+            for (size_t i = 0; i < set->alloc; i++) {
+                if (MP_SET_SLOT_IS_FILLED(set, i)) {
+                    gc_snapshot_walk_objs(w, &set->table[i], 1);
+                }
+            }
+        }
+    #endif
+    } else if (type == &mp_type_str || type == &mp_type_bytes) {
+        gc_snapshot_walk_data(w, &((mp_obj_str_t*)o)->data);
+    #if MICROPY_PY_BUILTINS_BYTEARRAY || MICROPY_PY_ARRAY || MICROPY_PY_BUILTINS_MEMORYVIEW
+    } else if (0
+        #if MICROPY_PY_BUILTINS_BYTEARRAY
+        || type == &mp_type_bytearray
+        #endif
+        #if MICROPY_PY_ARRAY
+        || type == &mp_type_array
+        #endif
+        #if MICROPY_PY_BUILTINS_MEMORYVIEW
+        || type == &mp_type_memoryview
+        #endif
+        ) {
+        mp_obj_array_t *array = (mp_obj_array_t*)o;
+        gc_snapshot_walk_data(w, &array->items);
+        if ((array->typecode & ~MP_OBJ_ARRAY_TYPECODE_FLAG_RW) == 'O') {
+            gc_snapshot_walk_objs(w, array->items, array->len);
+        }
+    #endif
+    #if MICROPY_LONGINT_IMPL == MICROPY_LONGINT_IMPL_MPZ
+    } else if (type == &mp_type_int) {
+        gc_snapshot_walk_data(w, &((mp_obj_int_t*)o)->mpz.dig);
+    #endif
+    } else if (type->make_new == mp_obj_exception_make_new) {
+        mp_obj_exception_t *exc = (mp_obj_exception_t*)o;
+        gc_snapshot_walk_data(w, &exc->traceback_data);
+        gc_snapshot_walk_objs(w, (const mp_obj_t*)&exc->args, 1);
+    } else if (type == &closure_type) {
+        mp_obj_closure_t *closure = (mp_obj_closure_t*)o;
+        gc_snapshot_walk_objs(w, &closure->fun, 1);
+        gc_snapshot_walk_objs(w, closure->closed, closure->n_closed);
+    } else if (type == &mp_type_module || type == &mp_type_cell || type == &mp_type_bound_meth
+        || type == &mp_type_gen_wrap || type == &mp_type_staticmethod || type == &mp_type_classmethod
+        #if MICROPY_PY_BUILTINS_PROPERTY
+        || type == &mp_type_property
+        #endif
+        #if MICROPY_PY_BUILTINS_SLICE
+        || type == &mp_type_slice
+        #endif
+        ) {
+        // everything after the type is an object
+        gc_snapshot_walk_objs(w, (const mp_obj_t*)(o + 1), n_words - 1);
+    } else if (type != &mp_type_object && type != &mp_type_int && type != &mp_type_range
+        #if MICROPY_PY_BUILTINS_FLOAT
+        && type != &mp_type_float
+        #endif
+        #if MICROPY_PY_BUILTINS_COMPLEX
+        && type != &mp_type_complex
+        #endif
+        ) {
+        gc_snapshot_refuse(w, translate("can't snapshot %q objects"), type->name);
+    }
+}
+
+STATIC void gc_snapshot_walk_roots(gc_snapshot_walker_t *w, gc_snapshot_roots_t *roots) {
+    // interned strings are in chunks that the pools point into
+    for (qstr_pool_t *pool = roots->last_pool; pool != NULL && gc_snapshot_walk_visit(pool, false); pool = pool->prev) {
+        gc_snapshot_walk_ptr(&w->heap, &pool->prev);
+        for (size_t i = 0; i < pool->len; i++) {
+            gc_snapshot_walk_data(w, &pool->qstrs[i]);
+        }
+    }
+    gc_snapshot_walk_data(w, &roots->qstr_last_chunk);
+    #if MICROPY_QSTR_HASH_INDEX
+    gc_snapshot_walk_data(w, &roots->qstr_index);
+    #endif
+    gc_snapshot_walk_map(w, &roots->loaded_modules_dict.map);
+    #if MICROPY_CAN_OVERRIDE_BUILTINS
+    gc_snapshot_walk_objs(w, (const mp_obj_t*)&roots->builtins_override_dict, 1);
+    #endif
+    // blocks of the next block and then objects that are never freed
+    for (void **block = roots->permanent_pointers; block != NULL && gc_snapshot_walk_visit(block, false); block = block[0]) {
+        gc_snapshot_walk_ptr(&w->heap, &block[0]);
+        gc_snapshot_walk_objs(w, (const mp_obj_t*)&block[1], MICROPY_BYTES_PER_GC_BLOCK / sizeof(void*) - 1);
+    }
+}
+
+STATIC void gc_snapshot_save_end(byte *ptr_map) {
+    gc_snapshot_walk_end();
+    gc_unlock();
+    m_del(byte, ptr_map, gc_snapshot_ptr_map_len());
+}
+
+// Writing must not allocate, as the heap is locked while it is saved.
+void gc_snapshot_save(const mp_print_t *print) {
+    #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+    if (MP_STATE_VM(persistent_code_mapped)) {
+        mp_raise_RuntimeError(translate("can't snapshot code run in place"));
+    }
+    #endif
+    byte *ptr_map = m_new(byte, gc_snapshot_ptr_map_len());
+    gc_collect();
+
+    gc_snapshot_header_t header;
+    gc_snapshot_make_header(&header);
+    gc_snapshot_roots_t roots;
+    memset(&roots, 0, sizeof(roots));
+    roots.last_pool = MP_STATE_VM(last_pool);
+    roots.qstr_last_chunk = MP_STATE_VM(qstr_last_chunk);
+    roots.qstr_last_alloc = MP_STATE_VM(qstr_last_alloc);
+    roots.qstr_last_used = MP_STATE_VM(qstr_last_used);
+    #if MICROPY_QSTR_HASH_INDEX
+    roots.qstr_index = MP_STATE_VM(qstr_index);
+    roots.qstr_index_alloc = MP_STATE_VM(qstr_index_alloc);
+    roots.qstr_index_top = MP_STATE_VM(qstr_index_top);
+    #endif
+    roots.loaded_modules_dict = MP_STATE_VM(mp_loaded_modules_dict);
+    #if MICROPY_CAN_OVERRIDE_BUILTINS
+    roots.builtins_override_dict = MP_STATE_VM(mp_module_builtins_override_dict);
+    #endif
+    roots.permanent_pointers = MP_STATE_MEM(permanent_pointers);
+
+    gc_lock();
+    gc_snapshot_walker_t w;
+    w.error = NULL;
+    gc_snapshot_walk_begin(&w.heap, ptr_map);
+    gc_snapshot_walk_roots(&w, &roots);
+    if (w.error != NULL) {
+        gc_snapshot_save_end(ptr_map);
+        mp_raise_msg_varg(&mp_type_RuntimeError, w.error, w.error_arg);
+    }
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        print->print_strn(print->data, (const char*)&header, sizeof(header));
+        print->print_strn(print->data, (const char*)&roots, sizeof(roots));
+        gc_snapshot_save_heap(print, &w.heap);
+        nlr_pop();
+        gc_snapshot_save_end(ptr_map);
+    } else {
+        gc_snapshot_save_end(ptr_map);
+        nlr_jump(nlr.ret_val);
+    }
+}
+
+gc_snapshot_result_t gc_snapshot_load(const gc_snapshot_reader_t *reader, size_t len) {
+    gc_snapshot_header_t header;
+    gc_snapshot_header_t expected;
+    gc_snapshot_roots_t roots;
+    if (len < sizeof(header) + sizeof(roots)
+        || !reader->read(reader->data, &header, sizeof(header))
+        || !reader->read(reader->data, &roots, sizeof(roots))) {
+        return GC_SNAPSHOT_REJECTED;
+    }
+    gc_snapshot_make_header(&expected);
+    if (header.magic != expected.magic || header.version != expected.version
+        || header.bytes_per_block != expected.bytes_per_block
+        || header.state_size != expected.state_size
+        || header.image_end - header.image_start != expected.image_end - expected.image_start
+        || memcmp(header.markers, expected.markers, sizeof(header.markers)) != 0) {
+        return GC_SNAPSHOT_REJECTED;
+    }
+
+    gc_snapshot_reloc_t reloc;
+    reloc.n = 0;
+    if (header.image_start != expected.image_start) {
+        reloc.range[0].start = header.image_start;
+        reloc.range[0].end = header.image_end;
+        reloc.range[0].delta = expected.image_start - header.image_start;
+        reloc.n = 1;
+    }
+    gc_snapshot_result_t res = gc_snapshot_load_heap(reader, len - sizeof(header) - sizeof(roots), &reloc);
+    if (res != GC_SNAPSHOT_LOADED) {
+        return res;
+    }
+    void **root_ptrs[] = {
+        (void**)&roots.last_pool,
+        (void**)&roots.qstr_last_chunk,
+        #if MICROPY_QSTR_HASH_INDEX
+        (void**)&roots.qstr_index,
+        #endif
+        (void**)&roots.loaded_modules_dict.base.type,
+        (void**)&roots.loaded_modules_dict.map.table,
+        #if MICROPY_CAN_OVERRIDE_BUILTINS
+        (void**)&roots.builtins_override_dict,
+        #endif
+        (void**)&roots.permanent_pointers,
+    };
+    for (size_t i = 0; i < MP_ARRAY_SIZE(root_ptrs); i++) {
+        gc_snapshot_relocate(&reloc, root_ptrs[i], 1);
+    }
+
+    MP_STATE_VM(last_pool) = roots.last_pool;
+    MP_STATE_VM(qstr_last_chunk) = roots.qstr_last_chunk;
+    MP_STATE_VM(qstr_last_alloc) = roots.qstr_last_alloc;
+    MP_STATE_VM(qstr_last_used) = roots.qstr_last_used;
+    #if MICROPY_QSTR_HASH_INDEX
+    MP_STATE_VM(qstr_index) = roots.qstr_index;
+    MP_STATE_VM(qstr_index_alloc) = roots.qstr_index_alloc;
+    MP_STATE_VM(qstr_index_top) = roots.qstr_index_top;
+    #endif
+    MP_STATE_VM(mp_loaded_modules_dict) = roots.loaded_modules_dict;
+    #if MICROPY_CAN_OVERRIDE_BUILTINS
+    MP_STATE_VM(mp_module_builtins_override_dict) = roots.builtins_override_dict;
+    #endif
+    MP_STATE_MEM(permanent_pointers) = roots.permanent_pointers;
+
+    // __main__ was in the heap that has just been replaced, so start it again
+    // as mp_init does
+    mp_obj_dict_init(&MP_STATE_VM(dict_main), 1);
+    mp_obj_dict_store(MP_OBJ_FROM_PTR(&MP_STATE_VM(dict_main)), MP_OBJ_NEW_QSTR(MP_QSTR___name__), MP_OBJ_NEW_QSTR(MP_QSTR___main__));
+    mp_locals_set(&MP_STATE_VM(dict_main));
+    mp_globals_set(&MP_STATE_VM(dict_main));
+
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    // types in the heap may have moved
+    MP_STATE_VM(type_attr_cache_version)++;
+    #endif
+    return GC_SNAPSHOT_LOADED;
+}
+
+#endif // MICROPY_GC_SNAPSHOT
@@ -30,6 +30,7 @@
 #ifndef MICROPY_INCLUDED_PY_GC_LONG_LIVED_H
 #define MICROPY_INCLUDED_PY_GC_LONG_LIVED_H
 
+#include "py/gc.h"
 #include "py/objfun.h"
 #include "py/objproperty.h"
 #include "py/objstr.h"
@@ -40,4 +41,12 @@ mp_obj_dict_t *make_dict_long_lived(mp_obj_dict_t *dict, uint8_t max_depth);
 mp_obj_str_t *make_str_long_lived(mp_obj_str_t *str);
 mp_obj_t make_obj_long_lived(mp_obj_t obj, uint8_t max_depth);
 
+#if MICROPY_GC_SNAPSHOT
+// Save the heap and the state that refers into it after a warm start, and
+// restore it from the len bytes that reader gives in a later run, straight
+// after mp_init.
+void gc_snapshot_save(const mp_print_t *print);
+gc_snapshot_result_t gc_snapshot_load(const gc_snapshot_reader_t *reader, size_t len);
+#endif
+
 #endif // MICROPY_INCLUDED_PY_GC_LONG_LIVED_H
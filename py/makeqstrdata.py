@@ -82,6 +82,39 @@ def compute_hash(qstr, bytes_hash):
     # Make sure that valid hash is never zero, zero means "hash not computed"
     return (hash & ((1 << (8 * bytes_hash)) - 1)) or 1
 
+# this must match the equivalent function in qstr.c
+def compute_index_hash(qstr):
+    hash = 5381
+    for b in qstr:
+        hash = ((hash * 33) ^ b) & 0xffffffff
+    # mix so that the top bits, which pick the slot, depend on every byte
+    hash ^= hash >> 16
+    hash = (hash * 0x45d9f3b) & 0xffffffff
+    hash ^= hash >> 16
+    return hash
+
+# Build an open-addressing table of qstr ids keyed by compute_index_hash.
+# Slot 0 in the table means empty, which is fine because MP_QSTR_NULL is never
+# looked up. The table is kept at most 3/4 full and probed linearly.
+def print_qstr_index(qstrs, index_filename):
+    ordered = sorted(qstrs.values(), key=lambda x: x[0])
+    # ids start at 1 because MP_QSTR_NULL is id 0
+    assert len(ordered) < 0xffff
+    size = len(ordered) * 4 // 3 + 1
+    table = [0] * size
+    for qid, (_, _, qstr) in enumerate(ordered, 1):
+        hash = compute_index_hash(bytes_cons(qstr, 'utf8'))
+        slot = ((hash >> 16) * size) >> 16
+        while table[slot]:
+            slot += 1
+            if slot == size:
+                slot = 0
+        table[slot] = qid
+    with open(index_filename, "w") as f:
+        f.write("// This file was automatically generated by makeqstrdata.py\n\n")
+        f.write("#define QSTR_ROM_INDEX_SIZE ({})\n".format(size))
+        f.write("const uint16_t qstr_rom_index[QSTR_ROM_INDEX_SIZE] = {{ {} }};\n".format(", ".join(map(str, table))))
+
 def translate(translation_file, i18ns):
     with open(translation_file, "rb") as f:
         table = gettext.GNUTranslations(f)
@@ -383,6 +416,8 @@ if __name__ == "__main__":
                         help='translations for i18n() items')
     parser.add_argument('--compression_filename', default=None, type=str,
                         help='header for compression info')
+    parser.add_argument('--index_filename', default=None, type=str,
+                        help='header for the const pool hash index')
 
     args = parser.parse_args()
 
@@ -391,5 +426,7 @@ if __name__ == "__main__":
         translations = translate(args.translation, i18ns)
         encoding_table = compute_huffman_coding(translations, qstrs, args.compression_filename)
         print_qstr_data(encoding_table, qcfgs, qstrs, translations)
+        if args.index_filename:
+            print_qstr_index(qstrs, args.index_filename)
     else:
         print_qstr_enums(qstrs)
@@ -32,6 +32,7 @@
 #include "py/mpconfig.h"
 #include "py/misc.h"
 #include "py/runtime.h"
+#include "py/objstr.h"
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
 #define DEBUG_PRINT (1)
@@ -76,6 +77,90 @@ STATIC size_t get_hash_alloc_greater_or_equal_to(size_t x) {
 /******************************************************************************/
 /* map                                                                        */
 
+#if MICROPY_OPT_MAP_LOOKUP_CACHE
+// Shift out the object tag bits before picking an entry.
+#define MAP_CACHE_ENTRY(index) (MP_STATE_VM(map_lookup_cache)[((uintptr_t)(index) >> 2) & (MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE - 1)])
+#endif
+
+#if MICROPY_OPT_MAP_ORDERED_INDEX
+// An indexed map's table holds alloc elements followed by a uint16_t array.
+// Its first entry is the number of elements the index covers, and the rest
+// are hash slots holding an element's position plus one, or 0 when empty.
+// Removing an element shifts the ones after it, so that just invalidates the
+// index and the next lookup rebuilds it.  Only keys with a cheap hash that
+// can't raise are indexed; adding any other key drops the index for good.
+
+#define MAP_INDEX_INVALID (0xffff)
+// Hash slots for a table of n elements, keeping the load at most a half.
+#define MAP_INDEX_SLOTS(n) ((size_t)1 << (8 * sizeof(unsigned int) - __builtin_clz(2 * (n) - 1)))
+// Elements of space taken by the index of a table of n elements.
+#define MAP_INDEX_ELEMS(n) (((1 + MAP_INDEX_SLOTS(n)) * sizeof(uint16_t) + sizeof(mp_map_elem_t) - 1) / sizeof(mp_map_elem_t))
+#define MAP_INDEX(map) ((uint16_t*)&(map)->table[(map)->alloc])
+#define MAP_WANTS_INDEX(n) ((n) >= MICROPY_OPT_MAP_ORDERED_INDEX_MIN && (n) < MAP_INDEX_INVALID)
+
+STATIC bool mp_map_index_hash(mp_obj_t key, mp_uint_t *hash) {
+    if (MP_OBJ_IS_QSTR(key)) {
+        *hash = qstr_hash(MP_OBJ_QSTR_VALUE(key));
+    } else if (MP_OBJ_IS_SMALL_INT(key)) {
+        *hash = MP_OBJ_SMALL_INT_VALUE(key);
+    } else if (MP_OBJ_IS_STR_OR_BYTES(key)) {
+        GET_STR_HASH(key, h);
+        if (h == 0) {
+            GET_STR_DATA_LEN(key, data, len);
+            h = qstr_compute_hash(data, len);
+        }
+        *hash = h;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+STATIC void mp_map_index_insert(mp_map_t *map, uint16_t *index, mp_uint_t hash, size_t pos) {
+    size_t mask = MAP_INDEX_SLOTS(map->alloc) - 1;
+    size_t slot = hash & mask;
+    while (index[1 + slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    index[1 + slot] = pos + 1;
+}
+
+// Returns false, leaving the index unusable, if some key can't be indexed.
+STATIC bool mp_map_index_build(mp_map_t *map) {
+    uint16_t *index = MAP_INDEX(map);
+    memset(index + 1, 0, MAP_INDEX_SLOTS(map->alloc) * sizeof(uint16_t));
+    for (size_t i = 0; i < map->used; i++) {
+        mp_uint_t hash;
+        if (!mp_map_index_hash(map->table[i].key, &hash)) {
+            return false;
+        }
+        mp_map_index_insert(map, index, hash, i);
+    }
+    index[0] = map->used;
+    return true;
+}
+
+// Make room for at least one more element, adding an index if the map has
+// become big enough or dropping it if a key that can't be indexed is about to
+// be added.  Only called when adding a key, so callers expect the table to move.
+STATIC void mp_map_ordered_grow(mp_map_t *map, bool indexable) {
+    size_t old_elems = map->alloc + (map->is_indexed ? MAP_INDEX_ELEMS(map->alloc) : 0);
+    if (map->used == map->alloc) {
+        // grow geometrically once indexed, since each growth rebuilds the index
+        map->alloc += MAP_WANTS_INDEX(map->alloc) ? map->alloc / 2 : 4;
+    }
+    bool indexed = indexable && MAP_WANTS_INDEX(map->alloc);
+    size_t new_elems = map->alloc + (indexed ? MAP_INDEX_ELEMS(map->alloc) : 0);
+    map->table = m_renew(mp_map_elem_t, map->table, old_elems, new_elems);
+    mp_seq_clear(map->table, map->used, map->alloc, sizeof(*map->table));
+    map->is_indexed = indexed && mp_map_index_build(map);
+    if (indexed && !map->is_indexed) {
+        // shrinking never moves the table
+        map->table = m_renew(mp_map_elem_t, map->table, new_elems, map->alloc);
+    }
+}
+#endif
+
 void mp_map_init(mp_map_t *map, size_t n) {
     if (n == 0) {
         map->alloc = 0;
@@ -88,6 +173,7 @@ void mp_map_init(mp_map_t *map, size_t n) {
     map->all_keys_are_qstrs = 1;
     map->is_fixed = 0;
     map->is_ordered = 0;
+    map->is_indexed = 0;
 }
 
 void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table) {
@@ -96,23 +182,28 @@ void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table) {
     map->all_keys_are_qstrs = 1;
     map->is_fixed = 1;
     map->is_ordered = 1;
+    map->is_indexed = 0;
     map->table = (mp_map_elem_t*)table;
 }
 
 // Differentiate from mp_map_clear() - semantics is different
 void mp_map_deinit(mp_map_t *map) {
     if (!map->is_fixed) {
-        m_del(mp_map_elem_t, map->table, map->alloc);
+        #if MICROPY_OPT_MAP_ORDERED_INDEX
+        if (map->is_indexed) {
+            m_del(mp_map_elem_t, map->table, map->alloc + MAP_INDEX_ELEMS(map->alloc));
+        } else
+        #endif
+        {
+            m_del(mp_map_elem_t, map->table, map->alloc);
+        }
     }
     map->used = map->alloc = 0;
+    map->is_indexed = 0;
 }
 
 void mp_map_clear(mp_map_t *map) {
-    if (!map->is_fixed) {
-        m_del(mp_map_elem_t, map->table, map->alloc);
-    }
-    map->alloc = 0;
-    map->used = 0;
+    mp_map_deinit(map);
     map->all_keys_are_qstrs = 1;
     map->is_fixed = 0;
     map->table = NULL;
@@ -166,10 +257,50 @@ mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t
         }
     }
 
-    // if the map is an ordered array then we must do a brute force linear search
+    // if the map is an ordered array then we must do a brute force linear search,
+    // unless it has an index or the key was cached
     if (map->is_ordered) {
-        for (mp_map_elem_t *elem = &map->table[0], *top = &map->table[map->used]; elem < top; elem++) {
+        mp_map_elem_t *elem = &map->table[0];
+        mp_map_elem_t *top = &map->table[map->used];
+        #if MICROPY_OPT_MAP_LOOKUP_CACHE
+        if (map->is_fixed) {
+            size_t pos = MAP_CACHE_ENTRY(index);
+            if (pos < map->used && map->table[pos].key == index) {
+                return &map->table[pos];
+            }
+        }
+        #endif
+        #if MICROPY_OPT_MAP_ORDERED_INDEX
+        // only adding needs to know whether an unindexed map could take the key
+        mp_uint_t hash = 0;
+        bool indexable = (map->is_indexed || lookup_kind == MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)
+            && mp_map_index_hash(index, &hash);
+        if (map->is_indexed && indexable) {
+            uint16_t *map_index = MAP_INDEX(map);
+            if (map_index[0] != map->used) {
+                mp_map_index_build(map);
+            }
+            size_t mask = MAP_INDEX_SLOTS(map->alloc) - 1;
+            for (size_t slot = hash & mask; map_index[1 + slot] != 0; slot = (slot + 1) & mask) {
+                elem = &map->table[map_index[1 + slot] - 1];
+                if (elem->key == index || (!compare_only_ptrs && mp_obj_equal(elem->key, index))) {
+                    goto found_ordered;
+                }
+            }
+            // not found, and there's nothing left to scan
+            elem = top;
+        }
+        #endif
+        for (; elem < top; elem++) {
             if (elem->key == index || (!compare_only_ptrs && mp_obj_equal(elem->key, index))) {
+                #if MICROPY_OPT_MAP_ORDERED_INDEX
+            found_ordered:
+                #endif
+                #if MICROPY_OPT_MAP_LOOKUP_CACHE
+                if (map->is_fixed) {
+                    MAP_CACHE_ENTRY(index) = elem - map->table;
+                }
+                #endif
                 #if MICROPY_PY_COLLECTIONS_ORDEREDDICT
                 if (MP_UNLIKELY(lookup_kind == MP_MAP_LOOKUP_REMOVE_IF_FOUND)) {
                     // remove the found element by moving the rest of the array down
@@ -180,6 +311,11 @@ mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t
                     elem = &map->table[map->used];
                     elem->key = MP_OBJ_NULL;
                     elem->value = value;
+                    #if MICROPY_OPT_MAP_ORDERED_INDEX
+                    if (map->is_indexed) {
+                        MAP_INDEX(map)[0] = MAP_INDEX_INVALID;
+                    }
+                    #endif
                 }
                 #endif
                 return elem;
@@ -189,13 +325,23 @@ mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t
         if (MP_LIKELY(lookup_kind != MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)) {
             return NULL;
         }
+        #if MICROPY_OPT_MAP_ORDERED_INDEX
+        if (map->used == map->alloc || (map->is_indexed && !indexable)) {
+            mp_map_ordered_grow(map, indexable);
+        }
+        if (map->is_indexed && MAP_INDEX(map)[0] == map->used) {
+            mp_map_index_insert(map, MAP_INDEX(map), hash, map->used);
+            MAP_INDEX(map)[0] = map->used + 1;
+        }
+        #else
         if (map->used == map->alloc) {
             // TODO: Alloc policy
             map->alloc += 4;
             map->table = m_renew(mp_map_elem_t, map->table, map->used, map->alloc);
             mp_seq_clear(map->table, map->used, map->alloc, sizeof(*map->table));
         }
-        mp_map_elem_t *elem = map->table + map->used++;
+        #endif
+        elem = map->table + map->used++;
         elem->key = index;
         if (!MP_OBJ_IS_QSTR(index)) {
             map->all_keys_are_qstrs = 0;
@@ -95,6 +95,45 @@ STATIC mp_obj_t gc_threshold(size_t n_args, const mp_obj_t *args) {
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_threshold_obj, 0, 1, gc_threshold);
 #endif
 
+#if MICROPY_GC_INCREMENTAL
+// incremental([slice_bytes[, max_pause_us]]): get or set how collections are split
+// into slices; a slice size of 0 collects stop-the-world
+STATIC mp_obj_t gc_incremental(size_t n_args, const mp_obj_t *args) {
+    if (n_args == 0) {
+        mp_obj_t tuple[2] = {
+            mp_obj_new_int(MP_STATE_MEM(gc_slice_blocks) * MICROPY_BYTES_PER_GC_BLOCK),
+            mp_obj_new_int_from_uint(MP_STATE_MEM(gc_max_pause_us)),
+        };
+        return mp_obj_new_tuple(2, tuple);
+    }
+    mp_int_t val = mp_obj_get_int(args[0]);
+    if (val <= 0) {
+        MP_STATE_MEM(gc_slice_blocks) = 0;
+    } else {
+        MP_STATE_MEM(gc_slice_blocks) = (val + MICROPY_BYTES_PER_GC_BLOCK - 1) / MICROPY_BYTES_PER_GC_BLOCK;
+    }
+    if (n_args > 1) {
+        mp_int_t pause = mp_obj_get_int(args[1]);
+        MP_STATE_MEM(gc_max_pause_us) = pause < 0 ? 0 : pause;
+    }
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_incremental_obj, 0, 2, gc_incremental);
+
+// pause_stats(): return the number of slices and the longest one in microseconds
+// since the last call
+STATIC mp_obj_t gc_pause_stats(void) {
+    mp_obj_t tuple[2] = {
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_pause_slices)),
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_pause_max_us)),
+    };
+    MP_STATE_MEM(gc_pause_slices) = 0;
+    MP_STATE_MEM(gc_pause_max_us) = 0;
+    return mp_obj_new_tuple(2, tuple);
+}
+MP_DEFINE_CONST_FUN_OBJ_0(gc_pause_stats_obj, gc_pause_stats);
+#endif
+
 STATIC const mp_rom_map_elem_t mp_module_gc_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_gc) },
     { MP_ROM_QSTR(MP_QSTR_collect), MP_ROM_PTR(&gc_collect_obj) },
@@ -106,6 +145,10 @@ STATIC const mp_rom_map_elem_t mp_module_gc_globals_table[] = {
     #if MICROPY_GC_ALLOC_THRESHOLD
     { MP_ROM_QSTR(MP_QSTR_threshold), MP_ROM_PTR(&gc_threshold_obj) },
     #endif
+    #if MICROPY_GC_INCREMENTAL
+    { MP_ROM_QSTR(MP_QSTR_incremental), MP_ROM_PTR(&gc_incremental_obj) },
+    { MP_ROM_QSTR(MP_QSTR_pause_stats), MP_ROM_PTR(&gc_pause_stats_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_gc_globals, mp_module_gc_globals_table);
@@ -30,7 +30,9 @@
 #include "py/stackctrl.h"
 #include "py/runtime.h"
 #include "py/gc.h"
+#include "py/gc_long_lived.h"
 #include "py/mphal.h"
+#include "py/stream.h"
 
 #include "supervisor/shared/translate.h"
 
@@ -116,6 +118,17 @@ STATIC mp_obj_t mp_micropython_stack_use(void) {
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_stack_use_obj, mp_micropython_stack_use);
 #endif
 
+#if MICROPY_OPT_TYPE_ATTR_CACHE
+STATIC mp_obj_t mp_micropython_attr_cache_stats(void) {
+    mp_obj_t tuple[2] = {
+        mp_obj_new_int_from_uint(MP_STATE_VM(type_attr_cache_hits)),
+        mp_obj_new_int_from_uint(MP_STATE_VM(type_attr_cache_misses)),
+    };
+    return mp_obj_new_tuple(2, tuple);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_attr_cache_stats_obj, mp_micropython_attr_cache_stats);
+#endif
+
 #if MICROPY_ENABLE_PYSTACK
 STATIC mp_obj_t mp_micropython_pystack_use(void) {
     return MP_OBJ_NEW_SMALL_INT(mp_pystack_usage());
@@ -137,6 +150,16 @@ STATIC mp_obj_t mp_micropython_heap_unlock(void) {
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_heap_unlock_obj, mp_micropython_heap_unlock);
 #endif
 
+#if MICROPY_GC_SNAPSHOT
+STATIC mp_obj_t mp_micropython_heap_snapshot(mp_obj_t stream) {
+    mp_get_stream_raise(stream, MP_STREAM_OP_WRITE);
+    mp_print_t print = {MP_OBJ_TO_PTR(stream), mp_stream_write_adaptor};
+    gc_snapshot_save(&print);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_micropython_heap_snapshot_obj, mp_micropython_heap_snapshot);
+#endif
+
 #if MICROPY_ENABLE_EMERGENCY_EXCEPTION_BUF && (MICROPY_EMERGENCY_EXCEPTION_BUF_SIZE == 0)
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_alloc_emergency_exception_buf_obj, mp_alloc_emergency_exception_buf);
 #endif
@@ -183,10 +206,16 @@ STATIC const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     #if MICROPY_ENABLE_PYSTACK
     { MP_ROM_QSTR(MP_QSTR_pystack_use), MP_ROM_PTR(&mp_micropython_pystack_use_obj) },
     #endif
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    { MP_ROM_QSTR(MP_QSTR_attr_cache_stats), MP_ROM_PTR(&mp_micropython_attr_cache_stats_obj) },
+    #endif
     #if MICROPY_ENABLE_GC
     { MP_ROM_QSTR(MP_QSTR_heap_lock), MP_ROM_PTR(&mp_micropython_heap_lock_obj) },
     { MP_ROM_QSTR(MP_QSTR_heap_unlock), MP_ROM_PTR(&mp_micropython_heap_unlock_obj) },
     #endif
+    #if MICROPY_GC_SNAPSHOT
+    { MP_ROM_QSTR(MP_QSTR_heap_snapshot), MP_ROM_PTR(&mp_micropython_heap_snapshot_obj) },
+    #endif
     #if MICROPY_KBD_EXCEPTION
     { MP_ROM_QSTR(MP_QSTR_kbd_intr), MP_ROM_PTR(&mp_micropython_kbd_intr_obj) },
     #endif
@@ -167,6 +167,12 @@ STATIC void *thread_entry(void *args_in) {
     mp_stack_set_top(&ts + 1); // need to include ts in root-pointer scan
     mp_stack_set_limit(args->stack_size);
 
+    #if MICROPY_GC_TLAB
+    // the allocation buffer is set aside on the first allocation
+    ts.gc_tlab_cur = NULL;
+    ts.gc_tlab_end = NULL;
+    #endif
+
     #if MICROPY_ENABLE_PYSTACK
     // TODO threading and pystack is not fully supported, for now just make a small stack
     mp_obj_t mini_pystack[128];
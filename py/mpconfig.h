@@ -127,6 +127,59 @@
 #define MICROPY_GC_ALLOC_THRESHOLD (1)
 #endif
 
+// Support splitting garbage collection into slices of bounded length,
+// configurable by gc.incremental().  Marking still pauses the VM but yields
+// to background tasks between slices, and the sweep after an automatic
+// collection is finished lazily by the allocator and the background loop.
+#ifndef MICROPY_GC_INCREMENTAL
+#define MICROPY_GC_INCREMENTAL (0)
+#endif
+
+// Bytes of heap marked or swept between checks of the slice clock, or 0 to
+// collect stop-the-world until gc.incremental() is called.
+#ifndef MICROPY_GC_INCREMENTAL_SLICE_BYTES
+#define MICROPY_GC_INCREMENTAL_SLICE_BYTES (0)
+#endif
+
+// Longest a slice may run, in microseconds, before yielding.
+#ifndef MICROPY_GC_INCREMENTAL_MAX_PAUSE_US
+#define MICROPY_GC_INCREMENTAL_MAX_PAUSE_US (1000)
+#endif
+
+// Called between slices of a collection.  The heap is locked while it runs, so
+// it must not allocate (which is asserted): an allocation would fail and raise
+// MemoryError, or silently get nothing from the _maybe variants.
+#ifndef MICROPY_GC_INCREMENTAL_YIELD
+#define MICROPY_GC_INCREMENTAL_YIELD()
+#endif
+
+// Clock used to time slices, which needs microsecond resolution.
+#ifndef MICROPY_GC_INCREMENTAL_TICKS_US
+#define MICROPY_GC_INCREMENTAL_TICKS_US() mp_hal_ticks_us()
+#endif
+
+// Give each thread a buffer of single-block heads carved from the heap so that
+// small allocations are a pointer bump, without taking the GC mutex.  A port
+// enabling this must call gc_collect_tlab() from each thread whose stack it
+// scans, at the time it is scanned.
+#ifndef MICROPY_GC_TLAB
+#define MICROPY_GC_TLAB (0)
+#endif
+
+// Most blocks set aside for a thread at a time.
+#ifndef MICROPY_GC_TLAB_BLOCKS
+#define MICROPY_GC_TLAB_BLOCKS (32)
+#endif
+
+// Support saving the heap with the loaded modules and interned strings, and
+// restoring it when the VM next starts instead of importing them again (see
+// py/gc_long_lived.c).  Pointers are moved if the heap or, when the port defines
+// MICROPY_GC_SNAPSHOT_IMAGE_START/END, the firmware image is elsewhere.
+// Requires MICROPY_PERSISTENT_CODE.
+#ifndef MICROPY_GC_SNAPSHOT
+#define MICROPY_GC_SNAPSHOT (0)
+#endif
+
 // Number of bytes to allocate initially when creating new chunks to store
 // interned string data.  Smaller numbers lead to more chunks being needed
 // and more wastage at the end of the chunk.  Larger numbers lead to wasted
@@ -221,6 +274,13 @@
 #define MICROPY_QSTR_BYTES_IN_HASH (2)
 #endif
 
+// Whether to find qstrs through hash indexes instead of scanning every pool.
+// The const pool index is generated at build time and takes about 2.7 bytes
+// of flash per qstr; qstrs added at runtime are indexed in the heap.
+#ifndef MICROPY_QSTR_HASH_INDEX
+#define MICROPY_QSTR_HASH_INDEX (0)
+#endif
+
 // Avoid using C stack when making Python function calls. C stack still
 // may be used if there's no free heap.
 #ifndef MICROPY_STACKLESS
@@ -257,6 +317,14 @@
 #define MICROPY_PERSISTENT_CODE_SAVE (0)
 #endif
 
+// Whether to support running .mpy bytecode in place from memory that stays
+// mapped (mmap, XIP flash) via mp_raw_code_load_mapped.  Such bytecode keeps
+// its qstrs numbered and they are resolved through a small per-function link
+// table, so only the constant tables and the link tables go on the heap.
+#ifndef MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+#define MICROPY_PERSISTENT_CODE_LOAD_MAPPED (0)
+#endif
+
 // Whether generated code can persist independently of the VM/runtime instance
 // This is enabled automatically when needed by other features
 #ifndef MICROPY_PERSISTENT_CODE
@@ -331,9 +399,11 @@
 #if MICROPY_DYNAMIC_COMPILER
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE_DYNAMIC (mp_dynamic_compiler.opt_cache_map_lookup_in_bytecode)
 #define MICROPY_PY_BUILTINS_STR_UNICODE_DYNAMIC (mp_dynamic_compiler.py_builtins_str_unicode)
+#define MICROPY_OPT_SUPERINSTRUCTIONS_DYNAMIC (mp_dynamic_compiler.opt_superinstructions)
 #else
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE_DYNAMIC MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE
 #define MICROPY_PY_BUILTINS_STR_UNICODE_DYNAMIC MICROPY_PY_BUILTINS_STR_UNICODE
+#define MICROPY_OPT_SUPERINSTRUCTIONS_DYNAMIC MICROPY_OPT_SUPERINSTRUCTIONS
 #endif
 
 // Whether to enable constant folding; eg 1+2 rewritten as 3
@@ -407,6 +477,69 @@
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE (0)
 #endif
 
+// Whether the VM quickens bytecode: on first execution a generic binary op or
+// subscript whose operands are small ints (or a list indexed by a small int)
+// is rewritten in place into a specialised opcode that skips the generic
+// runtime dispatch, and rewritten back if the operand types later differ.
+// Only bytecode in the GC heap is ever modified, so frozen bytecode in ROM and
+// code executed from a mapped .mpy are left alone.  Costs about 1k of VM code.
+#ifndef MICROPY_OPT_QUICKEN_BYTECODE
+#define MICROPY_OPT_QUICKEN_BYTECODE (0)
+#endif
+
+// Whether the bytecode emitter fuses common opcode sequences (two local loads,
+// a binary op with a small-int constant, a compare followed by a conditional
+// jump, the DUP_TOP_TWO/ROT_THREE around an augmented subscript assignment)
+// into single superinstructions, and the VM executes them.  .mpy files that
+// contain superinstructions are flagged as such and only load on a VM with
+// this enabled; mpy-cross emits them when given -msuperinstructions.
+#ifndef MICROPY_OPT_SUPERINSTRUCTIONS
+#define MICROPY_OPT_SUPERINSTRUCTIONS (0)
+#endif
+
+// Whether to cache the results of looking up attributes and methods in classes
+// and their bases, which LOAD_ATTR/LOAD_METHOD on class instances otherwise do
+// on every execution from both bytecode and native code.  The cache is keyed
+// on the type and attribute, and a version tag that is bumped whenever a class
+// is created or has its locals changed.  micropython.attr_cache_stats() returns
+// the number of hits and misses.
+#ifndef MICROPY_OPT_TYPE_ATTR_CACHE
+#define MICROPY_OPT_TYPE_ATTR_CACHE (0)
+#endif
+
+// Number of entries in the class lookup cache; must be a power of 2.
+#ifndef MICROPY_OPT_TYPE_ATTR_CACHE_SIZE
+#define MICROPY_OPT_TYPE_ATTR_CACHE_SIZE (64)
+#endif
+
+// Without a GIL threads fill and read the class lookup cache at the same time,
+// so each entry has a sequence number that readers check around their read.
+#define MICROPY_OPT_TYPE_ATTR_CACHE_SEQ (MICROPY_OPT_TYPE_ATTR_CACHE && MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL)
+
+// Whether lookups in fixed maps (ROM module and class dicts, keyword arguments)
+// first try the position where the same key was last found in any fixed map.
+// Fixed tables are hand-written C initialisers, so they can't be sorted or
+// hashed when building; this cache stands in for that.
+#ifndef MICROPY_OPT_MAP_LOOKUP_CACHE
+#define MICROPY_OPT_MAP_LOOKUP_CACHE (0)
+#endif
+
+// Number of entries in the fixed map lookup cache; must be a power of 2.
+#ifndef MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE
+#define MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE (128)
+#endif
+
+// Whether ordered maps in RAM (OrderedDict and friends) that grow past
+// MICROPY_OPT_MAP_ORDERED_INDEX_MIN entries get a hash index alongside their
+// insertion-ordered table, instead of being searched linearly.
+#ifndef MICROPY_OPT_MAP_ORDERED_INDEX
+#define MICROPY_OPT_MAP_ORDERED_INDEX (0)
+#endif
+
+#ifndef MICROPY_OPT_MAP_ORDERED_INDEX_MIN
+#define MICROPY_OPT_MAP_ORDERED_INDEX_MIN (16)
+#endif
+
 // Whether to use fast versions of bitwise operations (and, or, xor) when the
 // arguments are both positive.  Increases Thumb2 code size by about 250 bytes.
 #ifndef MICROPY_OPT_MPZ_BITWISE
@@ -1161,10 +1294,53 @@ typedef double mp_float_t;
 #define MICROPY_PY_UZLIB (0)
 #endif
 
+// Whether to provide uzlib.CompIO, which deflates what is written to it
+#ifndef MICROPY_PY_UZLIB_COMPRESS
+#define MICROPY_PY_UZLIB_COMPRESS (0)
+#endif
+
+// Window size CompIO uses when not given one, as a power of 2
+#ifndef MICROPY_PY_UZLIB_COMPRESS_WBITS
+#define MICROPY_PY_UZLIB_COMPRESS_WBITS (10)
+#endif
+
+// Number of bytes CompIO collects before writing them to its stream (at most 255)
+#ifndef MICROPY_PY_UZLIB_COMPRESS_BUF_SIZE
+#define MICROPY_PY_UZLIB_COMPRESS_BUF_SIZE (64)
+#endif
+
 #ifndef MICROPY_PY_UJSON
 #define MICROPY_PY_UJSON (0)
 #endif
 
+// Number of bytes ujson.load reads from its stream at a time, into a buffer
+// on the C stack
+#ifndef MICROPY_PY_UJSON_LOAD_BUF_SIZE
+#define MICROPY_PY_UJSON_LOAD_BUF_SIZE (64)
+#endif
+
+// Number of bytes ujson.dump collects before writing them to its stream, in a
+// buffer on the C stack
+#ifndef MICROPY_PY_UJSON_DUMP_BUF_SIZE
+#define MICROPY_PY_UJSON_DUMP_BUF_SIZE (64)
+#endif
+
+// Whether to provide ujson.tokenize, which parses a stream a piece at a time
+#ifndef MICROPY_PY_UJSON_TOKENIZE
+#define MICROPY_PY_UJSON_TOKENIZE (0)
+#endif
+
+// Deepest nesting of arrays and objects that ujson.tokenize follows
+#ifndef MICROPY_PY_UJSON_TOKENIZE_DEPTH
+#define MICROPY_PY_UJSON_TOKENIZE_DEPTH (64)
+#endif
+
+// Whether ujson.load and loads look for an existing qstr to use only for dict
+// keys, and allocate every other string without looking
+#ifndef MICROPY_PY_UJSON_QSTR_KEYS_ONLY
+#define MICROPY_PY_UJSON_QSTR_KEYS_ONLY (0)
+#endif
+
 #ifndef MICROPY_PY_URE
 #define MICROPY_PY_URE (0)
 #endif
@@ -1181,6 +1357,14 @@ typedef double mp_float_t;
 #define MICROPY_PY_URE_SUB (0)
 #endif
 
+// Match patterns that can branch with a Pike VM, which takes time linear in
+// the subject and no recursion, instead of by backtracking.  Each such pattern
+// keeps 2*len*(groups+1) pointers plus len words of RAM after its first match
+// so ports with little RAM should leave this off.
+#ifndef MICROPY_PY_URE_PIKEVM
+#define MICROPY_PY_URE_PIKEVM (0)
+#endif
+
 #ifndef MICROPY_PY_UHEAPQ
 #define MICROPY_PY_UHEAPQ (0)
 #endif
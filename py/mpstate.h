@@ -46,6 +46,7 @@ typedef struct mp_dynamic_compiler_t {
     uint8_t small_int_bits; // must be <= host small_int_bits
     bool opt_cache_map_lookup_in_bytecode;
     bool py_builtins_str_unicode;
+    bool opt_superinstructions;
 } mp_dynamic_compiler_t;
 extern mp_dynamic_compiler_t mp_dynamic_compiler;
 #endif
@@ -60,6 +61,24 @@ typedef struct _mp_sched_item_t {
     mp_obj_t arg;
 } mp_sched_item_t;
 
+#if MICROPY_OPT_TYPE_ATTR_CACHE
+// A cached result of looking up attr in type and its bases.  value is
+// MP_OBJ_NULL if the attr wasn't found and MP_OBJ_SENTINEL if it was a native
+// special method slot; otherwise it was found in found_type's locals.
+typedef struct _mp_type_attr_cache_entry_t {
+    const mp_obj_type_t *type;
+    const mp_obj_type_t *found_type;
+    mp_obj_t value;
+    size_t version;
+    #if MICROPY_OPT_TYPE_ATTR_CACHE_SEQ
+    // odd while the entry is being written
+    size_t seq;
+    #endif
+    uint16_t attr;
+    uint16_t meth_offset;
+} mp_type_attr_cache_entry_t;
+#endif
+
 // This structure hold information about the memory allocation system.
 typedef struct _mp_state_mem_t {
     #if MICROPY_MEM_STATS
@@ -94,11 +113,38 @@ typedef struct _mp_state_mem_t {
 
     size_t gc_first_free_atb_index;
     size_t gc_last_free_atb_index;
+    // For short-lived allocations of 1 to 4 blocks: the block before which there
+    // is no run of that many free blocks.
+    size_t gc_small_alloc_hint[4];
+
+    #if MICROPY_GC_INCREMENTAL
+    // Blocks from gc_sweep_block onwards have not been swept since the last
+    // collection; automatic collections leave them to the allocator.
+    size_t gc_sweep_block;
+    bool gc_defer_sweep;
+    // Work done between checks of the slice clock (0 for stop-the-world) and
+    // the longest a slice may run before yielding.
+    size_t gc_slice_blocks;
+    mp_uint_t gc_max_pause_us;
+    size_t gc_slice_work;
+    mp_uint_t gc_slice_start;
+    // Set while MICROPY_GC_INCREMENTAL_YIELD runs, which must not allocate.
+    bool gc_slice_yielding;
+    // Reported and reset by gc.pause_stats().
+    size_t gc_pause_slices;
+    mp_uint_t gc_pause_max_us;
+    #endif
 
     #if MICROPY_PY_GC_COLLECT_RETVAL
     size_t gc_collected;
     #endif
 
+    #if MICROPY_GC_TLAB
+    // Whether there is no free block for a thread allocation buffer until
+    // blocks are freed.
+    bool gc_tlab_exhausted;
+    #endif
+
     #if MICROPY_PY_THREAD
     // This is a global mutex used to make the GC thread-safe.
     mp_thread_mutex_t gc_mutex;
@@ -119,6 +165,11 @@ typedef struct _mp_state_vm_t {
 
     qstr_pool_t *last_pool;
 
+    #if MICROPY_QSTR_HASH_INDEX
+    // open-addressing index of the qstrs after the const pool
+    uint16_t *qstr_index;
+    #endif
+
     // non-heap memory for creating an exception if we can't allocate RAM
     mp_obj_exception_t mp_emergency_exception_obj;
 
@@ -201,6 +252,31 @@ typedef struct _mp_state_vm_t {
     size_t qstr_last_alloc;
     size_t qstr_last_used;
 
+    #if MICROPY_QSTR_HASH_INDEX
+    // number of slots in qstr_index, and the first qstr not yet in it
+    size_t qstr_index_alloc;
+    size_t qstr_index_top;
+    #endif
+
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    // Class lookup results; entries are only valid while their version matches
+    // type_attr_cache_version, so the cache needs no GC scanning or clearing.
+    mp_type_attr_cache_entry_t type_attr_cache[MICROPY_OPT_TYPE_ATTR_CACHE_SIZE];
+    size_t type_attr_cache_version;
+    size_t type_attr_cache_hits;
+    size_t type_attr_cache_misses;
+    #if MICROPY_OPT_TYPE_ATTR_CACHE_SEQ
+    // held by the thread writing an entry
+    mp_thread_mutex_t type_attr_cache_mutex;
+    #endif
+    #endif
+
+    #if MICROPY_OPT_MAP_LOOKUP_CACHE
+    // Position a key was last found at in a fixed map, indexed by the key; it
+    // is checked against the map before use so it never needs invalidating.
+    uint16_t map_lookup_cache[MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE];
+    #endif
+
     #if MICROPY_PY_THREAD
     // This is a global mutex used to make qstr interning thread-safe.
     mp_thread_mutex_t qstr_mutex;
@@ -210,6 +286,12 @@ typedef struct _mp_state_vm_t {
     mp_uint_t mp_optimise_value;
     #endif
 
+    #if MICROPY_GC_SNAPSHOT && MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+    // set once bytecode runs in place from outside the heap, which a heap
+    // snapshot can't hold
+    bool persistent_code_mapped;
+    #endif
+
     // size of the emergency exception buf, if it's dynamically allocated
     #if MICROPY_ENABLE_EMERGENCY_EXCEPTION_BUF && MICROPY_EMERGENCY_EXCEPTION_BUF_SIZE == 0
     mp_int_t mp_emergency_exception_buf_size;
@@ -246,6 +328,12 @@ typedef struct _mp_state_thread_t {
     uint8_t *pystack_cur;
     #endif
 
+    #if MICROPY_GC_TLAB
+    // Unused single-block heads set aside for this thread to allocate from.
+    byte *gc_tlab_cur;
+    byte *gc_tlab_end;
+    #endif
+
     ////////////////////////////////////////////////////////////
     // START ROOT POINTER SECTION
     // Everything that needs GC scanning must start here, and
@@ -314,10 +314,18 @@ STATIC mp_obj_t dict_popitem(mp_obj_t self_in) {
     if (next == NULL) {
         mp_raise_msg(&mp_type_KeyError, translate("popitem(): dictionary is empty"));
     }
-    self->map.used--;
     mp_obj_t items[] = {next->key, next->value};
-    next->key = MP_OBJ_SENTINEL; // must mark key as sentinel to indicate that it was deleted
-    next->value = MP_OBJ_NULL;
+    #if MICROPY_PY_COLLECTIONS_ORDEREDDICT
+    if (self->map.is_ordered) {
+        // an ordered array can't have holes, so shift the rest down
+        mp_map_lookup(&self->map, next->key, MP_MAP_LOOKUP_REMOVE_IF_FOUND);
+    } else
+    #endif
+    {
+        self->map.used--;
+        next->key = MP_OBJ_SENTINEL; // must mark key as sentinel to indicate that it was deleted
+        next->value = MP_OBJ_NULL;
+    }
     mp_obj_t tuple = mp_obj_new_tuple(2, items);
 
     return tuple;
@@ -33,6 +33,9 @@ typedef struct _mp_obj_fun_bc_t {
     mp_obj_dict_t *globals;         // the context within which this function was defined
     const byte *bytecode;           // bytecode for the function
     const mp_uint_t *const_table;   // constant table
+    #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+    const uint16_t *qstr_link;      // qstrs of bytecode run in place, else NULL
+    #endif
     // the following extra_args array is allocated space to take (in order):
     //  - values of positional default args (if any)
     //  - a single slot for default kw args dict (if it has them)
@@ -41,4 +44,13 @@ typedef struct _mp_obj_fun_bc_t {
     mp_obj_t extra_args[];
 } mp_obj_fun_bc_t;
 
+// functions of native code share the layout of bytecode ones
+#if MICROPY_EMIT_NATIVE
+extern const mp_obj_type_t mp_type_fun_native;
+extern const mp_obj_type_t mp_type_fun_viper;
+#endif
+#if MICROPY_EMIT_INLINE_ASM
+extern const mp_obj_type_t mp_type_fun_asm;
+#endif
+
 #endif // MICROPY_INCLUDED_PY_OBJFUN_H
@@ -35,11 +35,6 @@
 
 #if MICROPY_PY_BUILTINS_SET
 
-typedef struct _mp_obj_set_t {
-    mp_obj_base_t base;
-    mp_set_t set;
-} mp_obj_set_t;
-
 typedef struct _mp_obj_set_it_t {
     mp_obj_base_t base;
     mp_fun_1_t iternext;
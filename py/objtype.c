@@ -147,11 +147,37 @@ struct class_lookup_data {
     size_t meth_offset;
     mp_obj_t *dest;
     bool is_type;
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    // Filled in by the lookup so the result can be cached: where the attribute
+    // was found, and whether a native base's attr handler had to be asked.
+    const mp_obj_type_t *found_type;
+    mp_obj_t found_value;
+    bool uncacheable;
+    #endif
 };
 
-STATIC void mp_obj_class_lookup(struct class_lookup_data  *lookup, const mp_obj_type_t *type) {
-    assert(lookup->dest[0] == MP_OBJ_NULL);
-    assert(lookup->dest[1] == MP_OBJ_NULL);
+STATIC void class_lookup_found(struct class_lookup_data *lookup, const mp_obj_type_t *type, mp_obj_t value) {
+    if (lookup->is_type) {
+        // If we look up a class method, we need to return original type for which we
+        // do a lookup, not a (base) type in which we found the class method.
+        const mp_obj_type_t *org_type = (const mp_obj_type_t*)lookup->obj;
+        mp_convert_member_lookup(MP_OBJ_NULL, org_type, value, lookup->dest);
+    } else if (MP_OBJ_IS_TYPE(value, &mp_type_property)) {
+        lookup->dest[0] = value;
+    } else {
+        mp_obj_instance_t *obj = lookup->obj;
+        mp_obj_t obj_obj;
+        if (obj != NULL && mp_obj_is_native_type(type) && type != &mp_type_object /* object is not a real type */) {
+            // If we're dealing with native base class, then it applies to native sub-object
+            obj_obj = obj->subobj[0];
+        } else {
+            obj_obj = MP_OBJ_FROM_PTR(obj);
+        }
+        mp_convert_member_lookup(obj_obj, type, value, lookup->dest);
+    }
+}
+
+STATIC void class_lookup_walk(struct class_lookup_data *lookup, const mp_obj_type_t *type) {
     for (;;) {
         DEBUG_printf("mp_obj_class_lookup: Looking up %s in %s\n", qstr_str(lookup->attr), qstr_str(type->name));
         // Optimize special method lookup for native types
@@ -166,6 +192,10 @@ STATIC void mp_obj_class_lookup(struct class_lookup_data  *lookup, const mp_obj_
                 DEBUG_printf("mp_obj_class_lookup: Matched special meth slot (off=%d) for %s\n",
                     lookup->meth_offset, qstr_str(lookup->attr));
                 lookup->dest[0] = MP_OBJ_SENTINEL;
+                #if MICROPY_OPT_TYPE_ATTR_CACHE
+                lookup->found_type = type;
+                lookup->found_value = MP_OBJ_SENTINEL;
+                #endif
                 return;
             }
         }
@@ -176,25 +206,11 @@ STATIC void mp_obj_class_lookup(struct class_lookup_data  *lookup, const mp_obj_
             mp_map_t *locals_map = &type->locals_dict->map;
             mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(lookup->attr), MP_MAP_LOOKUP);
             if (elem != NULL) {
-                if (lookup->is_type) {
-                    // If we look up a class method, we need to return original type for which we
-                    // do a lookup, not a (base) type in which we found the class method.
-                    const mp_obj_type_t *org_type = (const mp_obj_type_t*)lookup->obj;
-                    mp_convert_member_lookup(MP_OBJ_NULL, org_type, elem->value, lookup->dest);
-                } else if (MP_OBJ_IS_TYPE(elem->value, &mp_type_property)) {
-                    lookup->dest[0] = elem->value;
-                    return;
-                } else {
-                    mp_obj_instance_t *obj = lookup->obj;
-                    mp_obj_t obj_obj;
-                    if (obj != NULL && mp_obj_is_native_type(type) && type != &mp_type_object /* object is not a real type */) {
-                        // If we're dealing with native base class, then it applies to native sub-object
-                        obj_obj = obj->subobj[0];
-                    } else {
-                        obj_obj = MP_OBJ_FROM_PTR(obj);
-                    }
-                    mp_convert_member_lookup(obj_obj, type, elem->value, lookup->dest);
-                }
+                #if MICROPY_OPT_TYPE_ATTR_CACHE
+                lookup->found_type = type;
+                lookup->found_value = elem->value;
+                #endif
+                class_lookup_found(lookup, type, elem->value);
 #if DEBUG_PRINT
                 printf("mp_obj_class_lookup: Returning: ");
                 mp_obj_print(lookup->dest[0], PRINT_REPR); printf(" ");
@@ -208,10 +224,17 @@ STATIC void mp_obj_class_lookup(struct class_lookup_data  *lookup, const mp_obj_
         // Previous code block takes care about attributes defined in .locals_dict,
         // but some attributes of native types may be handled using .load_attr method,
         // so make sure we try to lookup those too.
-        if (lookup->obj != NULL && !lookup->is_type && mp_obj_is_native_type(type) && type != &mp_type_object /* object is not a real type */) {
-            mp_load_method_maybe(lookup->obj->subobj[0], lookup->attr, lookup->dest);
-            if (lookup->dest[0] != MP_OBJ_NULL) {
-                return;
+        if (mp_obj_is_native_type(type) && type != &mp_type_object /* object is not a real type */) {
+            #if MICROPY_OPT_TYPE_ATTR_CACHE
+            // the result now depends on the native object, not just the types,
+            // and a lookup without one must not leave a miss for one with one
+            lookup->uncacheable = true;
+            #endif
+            if (lookup->obj != NULL && !lookup->is_type) {
+                mp_load_method_maybe(lookup->obj->subobj[0], lookup->attr, lookup->dest);
+                if (lookup->dest[0] != MP_OBJ_NULL) {
+                    return;
+                }
             }
         }
 
@@ -232,7 +255,7 @@ STATIC void mp_obj_class_lookup(struct class_lookup_data  *lookup, const mp_obj_
                     // Not a "real" type
                     continue;
                 }
-                mp_obj_class_lookup(lookup, bt);
+                class_lookup_walk(lookup, bt);
                 if (lookup->dest[0] != MP_OBJ_NULL) {
                     return;
                 }
@@ -252,6 +275,74 @@ STATIC void mp_obj_class_lookup(struct class_lookup_data  *lookup, const mp_obj_
     }
 }
 
+#if MICROPY_OPT_TYPE_ATTR_CACHE
+// Any change to a class's locals, and creating a class (which may reuse the
+// memory of a collected one), invalidates every cached lookup.
+#define TYPE_ATTR_CACHE_INVALIDATE() (MP_STATE_VM(type_attr_cache_version)++)
+#define TYPE_ATTR_CACHE_INDEX(type, attr) \
+    ((((uintptr_t)(type) >> 3) ^ ((attr) * 7)) & (MICROPY_OPT_TYPE_ATTR_CACHE_SIZE - 1))
+#else
+#define TYPE_ATTR_CACHE_INVALIDATE()
+#endif
+
+STATIC void mp_obj_class_lookup(struct class_lookup_data  *lookup, const mp_obj_type_t *type) {
+    assert(lookup->dest[0] == MP_OBJ_NULL);
+    assert(lookup->dest[1] == MP_OBJ_NULL);
+    #if MICROPY_OPT_TYPE_ATTR_CACHE
+    mp_type_attr_cache_entry_t *entry = &MP_STATE_VM(type_attr_cache)[TYPE_ATTR_CACHE_INDEX(type, lookup->attr)];
+    #if MICROPY_OPT_TYPE_ATTR_CACHE_SEQ
+    // Copy the entry, and only use the copy if no thread was writing the
+    // entry before or while it was copied.
+    size_t seq = entry->seq;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    mp_type_attr_cache_entry_t cached = *entry;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    const mp_type_attr_cache_entry_t *hit = (seq & 1) == 0 && entry->seq == seq ? &cached : NULL;
+    #else
+    const mp_type_attr_cache_entry_t *hit = entry;
+    #endif
+    if (hit != NULL && hit->type == type && hit->attr == lookup->attr && hit->meth_offset == lookup->meth_offset
+        && hit->version == MP_STATE_VM(type_attr_cache_version)) {
+        MP_STATE_VM(type_attr_cache_hits)++;
+        if (hit->value == MP_OBJ_SENTINEL) {
+            lookup->dest[0] = MP_OBJ_SENTINEL;
+        } else if (hit->value != MP_OBJ_NULL) {
+            class_lookup_found(lookup, hit->found_type, hit->value);
+        }
+        return;
+    }
+    MP_STATE_VM(type_attr_cache_misses)++;
+
+    lookup->found_type = NULL;
+    lookup->found_value = MP_OBJ_NULL;
+    lookup->uncacheable = false;
+    class_lookup_walk(lookup, type);
+    if (!lookup->uncacheable) {
+        #if MICROPY_OPT_TYPE_ATTR_CACHE_SEQ
+        // another thread is filling an entry, so leave this one uncached
+        if (!mp_thread_mutex_lock(&MP_STATE_VM(type_attr_cache_mutex), 0)) {
+            return;
+        }
+        entry->seq++;
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        #endif
+        entry->type = type;
+        entry->found_type = lookup->found_type;
+        entry->value = lookup->found_value;
+        entry->version = MP_STATE_VM(type_attr_cache_version);
+        entry->attr = lookup->attr;
+        entry->meth_offset = lookup->meth_offset;
+        #if MICROPY_OPT_TYPE_ATTR_CACHE_SEQ
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        entry->seq++;
+        mp_thread_mutex_unlock(&MP_STATE_VM(type_attr_cache_mutex));
+        #endif
+    }
+    #else
+    class_lookup_walk(lookup, type);
+    #endif
+}
+
 STATIC void instance_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
     mp_obj_instance_t *self = MP_OBJ_TO_PTR(self_in);
     qstr meth = (kind == PRINT_STR) ? MP_QSTR___str__ : MP_QSTR___repr__;
@@ -1075,6 +1166,7 @@ STATIC void type_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
                 // delete attribute
                 mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP_REMOVE_IF_FOUND);
                 if (elem != NULL) {
+                    TYPE_ATTR_CACHE_INVALIDATE();
                     dest[0] = MP_OBJ_NULL; // indicate success
                 }
             } else {
@@ -1094,6 +1186,7 @@ STATIC void type_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
                 // store attribute
                 mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
                 elem->value = dest[1];
+                TYPE_ATTR_CACHE_INVALIDATE();
                 dest[0] = MP_OBJ_NULL; // indicate success
             }
         }
@@ -1211,6 +1304,8 @@ mp_obj_t mp_obj_new_type(qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict)
         }
     }
 
+    TYPE_ATTR_CACHE_INVALIDATE();
+
     return MP_OBJ_FROM_PTR(o);
 }
 
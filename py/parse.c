@@ -1202,6 +1202,10 @@ void mp_parse_tree_clear(mp_parse_tree_t *tree) {
         m_del(byte, chunk, sizeof(mp_parse_chunk_t) + chunk->alloc);
         chunk = next;
     }
+    // Don't leave the caller's tree pointing at freed memory: it is usually a
+    // local that outlives the compile, and once the memory is reused it would
+    // keep whatever object lands there reachable.
+    tree->chunk = NULL;
 }
 
 #endif // MICROPY_ENABLE_COMPILER
@@ -48,12 +48,17 @@
 #define MPY_FEATURE_FLAGS ( \
     ((MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE) << 0) \
     | ((MICROPY_PY_BUILTINS_STR_UNICODE) << 1) \
+    | ((MICROPY_OPT_SUPERINSTRUCTIONS) << 2) \
     )
 // This is a version of the flags that can be configured at runtime.
 #define MPY_FEATURE_FLAGS_DYNAMIC ( \
     ((MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE_DYNAMIC) << 0) \
     | ((MICROPY_PY_BUILTINS_STR_UNICODE_DYNAMIC) << 1) \
+    | ((MICROPY_OPT_SUPERINSTRUCTIONS_DYNAMIC) << 2) \
     )
+// Flags that a file may leave clear even if they are set in MPY_FEATURE_FLAGS:
+// a VM that runs superinstructions also runs bytecode without them.
+#define MPY_FEATURE_FLAGS_OPTIONAL ((MICROPY_OPT_SUPERINSTRUCTIONS) << 2)
 
 #if MICROPY_PERSISTENT_CODE_LOAD || (MICROPY_PERSISTENT_CODE_SAVE && !MICROPY_DYNAMIC_COMPILER)
 // The bytecode will depend on the number of bits in a small-int, and
@@ -181,11 +186,59 @@ STATIC void load_bytecode_qstrs(mp_reader_t *reader, byte *ip, byte *ip_top) {
     }
 }
 
-STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader) {
+#if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+// mpy-cross numbers the qstr slots of saved bytecode by the order in which the
+// qstrs follow it: 0 for simple_name, 1 for source_file, then 2, 3, ... for
+// the operands.  Bytecode numbered like that can run in place with the qstrs
+// in a link table; return the table, or NULL if the numbering doesn't match
+// (eg the file was made by an older mpy-cross) and nothing has been read.
+STATIC uint16_t *load_qstr_link(mp_reader_t *reader, const byte *ip2, const byte *ip, const byte *ip_top) {
+    if ((ip2[0] | (ip2[1] << 8)) != 0 || (ip2[2] | (ip2[3] << 8)) != 1) {
+        return NULL;
+    }
+    size_t n_qstr = 2;
+    for (const byte *p = ip; p < ip_top;) {
+        size_t sz;
+        uint f = mp_opcode_format(p, &sz);
+        if (f == MP_OPCODE_QSTR) {
+            if ((size_t)(p[1] | (p[2] << 8)) != n_qstr) {
+                return NULL;
+            }
+            ++n_qstr;
+        }
+        p += sz;
+    }
+    uint16_t *qstr_link = m_new(uint16_t, n_qstr);
+    for (size_t i = 0; i < n_qstr; ++i) {
+        qstr_link[i] = load_qstr(reader);
+    }
+    return qstr_link;
+}
+#endif
+
+// If n_in_place is not NULL the reader was made by mp_reader_new_mem over
+// memory that stays mapped, and bytecode that can run in place is left there;
+// n_in_place is incremented for each such raw code.
+STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader, size_t *n_in_place) {
     // load bytecode
     size_t bc_len = read_uint(reader);
-    byte *bytecode = m_new(byte, bc_len);
-    read_bytes(reader, bytecode, bc_len);
+    byte *bytecode;
+    #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+    const byte *mapped = NULL;
+    if (n_in_place != NULL) {
+        mapped = mp_reader_mem_skip(reader, bc_len);
+        if (mapped == NULL) {
+            raise_corrupt_mpy();
+        }
+        bytecode = (byte*)mapped; // not written to unless copied below
+    } else
+    #else
+    (void)n_in_place;
+    #endif
+    {
+        bytecode = m_new(byte, bc_len);
+        read_bytes(reader, bytecode, bc_len);
+    }
 
     // extract prelude
     const byte *ip = bytecode;
@@ -193,12 +246,30 @@ STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader) {
     bytecode_prelude_t prelude;
     extract_prelude(&ip, &ip2, &prelude);
 
-    // load qstrs and link global qstr ids into bytecode
-    qstr simple_name = load_qstr(reader);
-    qstr source_file = load_qstr(reader);
-    ((byte*)ip2)[0] = simple_name; ((byte*)ip2)[1] = simple_name >> 8;
-    ((byte*)ip2)[2] = source_file; ((byte*)ip2)[3] = source_file >> 8;
-    load_bytecode_qstrs(reader, (byte*)ip, bytecode + bc_len);
+    #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+    const uint16_t *qstr_link = NULL;
+    if (mapped != NULL) {
+        qstr_link = load_qstr_link(reader, ip2, ip, mapped + bc_len);
+        if (qstr_link != NULL) {
+            ++*n_in_place;
+        } else {
+            // link the qstrs into a copy as for any other reader
+            bytecode = m_new(byte, bc_len);
+            memcpy(bytecode, mapped, bc_len);
+            ip = bytecode + (ip - mapped);
+            ip2 = bytecode + (ip2 - mapped);
+        }
+    }
+    if (qstr_link == NULL)
+    #endif
+    {
+        // load qstrs and link global qstr ids into bytecode
+        qstr simple_name = load_qstr(reader);
+        qstr source_file = load_qstr(reader);
+        ((byte*)ip2)[0] = simple_name; ((byte*)ip2)[1] = simple_name >> 8;
+        ((byte*)ip2)[2] = source_file; ((byte*)ip2)[3] = source_file >> 8;
+        load_bytecode_qstrs(reader, (byte*)ip, bytecode + bc_len);
+    }
 
     // load constant table
     size_t n_obj = read_uint(reader);
@@ -212,7 +283,7 @@ STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader) {
         *ct++ = (mp_uint_t)load_obj(reader);
     }
     for (size_t i = 0; i < n_raw_code; ++i) {
-        *ct++ = (mp_uint_t)(uintptr_t)load_raw_code(reader);
+        *ct++ = (mp_uint_t)(uintptr_t)load_raw_code(reader, n_in_place);
     }
 
     // create raw_code and return it
@@ -226,35 +297,103 @@ STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader) {
         n_obj, n_raw_code,
         #endif
         prelude.scope_flags);
+    #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+    rc->data.u_byte.qstr_link = qstr_link;
+    #endif
     return rc;
 }
 
-mp_raw_code_t *mp_raw_code_load(mp_reader_t *reader) {
+STATIC mp_raw_code_t *raw_code_load(mp_reader_t *reader, size_t *n_in_place) {
     byte header[4];
     read_bytes(reader, header, sizeof(header));
     if (header[0] != 'M'
         || header[1] != MPY_VERSION
-        || header[2] != MPY_FEATURE_FLAGS
+        || (header[2] | MPY_FEATURE_FLAGS_OPTIONAL) != MPY_FEATURE_FLAGS
         || header[3] > mp_small_int_bits()) {
         mp_raise_MpyError(translate("Incompatible .mpy file. Please update all .mpy files. See http://adafru.it/mpy-update for more info."));
     }
-    mp_raw_code_t *rc = load_raw_code(reader);
+    mp_raw_code_t *rc = load_raw_code(reader, n_in_place);
     reader->close(reader->data);
     return rc;
 }
 
+mp_raw_code_t *mp_raw_code_load(mp_reader_t *reader) {
+    return raw_code_load(reader, NULL);
+}
+
 mp_raw_code_t *mp_raw_code_load_mem(const byte *buf, size_t len) {
     mp_reader_t reader;
     mp_reader_new_mem(&reader, buf, len, 0);
     return mp_raw_code_load(&reader);
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+mp_raw_code_t *mp_raw_code_load_mapped(const byte *buf, size_t len, size_t *n_in_place) {
+    mp_reader_t reader;
+    mp_reader_new_mem(&reader, buf, len, 0);
+    *n_in_place = 0;
+    mp_raw_code_t *rc = raw_code_load(&reader, n_in_place);
+    #if MICROPY_GC_SNAPSHOT
+    if (*n_in_place > 0) {
+        MP_STATE_VM(persistent_code_mapped) = true;
+    }
+    #endif
+    return rc;
+}
+#endif
+
+#if MICROPY_PERSISTENT_CODE_LOAD_MAPPED && MICROPY_READER_POSIX
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "py/nlr.h"
+
+mp_raw_code_t *mp_raw_code_load_file(const char *filename) {
+    // Run the file from the page cache if it can be mapped.  The mapping has
+    // to outlive any code that runs from it so it is only dropped if loading
+    // fails or nothing was left in place.
+    int fd = open(filename, O_RDONLY, 0644);
+    if (fd >= 0) {
+        struct stat st;
+        void *buf = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            buf = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if (buf != MAP_FAILED) {
+            nlr_buf_t nlr;
+            if (nlr_push(&nlr) == 0) {
+                size_t n_in_place;
+                mp_raw_code_t *rc = mp_raw_code_load_mapped(buf, st.st_size, &n_in_place);
+                nlr_pop();
+                if (n_in_place == 0) {
+                    munmap(buf, st.st_size);
+                }
+                return rc;
+            } else {
+                munmap(buf, st.st_size);
+                nlr_jump(nlr.ret_val);
+            }
+        }
+    }
+    mp_reader_t reader;
+    mp_reader_new_file(&reader, filename);
+    return mp_raw_code_load(&reader);
+}
+
+#else
+
 mp_raw_code_t *mp_raw_code_load_file(const char *filename) {
     mp_reader_t reader;
     mp_reader_new_file(&reader, filename);
     return mp_raw_code_load(&reader);
 }
 
+#endif
+
 #endif // MICROPY_PERSISTENT_CODE_LOAD
 
 #if MICROPY_PERSISTENT_CODE_SAVE
@@ -337,21 +476,45 @@ STATIC void save_bytecode_qstrs(mp_print_t *print, const byte *ip, const byte *i
     }
 }
 
+// Number the qstr slots in a copy of the bytecode in the order the qstrs are
+// saved, so a loader can run it in place (see load_qstr_link).
+STATIC void number_bytecode_qstrs(byte *ip2, byte *ip, const byte *ip_top) {
+    ip2[0] = 0; ip2[1] = 0; // simple_name
+    ip2[2] = 1; ip2[3] = 0; // source_file
+    size_t n_qstr = 2;
+    while (ip < ip_top) {
+        size_t sz;
+        uint f = mp_opcode_format(ip, &sz);
+        if (f == MP_OPCODE_QSTR) {
+            ip[1] = n_qstr;
+            ip[2] = n_qstr >> 8;
+            ++n_qstr;
+        }
+        ip += sz;
+    }
+}
+
 STATIC void save_raw_code(mp_print_t *print, mp_raw_code_t *rc) {
     if (rc->kind != MP_CODE_BYTECODE) {
         mp_raise_ValueError(translate("can only save bytecode"));
     }
 
-    // save bytecode
-    mp_print_uint(print, rc->data.u_byte.bc_len);
-    mp_print_bytes(print, rc->data.u_byte.bytecode, rc->data.u_byte.bc_len);
-
     // extract prelude
     const byte *ip = rc->data.u_byte.bytecode;
     const byte *ip2;
     bytecode_prelude_t prelude;
     extract_prelude(&ip, &ip2, &prelude);
 
+    // save bytecode, with its qstr slots numbered
+    const byte *bytecode = rc->data.u_byte.bytecode;
+    size_t bc_len = rc->data.u_byte.bc_len;
+    byte *numbered = m_new(byte, bc_len);
+    memcpy(numbered, bytecode, bc_len);
+    number_bytecode_qstrs(numbered + (ip2 - bytecode), numbered + (ip - bytecode), numbered + bc_len);
+    mp_print_uint(print, bc_len);
+    mp_print_bytes(print, numbered, bc_len);
+    m_del(byte, numbered, bc_len);
+
     // save qstrs
     save_qstr(print, ip2[0] | (ip2[1] << 8)); // simple_name
     save_qstr(print, ip2[2] | (ip2[3] << 8)); // source_file
@@ -34,6 +34,11 @@ mp_raw_code_t *mp_raw_code_load(mp_reader_t *reader);
 mp_raw_code_t *mp_raw_code_load_mem(const byte *buf, size_t len);
 mp_raw_code_t *mp_raw_code_load_file(const char *filename);
 
+// Load a .mpy from memory that stays mapped for as long as its code may run,
+// running bytecode from there where the file allows it.  n_in_place is set to
+// the number of raw codes that do; if it is 0 the memory is no longer needed.
+mp_raw_code_t *mp_raw_code_load_mapped(const byte *buf, size_t len, size_t *n_in_place);
+
 void mp_raw_code_save(mp_raw_code_t *rc, mp_print_t *print);
 void mp_raw_code_save_file(mp_raw_code_t *rc, const char *filename);
 
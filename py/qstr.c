@@ -33,9 +33,10 @@
 #include "py/qstr.h"
 #include "py/gc.h"
 
-// NOTE: we are using linear arrays to store and search for qstr's (unique strings, interned strings)
-// ultimately we will replace this with a static hash table of some kind
-// also probably need to include the length in the string data, to allow null bytes in the string
+// NOTE: we are using linear arrays to store qstr's (unique strings, interned strings).
+// With MICROPY_QSTR_HASH_INDEX they are also found through open-addressing tables of
+// qstr ids: one for the const pool generated by makeqstrdata.py, and one in the heap
+// for everything after it which is extended as qstrs are added.
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
 #define DEBUG_printf DEBUG_printf
@@ -81,13 +82,16 @@
 #define QSTR_EXIT()
 #endif
 
-// this must match the equivalent function in makeqstrdata.py
-mp_uint_t qstr_compute_hash(const byte *data, size_t len) {
+STATIC uint32_t qstr_compute_full_hash(const byte *data, size_t len) {
     // djb2 algorithm; see http://www.cse.yorku.ca/~oz/hash.html
-    mp_uint_t hash = 5381;
+    uint32_t hash = 5381;
     for (const byte *top = data + len; data < top; data++) {
         hash = ((hash << 5) + hash) ^ (*data); // hash * 33 ^ data
     }
+    return hash;
+}
+
+STATIC mp_uint_t qstr_mask_hash(uint32_t hash) {
     hash &= Q_HASH_MASK;
     // Make sure that valid hash is never zero, zero means "hash not computed"
     if (hash == 0) {
@@ -96,6 +100,11 @@ mp_uint_t qstr_compute_hash(const byte *data, size_t len) {
     return hash;
 }
 
+// this must match the equivalent function in makeqstrdata.py
+mp_uint_t qstr_compute_hash(const byte *data, size_t len) {
+    return qstr_mask_hash(qstr_compute_full_hash(data, len));
+}
+
 const qstr_pool_t mp_qstr_const_pool = {
     NULL,               // no previous pool
     0,                  // no previous pool
@@ -119,10 +128,112 @@ extern const qstr_pool_t MICROPY_QSTR_EXTRA_POOL;
 #define CONST_POOL mp_qstr_const_pool
 #endif
 
+#if MICROPY_QSTR_HASH_INDEX
+
+#ifndef NO_QSTR
+#include "genhdr/qstrindex.generated.h"
+#else
+#define QSTR_ROM_INDEX_SIZE (1)
+const uint16_t qstr_rom_index[QSTR_ROM_INDEX_SIZE];
+#endif
+
+// The heap index is grown when it would become more than 3/4 full. Its size is
+// limited so that qstr_index_slot stays within 32 bits.
+#define QSTR_INDEX_MIN_ALLOC (32)
+#define QSTR_INDEX_MAX_ALLOC (0x10000)
+
+// this must match the equivalent function in makeqstrdata.py
+STATIC uint32_t qstr_index_hash(uint32_t full_hash) {
+    // mix so that the top bits, which pick the slot, depend on every byte
+    full_hash ^= full_hash >> 16;
+    full_hash *= 0x45d9f3b;
+    full_hash ^= full_hash >> 16;
+    return full_hash;
+}
+
+STATIC inline size_t qstr_index_slot(uint32_t index_hash, size_t size) {
+    return ((index_hash >> 16) * size) >> 16;
+}
+
+STATIC void qstr_index_insert(uint16_t *index, size_t alloc, const byte *q_ptr, qstr q) {
+    uint32_t index_hash = qstr_index_hash(qstr_compute_full_hash(Q_GET_DATA(q_ptr), Q_GET_LENGTH(q_ptr)));
+    for (size_t slot = qstr_index_slot(index_hash, alloc); ; ) {
+        if (index[slot] == 0) {
+            index[slot] = q;
+            return;
+        }
+        if (++slot == alloc) {
+            slot = 0;
+        }
+    }
+}
+
+// Index the qstrs added since the last call. If the index can't grow then the
+// rest are left for qstr_find_strn to search linearly.
+// qstr_mutex must be taken while in this function
+STATIC void qstr_index_update(void) {
+    size_t top = MP_STATE_VM(qstr_index_top);
+    size_t total = QSTR_TOTAL();
+    if (total > 0xffff) {
+        total = 0xffff;
+    }
+    if (top >= total) {
+        return;
+    }
+
+    size_t alloc = MP_STATE_VM(qstr_index_alloc);
+    if ((total - MP_QSTRnumber_of) * 4 > alloc * 3) {
+        size_t new_alloc = alloc == 0 ? QSTR_INDEX_MIN_ALLOC : alloc;
+        while ((total - MP_QSTRnumber_of) * 4 > new_alloc * 3 && new_alloc < QSTR_INDEX_MAX_ALLOC) {
+            new_alloc *= 2;
+        }
+        if ((total - MP_QSTRnumber_of) * 4 > new_alloc * 3) {
+            // the index is as large as it gets so only fill it up
+            total = MP_QSTRnumber_of + new_alloc * 3 / 4;
+            if (top >= total) {
+                return;
+            }
+        }
+        if (new_alloc != alloc) {
+            uint16_t *new_index = m_new_ll_maybe(uint16_t, new_alloc);
+            if (new_index == NULL) {
+                return;
+            }
+            memset(new_index, 0, new_alloc * sizeof(uint16_t));
+            for (qstr_pool_t *pool = MP_STATE_VM(last_pool); pool->total_prev_len >= MP_QSTRnumber_of; pool = pool->prev) {
+                for (size_t i = 0; i < pool->len && pool->total_prev_len + i < top; i++) {
+                    qstr_index_insert(new_index, new_alloc, pool->qstrs[i], pool->total_prev_len + i);
+                }
+            }
+            m_del(uint16_t, MP_STATE_VM(qstr_index), alloc);
+            MP_STATE_VM(qstr_index) = new_index;
+            MP_STATE_VM(qstr_index_alloc) = new_alloc;
+        }
+    }
+
+    for (qstr_pool_t *pool = MP_STATE_VM(last_pool); pool->total_prev_len + pool->len > top; pool = pool->prev) {
+        for (size_t i = 0; i < pool->len; i++) {
+            qstr q = pool->total_prev_len + i;
+            if (q >= top && q < total) {
+                qstr_index_insert(MP_STATE_VM(qstr_index), MP_STATE_VM(qstr_index_alloc), pool->qstrs[i], q);
+            }
+        }
+    }
+    MP_STATE_VM(qstr_index_top) = total;
+}
+
+#endif
+
 void qstr_init(void) {
     MP_STATE_VM(last_pool) = (qstr_pool_t*)&CONST_POOL; // we won't modify the const_pool since it has no allocated room left
     MP_STATE_VM(qstr_last_chunk) = NULL;
 
+    #if MICROPY_QSTR_HASH_INDEX
+    MP_STATE_VM(qstr_index) = NULL;
+    MP_STATE_VM(qstr_index_alloc) = 0;
+    MP_STATE_VM(qstr_index_top) = MP_QSTRnumber_of;
+    #endif
+
     #if MICROPY_PY_THREAD
     mp_thread_mutex_init(&MP_STATE_VM(qstr_mutex));
     #endif
@@ -164,16 +275,66 @@ STATIC qstr qstr_add(const byte *q_ptr) {
     // add the new qstr
     MP_STATE_VM(last_pool)->qstrs[MP_STATE_VM(last_pool)->len++] = q_ptr;
 
+    #if MICROPY_QSTR_HASH_INDEX
+    qstr_index_update();
+    #endif
+
     // return id for the newly-added qstr
     return MP_STATE_VM(last_pool)->total_prev_len + MP_STATE_VM(last_pool)->len - 1;
 }
 
-qstr qstr_find_strn(const char *str, size_t str_len) {
+// qstr_mutex must be taken while in this function, as another thread adding a
+// qstr may replace the heap index
+STATIC qstr qstr_find_strn_locked(const char *str, size_t str_len) {
     // work out hash of str
-    mp_uint_t str_hash = qstr_compute_hash((const byte*)str, str_len);
+    uint32_t full_hash = qstr_compute_full_hash((const byte*)str, str_len);
+    mp_uint_t str_hash = qstr_mask_hash(full_hash);
+
+    #if MICROPY_QSTR_HASH_INDEX
+    uint32_t index_hash = qstr_index_hash(full_hash);
+
+    // probe the const pool index
+    for (size_t slot = qstr_index_slot(index_hash, QSTR_ROM_INDEX_SIZE); ; ) {
+        qstr q = qstr_rom_index[slot];
+        if (q == 0) {
+            break;
+        }
+        const byte *qd = mp_qstr_const_pool.qstrs[q];
+        if (Q_GET_HASH(qd) == str_hash && Q_GET_LENGTH(qd) == str_len && memcmp(Q_GET_DATA(qd), str, str_len) == 0) {
+            return q;
+        }
+        if (++slot == QSTR_ROM_INDEX_SIZE) {
+            slot = 0;
+        }
+    }
+
+    // probe the heap index
+    uint16_t *index = MP_STATE_VM(qstr_index);
+    size_t alloc = MP_STATE_VM(qstr_index_alloc);
+    if (index != NULL) {
+        for (size_t slot = qstr_index_slot(index_hash, alloc); ; ) {
+            qstr q = index[slot];
+            if (q == 0) {
+                break;
+            }
+            const byte *qd = find_qstr(q);
+            if (Q_GET_HASH(qd) == str_hash && Q_GET_LENGTH(qd) == str_len && memcmp(Q_GET_DATA(qd), str, str_len) == 0) {
+                return q;
+            }
+            if (++slot == alloc) {
+                slot = 0;
+            }
+        }
+    }
+
+    // anything not indexed yet is searched linearly below
+    size_t top = MP_STATE_VM(qstr_index_top);
+    #else
+    size_t top = 0;
+    #endif
 
     // search pools for the data
-    for (qstr_pool_t *pool = MP_STATE_VM(last_pool); pool != NULL; pool = pool->prev) {
+    for (qstr_pool_t *pool = MP_STATE_VM(last_pool); pool != NULL && pool->total_prev_len + pool->len > top; pool = pool->prev) {
         for (const byte **q = pool->qstrs, **q_top = pool->qstrs + pool->len; q < q_top; q++) {
             if (Q_GET_HASH(*q) == str_hash && Q_GET_LENGTH(*q) == str_len && memcmp(Q_GET_DATA(*q), str, str_len) == 0) {
                 return pool->total_prev_len + (q - pool->qstrs);
@@ -185,6 +346,13 @@ qstr qstr_find_strn(const char *str, size_t str_len) {
     return 0;
 }
 
+qstr qstr_find_strn(const char *str, size_t str_len) {
+    QSTR_ENTER();
+    qstr q = qstr_find_strn_locked(str, str_len);
+    QSTR_EXIT();
+    return q;
+}
+
 qstr qstr_from_str(const char *str) {
     return qstr_from_strn(str, strlen(str));
 }
@@ -192,7 +360,7 @@ qstr qstr_from_str(const char *str) {
 qstr qstr_from_strn(const char *str, size_t len) {
     assert(len < (1 << (8 * MICROPY_QSTR_BYTES_IN_LEN)));
     QSTR_ENTER();
-    qstr q = qstr_find_strn(str, len);
+    qstr q = qstr_find_strn_locked(str, len);
     if (q == 0) {
         // qstr does not exist in interned pool so need to add it
 
@@ -66,6 +66,16 @@ void mp_reader_new_mem(mp_reader_t *reader, const byte *buf, size_t len, size_t
     reader->close = mp_reader_mem_close;
 }
 
+const byte *mp_reader_mem_skip(mp_reader_t *reader, size_t len) {
+    mp_reader_mem_t *rm = (mp_reader_mem_t*)reader->data;
+    if ((size_t)(rm->end - rm->cur) < len) {
+        return NULL;
+    }
+    const byte *buf = rm->cur;
+    rm->cur += len;
+    return buf;
+}
+
 #if MICROPY_READER_POSIX
 
 #include <sys/stat.h>
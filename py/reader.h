@@ -40,6 +40,9 @@ typedef struct _mp_reader_t {
 } mp_reader_t;
 
 void mp_reader_new_mem(mp_reader_t *reader, const byte *buf, size_t len, size_t free_len);
+// For a reader made by mp_reader_new_mem: return a pointer to the next len
+// bytes and move past them, or NULL if fewer than len bytes remain.
+const byte *mp_reader_mem_skip(mp_reader_t *reader, size_t len);
 void mp_reader_new_file(mp_reader_t *reader, const char *filename);
 void mp_reader_new_file_from_fd(mp_reader_t *reader, int fd, bool close_fd);
 
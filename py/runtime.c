@@ -102,6 +102,10 @@ void mp_init(void) {
     MP_STATE_VM(mp_optimise_value) = 0;
     #endif
 
+    #if MICROPY_GC_SNAPSHOT && MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+    MP_STATE_VM(persistent_code_mapped) = false;
+    #endif
+
     // init global module dict
     mp_obj_dict_init(&MP_STATE_VM(mp_loaded_modules_dict), 3);
 
@@ -135,6 +139,10 @@ void mp_init(void) {
     mp_thread_mutex_init(&MP_STATE_VM(gil_mutex));
     #endif
 
+    #if MICROPY_OPT_TYPE_ATTR_CACHE_SEQ
+    mp_thread_mutex_init(&MP_STATE_VM(type_attr_cache_mutex));
+    #endif
+
     MP_THREAD_GIL_ENTER();
 }
 
@@ -532,6 +532,46 @@ const byte *mp_bytecode_print_str(const byte *ip) {
             printf("IMPORT_STAR");
             break;
 
+        case MP_BC_LOAD_FAST_LOAD_FAST:
+            printf("LOAD_FAST_LOAD_FAST " UINT_FMT " " UINT_FMT, (mp_uint_t)ip[0] >> 4, (mp_uint_t)ip[0] & 0xf);
+            ip += 1;
+            break;
+
+        case MP_BC_BINARY_OP_SMALL_INT:
+            printf("BINARY_OP_SMALL_INT " UINT_FMT " %s " INT_FMT,
+                (mp_uint_t)ip[0], qstr_str(mp_binary_op_method_name[ip[0]]), (mp_int_t)ip[1] - 16);
+            ip += 2;
+            break;
+
+        case MP_BC_BINARY_OP_POP_JUMP_IF_TRUE:
+        case MP_BC_BINARY_OP_POP_JUMP_IF_FALSE: {
+            mp_uint_t op = *ip++;
+            DECODE_SLABEL;
+            printf("BINARY_OP_POP_JUMP_IF_%s " UINT_FMT " %s " UINT_FMT,
+                ip[-4] == MP_BC_BINARY_OP_POP_JUMP_IF_TRUE ? "TRUE" : "FALSE",
+                op, qstr_str(mp_binary_op_method_name[op]), (mp_uint_t)(ip + unum - mp_showbc_code_start));
+            break;
+        }
+
+        case MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_TRUE:
+        case MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_FALSE: {
+            mp_uint_t op = *ip++;
+            mp_int_t arg = (mp_int_t)*ip++ - 16;
+            DECODE_SLABEL;
+            printf("BINARY_OP_SMALL_INT_POP_JUMP_IF_%s " UINT_FMT " %s " INT_FMT " " UINT_FMT,
+                ip[-5] == MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_TRUE ? "TRUE" : "FALSE",
+                op, qstr_str(mp_binary_op_method_name[op]), arg, (mp_uint_t)(ip + unum - mp_showbc_code_start));
+            break;
+        }
+
+        case MP_BC_DUP_TOP_TWO_LOAD_SUBSCR:
+            printf("DUP_TOP_TWO_LOAD_SUBSCR");
+            break;
+
+        case MP_BC_ROT_THREE_STORE_SUBSCR:
+            printf("ROT_THREE_STORE_SUBSCR");
+            break;
+
         default:
             if (ip[-1] < MP_BC_LOAD_CONST_SMALL_INT_MULTI + 64) {
                 printf("LOAD_CONST_SMALL_INT " INT_FMT, (mp_int_t)ip[-1] - MP_BC_LOAD_CONST_SMALL_INT_MULTI - 16);
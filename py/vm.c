@@ -30,8 +30,10 @@
 #include <assert.h>
 
 #include "py/emitglue.h"
+#include "py/objlist.h"
 #include "py/objtype.h"
 #include "py/runtime.h"
+#include "py/smallint.h"
 #include "py/bc0.h"
 #include "py/bc.h"
 
@@ -58,9 +60,23 @@
 
 #if MICROPY_PERSISTENT_CODE
 
+#if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+// Bytecode run in place from a mapped .mpy has its qstrs numbered and looked up
+// in the function's link table.  It may be read-only, so the map lookup caches
+// in it are not written.
+#define DECODE_QSTR \
+    qstr qst = ip[0] | ip[1] << 8; \
+    ip += 2; \
+    if (code_state->fun_bc->qstr_link != NULL) { \
+        qst = code_state->fun_bc->qstr_link[qst]; \
+    }
+#define CACHE_WRITABLE() (code_state->fun_bc->qstr_link == NULL)
+#else
 #define DECODE_QSTR \
     qstr qst = ip[0] | ip[1] << 8; \
     ip += 2;
+#define CACHE_WRITABLE() (1)
+#endif
 #define DECODE_PTR \
     DECODE_UINT; \
     void *ptr = (void*)(uintptr_t)code_state->fun_bc->const_table[unum]
@@ -70,6 +86,7 @@
 
 #else
 
+#define CACHE_WRITABLE() (1)
 #define DECODE_QSTR qstr qst = 0; \
     do { \
         qst = (qst << 7) + (*ip & 0x7f); \
@@ -110,6 +127,135 @@
     exc_sp--; /* pop back to previous exception handler */ \
     CLEAR_SYS_EXC_INFO() /* just clear sys.exc_info(), not compliant, but it shouldn't be used in 1st place */
 
+#if MICROPY_OPT_QUICKEN_BYTECODE
+
+// Bytecode is only quickened if it lives in the GC heap; anything else may be
+// in ROM, or shared with other users of a mapped .mpy file.
+#define QUICKEN_ALLOWED() ( \
+    code_state->fun_bc->bytecode >= MP_STATE_MEM(gc_pool_start) \
+    && code_state->fun_bc->bytecode < MP_STATE_MEM(gc_pool_end))
+
+// Replace the opcode that is currently executing (ip has already been advanced
+// past it); it must have the same size and stack effect as the current one.
+#define QUICKEN(opcode) do { \
+    if (quicken_allowed) { \
+        *(byte*)(ip - 1) = (opcode); \
+    } \
+} while (0)
+
+// A quickened opcode in bytecode that can't have been quickened is invalid,
+// and writing back the generic opcode could fault.
+#define QUICK_CHECK_ALLOWED() \
+    if (!quicken_allowed) { \
+        goto bytecode_not_implemented; \
+    }
+
+// Called by the generic binary op when both arguments are small ints.
+#define QUICKEN_BINARY_OP(op) do { \
+    byte quick_opcode = mp_quick_binary_op_small_int(op); \
+    if (quick_opcode != MP_BC_BINARY_OP_MULTI + (op)) { \
+        QUICKEN(quick_opcode); \
+    } \
+} while (0)
+
+// Write back the generic opcode and execute it again from the start; used by a
+// quickened opcode whose arguments are not of the type it specialises on.
+// Not wrapped in do-while because DISPATCH() may be a break out of the switch.
+#define DEOPTIMISE(opcode) { \
+    *(byte*)(ip - 1) = (opcode); \
+    ip--; \
+    DISPATCH(); \
+}
+
+#define QUICK_SMALL_INT_OPERANDS(op) \
+    MARK_EXC_IP_SELECTIVE(); \
+    QUICK_CHECK_ALLOWED(); \
+    if (!MP_OBJ_IS_SMALL_INT(sp[0]) || !MP_OBJ_IS_SMALL_INT(sp[-1])) { \
+        DEOPTIMISE(MP_BC_BINARY_OP_MULTI + (op)); \
+    } \
+    mp_int_t rhs_val = MP_OBJ_SMALL_INT_VALUE(POP()); \
+    mp_int_t lhs_val = MP_OBJ_SMALL_INT_VALUE(TOP())
+
+// The sum or difference of two small ints always fits in an mp_int_t, so only
+// the result needs checking; if it overflows the runtime makes a long int.
+#define QUICK_SMALL_INT_ARITH(op, res) do { \
+    if (MP_SMALL_INT_FITS(res)) { \
+        SET_TOP(MP_OBJ_NEW_SMALL_INT(res)); \
+    } else { \
+        SET_TOP(mp_binary_op((op), MP_OBJ_NEW_SMALL_INT(lhs_val), MP_OBJ_NEW_SMALL_INT(rhs_val))); \
+    } \
+} while (0)
+
+STATIC byte mp_quick_binary_op_small_int(mp_binary_op_t op) {
+    switch (op) {
+        case MP_BINARY_OP_LESS: return MP_BC_QUICK_BINARY_OP_LESS_SMALL_INT;
+        case MP_BINARY_OP_MORE: return MP_BC_QUICK_BINARY_OP_MORE_SMALL_INT;
+        case MP_BINARY_OP_EQUAL: return MP_BC_QUICK_BINARY_OP_EQUAL_SMALL_INT;
+        case MP_BINARY_OP_LESS_EQUAL: return MP_BC_QUICK_BINARY_OP_LESS_EQUAL_SMALL_INT;
+        case MP_BINARY_OP_MORE_EQUAL: return MP_BC_QUICK_BINARY_OP_MORE_EQUAL_SMALL_INT;
+        case MP_BINARY_OP_NOT_EQUAL: return MP_BC_QUICK_BINARY_OP_NOT_EQUAL_SMALL_INT;
+        case MP_BINARY_OP_ADD: return MP_BC_QUICK_BINARY_OP_ADD_SMALL_INT;
+        case MP_BINARY_OP_SUBTRACT: return MP_BC_QUICK_BINARY_OP_SUBTRACT_SMALL_INT;
+        case MP_BINARY_OP_INPLACE_ADD: return MP_BC_QUICK_BINARY_OP_INPLACE_ADD_SMALL_INT;
+        case MP_BINARY_OP_INPLACE_SUBTRACT: return MP_BC_QUICK_BINARY_OP_INPLACE_SUBTRACT_SMALL_INT;
+        default: return MP_BC_BINARY_OP_MULTI + op;
+    }
+}
+
+#endif
+
+#if MICROPY_OPT_SUPERINSTRUCTIONS
+
+// Binary op whose right-hand argument is a small int, as in the fused forms of
+// "x + 1" and "i < n".  The comparisons and additions that dominate counting
+// loops are done here; everything else goes through the runtime.
+static inline mp_obj_t mp_vm_binary_op_small_int(mp_binary_op_t op, mp_obj_t lhs, mp_int_t rhs_val) {
+    if (MP_OBJ_IS_SMALL_INT(lhs)) {
+        mp_int_t lhs_val = MP_OBJ_SMALL_INT_VALUE(lhs);
+        switch (op) {
+            case MP_BINARY_OP_LESS: return mp_obj_new_bool(lhs_val < rhs_val);
+            case MP_BINARY_OP_MORE: return mp_obj_new_bool(lhs_val > rhs_val);
+            case MP_BINARY_OP_EQUAL: return mp_obj_new_bool(lhs_val == rhs_val);
+            case MP_BINARY_OP_LESS_EQUAL: return mp_obj_new_bool(lhs_val <= rhs_val);
+            case MP_BINARY_OP_MORE_EQUAL: return mp_obj_new_bool(lhs_val >= rhs_val);
+            case MP_BINARY_OP_NOT_EQUAL: return mp_obj_new_bool(lhs_val != rhs_val);
+            case MP_BINARY_OP_ADD:
+            case MP_BINARY_OP_INPLACE_ADD:
+                if (MP_SMALL_INT_FITS(lhs_val + rhs_val)) {
+                    return MP_OBJ_NEW_SMALL_INT(lhs_val + rhs_val);
+                }
+                break;
+            case MP_BINARY_OP_SUBTRACT:
+            case MP_BINARY_OP_INPLACE_SUBTRACT:
+                if (MP_SMALL_INT_FITS(lhs_val - rhs_val)) {
+                    return MP_OBJ_NEW_SMALL_INT(lhs_val - rhs_val);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return mp_binary_op(op, lhs, MP_OBJ_NEW_SMALL_INT(rhs_val));
+}
+
+// Returns the slot for base[index] if base is exactly a list and index a small
+// int in range, otherwise NULL and the caller goes through mp_obj_subscr.
+static inline mp_obj_t *mp_vm_list_item(mp_obj_t base, mp_obj_t index) {
+    if (MP_OBJ_IS_SMALL_INT(index) && MP_OBJ_IS_TYPE(base, &mp_type_list)) {
+        mp_obj_list_t *list = MP_OBJ_TO_PTR(base);
+        mp_int_t i = MP_OBJ_SMALL_INT_VALUE(index);
+        if (i < 0) {
+            i += list->len;
+        }
+        if ((mp_uint_t)i < list->len) {
+            return &list->items[i];
+        }
+    }
+    return NULL;
+}
+
+#endif
+
 // fastn has items in reverse order (fastn[0] is local[0], fastn[-1] is local[1], etc)
 // sp points to bottom of stack which grows up
 // returns:
@@ -159,6 +305,9 @@ run_code_state: ;
         fastn = &code_state->state[n_state - 1];
         exc_stack = (mp_exc_stack_t*)(code_state->state + n_state);
     }
+    #if MICROPY_OPT_QUICKEN_BYTECODE
+    const bool quicken_allowed = QUICKEN_ALLOWED();
+    #endif
 
     // variables that are visible to the exception handler (declared volatile)
     volatile bool currently_in_except_block = MP_TAGPTR_TAG0(code_state->exc_sp); // 0 or 1, to detect nested exceptions
@@ -284,7 +433,9 @@ dispatch_loop:
                     } else {
                         mp_map_elem_t *elem = mp_map_lookup(&mp_locals_get()->map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
                         if (elem != NULL) {
-                            *(byte*)ip = (elem - &mp_locals_get()->map.table[0]) & 0xff;
+                            if (CACHE_WRITABLE()) {
+                                *(byte*)ip = (elem - &mp_locals_get()->map.table[0]) & 0xff;
+                            }
                             PUSH(elem->value);
                         } else {
                             PUSH(mp_load_name(MP_OBJ_QSTR_VALUE(key)));
@@ -313,7 +464,9 @@ dispatch_loop:
                     } else {
                         mp_map_elem_t *elem = mp_map_lookup(&mp_globals_get()->map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
                         if (elem != NULL) {
-                            *(byte*)ip = (elem - &mp_globals_get()->map.table[0]) & 0xff;
+                            if (CACHE_WRITABLE()) {
+                                *(byte*)ip = (elem - &mp_globals_get()->map.table[0]) & 0xff;
+                            }
                             PUSH(elem->value);
                         } else {
                             PUSH(mp_load_global(MP_OBJ_QSTR_VALUE(key)));
@@ -346,7 +499,9 @@ dispatch_loop:
                         } else {
                             elem = mp_map_lookup(&self->members, key, MP_MAP_LOOKUP);
                             if (elem != NULL) {
-                                *(byte*)ip = elem - &self->members.table[0];
+                                if (CACHE_WRITABLE()) {
+                                    *(byte*)ip = elem - &self->members.table[0];
+                                }
                             } else {
                                 goto load_attr_cache_fail;
                             }
@@ -386,6 +541,11 @@ dispatch_loop:
                 ENTRY(MP_BC_LOAD_SUBSCR): {
                     MARK_EXC_IP_SELECTIVE();
                     mp_obj_t index = POP();
+                    #if MICROPY_OPT_QUICKEN_BYTECODE
+                    if (MP_OBJ_IS_SMALL_INT(index) && MP_OBJ_IS_TYPE(TOP(), &mp_type_list)) {
+                        QUICKEN(MP_BC_QUICK_LOAD_SUBSCR_LIST);
+                    }
+                    #endif
                     SET_TOP(mp_obj_subscr(TOP(), index, MP_OBJ_SENTINEL));
                     DISPATCH();
                 }
@@ -444,7 +604,9 @@ dispatch_loop:
                         } else {
                             elem = mp_map_lookup(&self->members, key, MP_MAP_LOOKUP);
                             if (elem != NULL) {
-                                *(byte*)ip = elem - &self->members.table[0];
+                                if (CACHE_WRITABLE()) {
+                                    *(byte*)ip = elem - &self->members.table[0];
+                                }
                             } else {
                                 goto store_attr_cache_fail;
                             }
@@ -464,6 +626,11 @@ dispatch_loop:
 
                 ENTRY(MP_BC_STORE_SUBSCR):
                     MARK_EXC_IP_SELECTIVE();
+                    #if MICROPY_OPT_QUICKEN_BYTECODE
+                    if (MP_OBJ_IS_SMALL_INT(sp[0]) && MP_OBJ_IS_TYPE(sp[-1], &mp_type_list)) {
+                        QUICKEN(MP_BC_QUICK_STORE_SUBSCR_LIST);
+                    }
+                    #endif
                     mp_obj_subscr(sp[-1], sp[0], sp[-2]);
                     sp -= 3;
                     DISPATCH();
@@ -1231,6 +1398,195 @@ yield:
                     mp_import_all(POP());
                     DISPATCH();
 
+                #if MICROPY_OPT_QUICKEN_BYTECODE
+                ENTRY(MP_BC_QUICK_BINARY_OP_LESS_SMALL_INT): {
+                    QUICK_SMALL_INT_OPERANDS(MP_BINARY_OP_LESS);
+                    SET_TOP(mp_obj_new_bool(lhs_val < rhs_val));
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_QUICK_BINARY_OP_MORE_SMALL_INT): {
+                    QUICK_SMALL_INT_OPERANDS(MP_BINARY_OP_MORE);
+                    SET_TOP(mp_obj_new_bool(lhs_val > rhs_val));
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_QUICK_BINARY_OP_EQUAL_SMALL_INT): {
+                    QUICK_SMALL_INT_OPERANDS(MP_BINARY_OP_EQUAL);
+                    SET_TOP(mp_obj_new_bool(lhs_val == rhs_val));
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_QUICK_BINARY_OP_LESS_EQUAL_SMALL_INT): {
+                    QUICK_SMALL_INT_OPERANDS(MP_BINARY_OP_LESS_EQUAL);
+                    SET_TOP(mp_obj_new_bool(lhs_val <= rhs_val));
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_QUICK_BINARY_OP_MORE_EQUAL_SMALL_INT): {
+                    QUICK_SMALL_INT_OPERANDS(MP_BINARY_OP_MORE_EQUAL);
+                    SET_TOP(mp_obj_new_bool(lhs_val >= rhs_val));
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_QUICK_BINARY_OP_NOT_EQUAL_SMALL_INT): {
+                    QUICK_SMALL_INT_OPERANDS(MP_BINARY_OP_NOT_EQUAL);
+                    SET_TOP(mp_obj_new_bool(lhs_val != rhs_val));
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_QUICK_BINARY_OP_ADD_SMALL_INT): {
+                    QUICK_SMALL_INT_OPERANDS(MP_BINARY_OP_ADD);
+                    QUICK_SMALL_INT_ARITH(MP_BINARY_OP_ADD, lhs_val + rhs_val);
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_QUICK_BINARY_OP_SUBTRACT_SMALL_INT): {
+                    QUICK_SMALL_INT_OPERANDS(MP_BINARY_OP_SUBTRACT);
+                    QUICK_SMALL_INT_ARITH(MP_BINARY_OP_SUBTRACT, lhs_val - rhs_val);
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_QUICK_BINARY_OP_INPLACE_ADD_SMALL_INT): {
+                    QUICK_SMALL_INT_OPERANDS(MP_BINARY_OP_INPLACE_ADD);
+                    QUICK_SMALL_INT_ARITH(MP_BINARY_OP_INPLACE_ADD, lhs_val + rhs_val);
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_QUICK_BINARY_OP_INPLACE_SUBTRACT_SMALL_INT): {
+                    QUICK_SMALL_INT_OPERANDS(MP_BINARY_OP_INPLACE_SUBTRACT);
+                    QUICK_SMALL_INT_ARITH(MP_BINARY_OP_INPLACE_SUBTRACT, lhs_val - rhs_val);
+                    DISPATCH();
+                }
+
+                // A subclass of list may override __getitem__/__setitem__, so
+                // these only take the exact list type.  An index out of range
+                // goes through the generic subscript to raise the IndexError.
+                ENTRY(MP_BC_QUICK_LOAD_SUBSCR_LIST): {
+                    MARK_EXC_IP_SELECTIVE();
+                    QUICK_CHECK_ALLOWED();
+                    if (!MP_OBJ_IS_SMALL_INT(sp[0]) || !MP_OBJ_IS_TYPE(sp[-1], &mp_type_list)) {
+                        DEOPTIMISE(MP_BC_LOAD_SUBSCR);
+                    }
+                    mp_obj_t index = POP();
+                    mp_obj_list_t *list = MP_OBJ_TO_PTR(TOP());
+                    mp_int_t i = MP_OBJ_SMALL_INT_VALUE(index);
+                    if (i < 0) {
+                        i += list->len;
+                    }
+                    if ((mp_uint_t)i < list->len) {
+                        SET_TOP(list->items[i]);
+                    } else {
+                        SET_TOP(mp_obj_subscr(TOP(), index, MP_OBJ_SENTINEL));
+                    }
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_QUICK_STORE_SUBSCR_LIST): {
+                    MARK_EXC_IP_SELECTIVE();
+                    QUICK_CHECK_ALLOWED();
+                    if (!MP_OBJ_IS_SMALL_INT(sp[0]) || !MP_OBJ_IS_TYPE(sp[-1], &mp_type_list)) {
+                        DEOPTIMISE(MP_BC_STORE_SUBSCR);
+                    }
+                    mp_obj_list_t *list = MP_OBJ_TO_PTR(sp[-1]);
+                    mp_int_t i = MP_OBJ_SMALL_INT_VALUE(sp[0]);
+                    if (i < 0) {
+                        i += list->len;
+                    }
+                    if ((mp_uint_t)i < list->len) {
+                        list->items[i] = sp[-2];
+                    } else {
+                        mp_obj_subscr(sp[-1], sp[0], sp[-2]);
+                    }
+                    sp -= 3;
+                    DISPATCH();
+                }
+                #endif
+
+                #if MICROPY_OPT_SUPERINSTRUCTIONS
+                ENTRY(MP_BC_LOAD_FAST_LOAD_FAST): {
+                    mp_uint_t locals = *ip++;
+                    obj_shared = fastn[-(mp_int_t)(locals >> 4)];
+                    if (obj_shared == MP_OBJ_NULL) {
+                        goto local_name_error;
+                    }
+                    PUSH(obj_shared);
+                    obj_shared = fastn[-(mp_int_t)(locals & 0xf)];
+                    goto load_check;
+                }
+
+                ENTRY(MP_BC_BINARY_OP_SMALL_INT): {
+                    MARK_EXC_IP_SELECTIVE();
+                    mp_binary_op_t op = ip[0];
+                    mp_int_t rhs_val = (mp_int_t)ip[1] - 16;
+                    ip += 2;
+                    SET_TOP(mp_vm_binary_op_small_int(op, TOP(), rhs_val));
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_BINARY_OP_POP_JUMP_IF_TRUE):
+                ENTRY(MP_BC_BINARY_OP_POP_JUMP_IF_FALSE): {
+                    MARK_EXC_IP_SELECTIVE();
+                    bool jump_if = ip[-1] == MP_BC_BINARY_OP_POP_JUMP_IF_TRUE;
+                    mp_binary_op_t op = *ip++;
+                    mp_obj_t rhs = POP();
+                    mp_obj_t lhs = POP();
+                    mp_obj_t res;
+                    if (MP_OBJ_IS_SMALL_INT(rhs)) {
+                        res = mp_vm_binary_op_small_int(op, lhs, MP_OBJ_SMALL_INT_VALUE(rhs));
+                    } else {
+                        res = mp_binary_op(op, lhs, rhs);
+                    }
+                    DECODE_SLABEL;
+                    if (mp_obj_is_true(res) == jump_if) {
+                        ip += slab;
+                    }
+                    DISPATCH_WITH_PEND_EXC_CHECK();
+                }
+
+                ENTRY(MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_TRUE):
+                ENTRY(MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_FALSE): {
+                    MARK_EXC_IP_SELECTIVE();
+                    bool jump_if = ip[-1] == MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_TRUE;
+                    mp_binary_op_t op = ip[0];
+                    mp_int_t rhs_val = (mp_int_t)ip[1] - 16;
+                    ip += 2;
+                    mp_obj_t res = mp_vm_binary_op_small_int(op, POP(), rhs_val);
+                    DECODE_SLABEL;
+                    if (mp_obj_is_true(res) == jump_if) {
+                        ip += slab;
+                    }
+                    DISPATCH_WITH_PEND_EXC_CHECK();
+                }
+
+                // The two halves of an augmented subscript assignment like
+                // "buf[i] += x": fetch base[index] keeping both on the stack,
+                // and store the result back into base[index].
+                ENTRY(MP_BC_DUP_TOP_TWO_LOAD_SUBSCR): {
+                    MARK_EXC_IP_SELECTIVE();
+                    mp_obj_t *item = mp_vm_list_item(sp[-1], sp[0]);
+                    mp_obj_t value = item != NULL ? *item : mp_obj_subscr(sp[-1], sp[0], MP_OBJ_SENTINEL);
+                    PUSH(value);
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_ROT_THREE_STORE_SUBSCR): {
+                    MARK_EXC_IP_SELECTIVE();
+                    // the value is MP_OBJ_NULL for "del base[index]"
+                    mp_obj_t *item = NULL;
+                    if (sp[0] != MP_OBJ_NULL) {
+                        item = mp_vm_list_item(sp[-2], sp[-1]);
+                    }
+                    if (item != NULL) {
+                        *item = sp[0];
+                    } else {
+                        mp_obj_subscr(sp[-2], sp[-1], sp[0]);
+                    }
+                    sp -= 3;
+                    DISPATCH();
+                }
+                #endif
+
 #if MICROPY_OPT_COMPUTED_GOTO
                 ENTRY(MP_BC_LOAD_CONST_SMALL_INT_MULTI):
                     PUSH(MP_OBJ_NEW_SMALL_INT((mp_int_t)ip[-1] - MP_BC_LOAD_CONST_SMALL_INT_MULTI - 16));
@@ -1251,9 +1607,15 @@ yield:
 
                 ENTRY(MP_BC_BINARY_OP_MULTI): {
                     MARK_EXC_IP_SELECTIVE();
+                    mp_binary_op_t op = ip[-1] - MP_BC_BINARY_OP_MULTI;
                     mp_obj_t rhs = POP();
                     mp_obj_t lhs = TOP();
-                    SET_TOP(mp_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
+                    #if MICROPY_OPT_QUICKEN_BYTECODE
+                    if (MP_OBJ_IS_SMALL_INT(lhs) && MP_OBJ_IS_SMALL_INT(rhs)) {
+                        QUICKEN_BINARY_OP(op);
+                    }
+                    #endif
+                    SET_TOP(mp_binary_op(op, lhs, rhs));
                     DISPATCH();
                 }
 
@@ -1274,13 +1636,22 @@ yield:
                         SET_TOP(mp_unary_op(ip[-1] - MP_BC_UNARY_OP_MULTI, TOP()));
                         DISPATCH();
                     } else if (ip[-1] < MP_BC_BINARY_OP_MULTI + MP_BINARY_OP_NUM_BYTECODE) {
+                        mp_binary_op_t op = ip[-1] - MP_BC_BINARY_OP_MULTI;
                         mp_obj_t rhs = POP();
                         mp_obj_t lhs = TOP();
-                        SET_TOP(mp_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
+                        #if MICROPY_OPT_QUICKEN_BYTECODE
+                        if (MP_OBJ_IS_SMALL_INT(lhs) && MP_OBJ_IS_SMALL_INT(rhs)) {
+                            QUICKEN_BINARY_OP(op);
+                        }
+                        #endif
+                        SET_TOP(mp_binary_op(op, lhs, rhs));
                         DISPATCH();
                     } else
 #endif
                 {
+                    #if MICROPY_OPT_QUICKEN_BYTECODE
+bytecode_not_implemented: ;
+                    #endif
                     mp_obj_t obj = mp_obj_new_exception_msg(&mp_type_NotImplementedError, translate("byte code not implemented"));
                     nlr_pop();
                     fastn[0] = obj;
@@ -1395,6 +1766,12 @@ unwind_loop:
                 #if MICROPY_PERSISTENT_CODE
                 qstr block_name = ip[0] | (ip[1] << 8);
                 qstr source_file = ip[2] | (ip[3] << 8);
+                #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+                if (code_state->fun_bc->qstr_link != NULL) {
+                    block_name = code_state->fun_bc->qstr_link[block_name];
+                    source_file = code_state->fun_bc->qstr_link[source_file];
+                }
+                #endif
                 ip += 4;
                 #else
                 qstr block_name = mp_decode_uint_value(ip);
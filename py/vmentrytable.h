@@ -106,6 +106,30 @@ static const void *const entry_table[256] = {
     [MP_BC_IMPORT_NAME] = &&entry_MP_BC_IMPORT_NAME,
     [MP_BC_IMPORT_FROM] = &&entry_MP_BC_IMPORT_FROM,
     [MP_BC_IMPORT_STAR] = &&entry_MP_BC_IMPORT_STAR,
+    #if MICROPY_OPT_SUPERINSTRUCTIONS
+    [MP_BC_LOAD_FAST_LOAD_FAST] = &&entry_MP_BC_LOAD_FAST_LOAD_FAST,
+    [MP_BC_BINARY_OP_SMALL_INT] = &&entry_MP_BC_BINARY_OP_SMALL_INT,
+    [MP_BC_BINARY_OP_POP_JUMP_IF_TRUE] = &&entry_MP_BC_BINARY_OP_POP_JUMP_IF_TRUE,
+    [MP_BC_BINARY_OP_POP_JUMP_IF_FALSE] = &&entry_MP_BC_BINARY_OP_POP_JUMP_IF_FALSE,
+    [MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_TRUE] = &&entry_MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_TRUE,
+    [MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_FALSE] = &&entry_MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_FALSE,
+    [MP_BC_DUP_TOP_TWO_LOAD_SUBSCR] = &&entry_MP_BC_DUP_TOP_TWO_LOAD_SUBSCR,
+    [MP_BC_ROT_THREE_STORE_SUBSCR] = &&entry_MP_BC_ROT_THREE_STORE_SUBSCR,
+    #endif
+    #if MICROPY_OPT_QUICKEN_BYTECODE
+    [MP_BC_QUICK_BINARY_OP_LESS_SMALL_INT] = &&entry_MP_BC_QUICK_BINARY_OP_LESS_SMALL_INT,
+    [MP_BC_QUICK_BINARY_OP_MORE_SMALL_INT] = &&entry_MP_BC_QUICK_BINARY_OP_MORE_SMALL_INT,
+    [MP_BC_QUICK_BINARY_OP_EQUAL_SMALL_INT] = &&entry_MP_BC_QUICK_BINARY_OP_EQUAL_SMALL_INT,
+    [MP_BC_QUICK_BINARY_OP_LESS_EQUAL_SMALL_INT] = &&entry_MP_BC_QUICK_BINARY_OP_LESS_EQUAL_SMALL_INT,
+    [MP_BC_QUICK_BINARY_OP_MORE_EQUAL_SMALL_INT] = &&entry_MP_BC_QUICK_BINARY_OP_MORE_EQUAL_SMALL_INT,
+    [MP_BC_QUICK_BINARY_OP_NOT_EQUAL_SMALL_INT] = &&entry_MP_BC_QUICK_BINARY_OP_NOT_EQUAL_SMALL_INT,
+    [MP_BC_QUICK_BINARY_OP_ADD_SMALL_INT] = &&entry_MP_BC_QUICK_BINARY_OP_ADD_SMALL_INT,
+    [MP_BC_QUICK_BINARY_OP_SUBTRACT_SMALL_INT] = &&entry_MP_BC_QUICK_BINARY_OP_SUBTRACT_SMALL_INT,
+    [MP_BC_QUICK_BINARY_OP_INPLACE_ADD_SMALL_INT] = &&entry_MP_BC_QUICK_BINARY_OP_INPLACE_ADD_SMALL_INT,
+    [MP_BC_QUICK_BINARY_OP_INPLACE_SUBTRACT_SMALL_INT] = &&entry_MP_BC_QUICK_BINARY_OP_INPLACE_SUBTRACT_SMALL_INT,
+    [MP_BC_QUICK_LOAD_SUBSCR_LIST] = &&entry_MP_BC_QUICK_LOAD_SUBSCR_LIST,
+    [MP_BC_QUICK_STORE_SUBSCR_LIST] = &&entry_MP_BC_QUICK_STORE_SUBSCR_LIST,
+    #endif
     [MP_BC_LOAD_CONST_SMALL_INT_MULTI ... MP_BC_LOAD_CONST_SMALL_INT_MULTI + 63] = &&entry_MP_BC_LOAD_CONST_SMALL_INT_MULTI,
     [MP_BC_LOAD_FAST_MULTI ... MP_BC_LOAD_FAST_MULTI + 15] = &&entry_MP_BC_LOAD_FAST_MULTI,
     [MP_BC_STORE_FAST_MULTI ... MP_BC_STORE_FAST_MULTI + 15] = &&entry_MP_BC_STORE_FAST_MULTI,
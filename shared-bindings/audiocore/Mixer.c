@@ -45,7 +45,8 @@
 //|
 //| .. class:: Mixer(channel_count=2, buffer_size=1024)
 //|
-//|   Create a Mixer object that can mix multiple channels with the same sample rate.
+//|   Create a Mixer object that can mix multiple channels. Samples at other sample rates or
+//|   encodings are converted while mixing.
 //|
 //|   :param int channel_count: The maximum number of samples to mix at once
 //|   :param int buffer_size: The total size in bytes of the buffers to mix into
@@ -147,21 +148,33 @@ STATIC mp_obj_t audioio_mixer_obj___exit__(size_t n_args, const mp_obj_t *args)
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(audioio_mixer___exit___obj, 4, 4, audioio_mixer_obj___exit__);
 
 
-//|   .. method:: play(sample, *, voice=0, loop=False)
+STATIC mp_float_t get_level(mp_obj_t level_obj) {
+    mp_float_t level = mp_obj_get_float(level_obj);
+    if (level < 0 || level > 1) {
+        mp_raise_ValueError(translate("Level must be 0-1.0"));
+    }
+    return level;
+}
+
+//|   .. method:: play(sample, *, voice=0, loop=False, level=1.0)
 //|
 //|     Plays the sample once when loop=False and continuously when loop=True.
 //|     Does not block. Use `playing` to block.
 //|
 //|     Sample must be an `audiocore.WaveFile`, `audiocore.RawSample`, or `audiocore.Mixer`.
 //|
-//|     The sample must match the Mixer's encoding settings given in the constructor.
+//|     Samples that don't match the Mixer's encoding settings given in the constructor are
+//|     converted while mixing. Their sample rate is converted with linear interpolation.
+//|
+//|     :param float level: The volume of the voice from 0 to 1.0
 //|
 STATIC mp_obj_t audioio_mixer_obj_play(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
-    enum { ARG_sample, ARG_voice, ARG_loop };
+    enum { ARG_sample, ARG_voice, ARG_loop, ARG_level };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_sample,    MP_ARG_OBJ | MP_ARG_REQUIRED },
         { MP_QSTR_voice,     MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 0} },
         { MP_QSTR_loop,      MP_ARG_BOOL | MP_ARG_KW_ONLY, {.u_bool = false} },
+        { MP_QSTR_level,     MP_ARG_OBJ | MP_ARG_KW_ONLY, {.u_obj = MP_OBJ_NEW_SMALL_INT(1)} },
     };
     audioio_mixer_obj_t *self = MP_OBJ_TO_PTR(pos_args[0]);
     check_for_deinit(self);
@@ -169,12 +182,35 @@ STATIC mp_obj_t audioio_mixer_obj_play(size_t n_args, const mp_obj_t *pos_args,
     mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     mp_obj_t sample = args[ARG_sample].u_obj;
-    common_hal_audioio_mixer_play(self, sample, args[ARG_voice].u_int, args[ARG_loop].u_bool);
+    mp_float_t level = get_level(args[ARG_level].u_obj);
+    common_hal_audioio_mixer_play(self, sample, args[ARG_voice].u_int, args[ARG_loop].u_bool, level);
 
     return mp_const_none;
 }
 MP_DEFINE_CONST_FUN_OBJ_KW(audioio_mixer_play_obj, 1, audioio_mixer_obj_play);
 
+//|   .. method:: set_level(level, *, voice=0)
+//|
+//|     Sets the volume of the given voice from 0 to 1.0. Takes effect on the next buffer.
+//|
+STATIC mp_obj_t audioio_mixer_obj_set_level(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_level, ARG_voice };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_level,     MP_ARG_OBJ | MP_ARG_REQUIRED },
+        { MP_QSTR_voice,     MP_ARG_INT | MP_ARG_KW_ONLY, {.u_int = 0} },
+    };
+    audioio_mixer_obj_t *self = MP_OBJ_TO_PTR(pos_args[0]);
+    check_for_deinit(self);
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_float_t level = get_level(args[ARG_level].u_obj);
+    common_hal_audioio_mixer_set_level(self, args[ARG_voice].u_int, level);
+
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_KW(audioio_mixer_set_level_obj, 1, audioio_mixer_obj_set_level);
+
 //|   .. method:: stop_voice(voice=0)
 //|
 //|     Stops playback of the sample on the given voice.
@@ -238,6 +274,7 @@ STATIC const mp_rom_map_elem_t audioio_mixer_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&audioio_mixer___exit___obj) },
     { MP_ROM_QSTR(MP_QSTR_play), MP_ROM_PTR(&audioio_mixer_play_obj) },
     { MP_ROM_QSTR(MP_QSTR_stop_voice), MP_ROM_PTR(&audioio_mixer_stop_voice_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_level), MP_ROM_PTR(&audioio_mixer_set_level_obj) },
 
     // Properties
     { MP_ROM_QSTR(MP_QSTR_playing), MP_ROM_PTR(&audioio_mixer_playing_obj) },
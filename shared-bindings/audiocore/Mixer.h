@@ -43,7 +43,8 @@ void common_hal_audioio_mixer_construct(audioio_mixer_obj_t* self,
 
 void common_hal_audioio_mixer_deinit(audioio_mixer_obj_t* self);
 bool common_hal_audioio_mixer_deinited(audioio_mixer_obj_t* self);
-void common_hal_audioio_mixer_play(audioio_mixer_obj_t* self, mp_obj_t sample, uint8_t voice, bool loop);
+void common_hal_audioio_mixer_play(audioio_mixer_obj_t* self, mp_obj_t sample, uint8_t voice, bool loop, mp_float_t level);
+void common_hal_audioio_mixer_set_level(audioio_mixer_obj_t* self, uint8_t voice, mp_float_t level);
 void common_hal_audioio_mixer_stop_voice(audioio_mixer_obj_t* self, uint8_t voice);
 
 bool common_hal_audioio_mixer_get_playing(audioio_mixer_obj_t* self);
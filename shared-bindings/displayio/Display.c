@@ -417,6 +417,30 @@ const mp_obj_property_t displayio_display_bus_obj = {
               (mp_obj_t)&mp_const_none_obj},
 };
 
+//|   .. attribute:: refresh_stats
+//|
+//|     Statistics of the last refresh as a tuple of the number of areas updated, the number of
+//|     pixels filled and the number of bytes of pixel data sent.
+//|
+STATIC mp_obj_t displayio_display_obj_get_refresh_stats(mp_obj_t self_in) {
+    displayio_display_obj_t *self = native_display(self_in);
+    const displayio_refresh_stats_t* stats = common_hal_displayio_display_get_refresh_stats(self);
+    mp_obj_t items[3] = {
+        mp_obj_new_int_from_uint(stats->areas),
+        mp_obj_new_int_from_uint(stats->pixels),
+        mp_obj_new_int_from_uint(stats->bytes)
+    };
+    return mp_obj_new_tuple(3, items);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(displayio_display_get_refresh_stats_obj, displayio_display_obj_get_refresh_stats);
+
+const mp_obj_property_t displayio_display_refresh_stats_obj = {
+    .base.type = &mp_type_property,
+    .proxy = {(mp_obj_t)&displayio_display_get_refresh_stats_obj,
+              (mp_obj_t)&mp_const_none_obj,
+              (mp_obj_t)&mp_const_none_obj},
+};
+
 
 //|   .. method:: fill_row(y, buffer)
 //|
@@ -492,6 +516,7 @@ STATIC const mp_rom_map_elem_t displayio_display_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_height), MP_ROM_PTR(&displayio_display_height_obj) },
     { MP_ROM_QSTR(MP_QSTR_rotation), MP_ROM_PTR(&displayio_display_rotation_obj) },
     { MP_ROM_QSTR(MP_QSTR_bus), MP_ROM_PTR(&displayio_display_bus_obj) },
+    { MP_ROM_QSTR(MP_QSTR_refresh_stats), MP_ROM_PTR(&displayio_display_refresh_stats_obj) },
 };
 STATIC MP_DEFINE_CONST_DICT(displayio_display_locals_dict, displayio_display_locals_dict_table);
 
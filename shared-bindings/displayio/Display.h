@@ -67,5 +67,7 @@ bool common_hal_displayio_display_set_brightness(displayio_display_obj_t* self,
 
 mp_obj_t common_hal_displayio_display_get_bus(displayio_display_obj_t* self);
 
+const displayio_refresh_stats_t* common_hal_displayio_display_get_refresh_stats(displayio_display_obj_t* self);
+
 
 #endif // MICROPY_INCLUDED_SHARED_BINDINGS_DISPLAYIO_DISPLAY_H
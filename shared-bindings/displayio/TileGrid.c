@@ -126,6 +126,12 @@ STATIC mp_obj_t displayio_tilegrid_make_new(const mp_obj_type_t *type, size_t n_
         mp_raise_ValueError(translate("Tile height must exactly divide bitmap height"));
     }
 
+    mp_int_t default_tile = args[ARG_default_tile].u_int;
+    if (default_tile < 0 || default_tile > 255 ||
+            default_tile >= (bitmap_width / tile_width) * (bitmap_height / tile_height)) {
+        mp_raise_ValueError(translate("Tile index out of bounds"));
+    }
+
     int16_t x = args[ARG_x].u_int;
     int16_t y = args[ARG_y].u_int;
 
@@ -134,7 +140,7 @@ STATIC mp_obj_t displayio_tilegrid_make_new(const mp_obj_type_t *type, size_t n_
     common_hal_displayio_tilegrid_construct(self, native,
         bitmap_width / tile_width, bitmap_height / tile_height,
         pixel_shader, args[ARG_width].u_int, args[ARG_height].u_int,
-        tile_width, tile_height, x, y, args[ARG_default_tile].u_int);
+        tile_width, tile_height, x, y, default_tile);
     return MP_OBJ_FROM_PTR(self);
 }
 
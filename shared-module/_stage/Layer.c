@@ -28,78 +28,115 @@
 #include "__init__.h"
 
 
-// Get the color of the pixel on the layer.
-uint16_t get_layer_pixel(layer_obj_t *layer, uint16_t x, uint16_t y) {
+// Fill in the transparent pixels of a row of the screen with the layer's pixels.
+void fill_layer_row(layer_obj_t *layer, uint16_t x0, uint16_t y,
+        uint16_t *line, uint16_t width) {
 
     // Shift by the layer's position offset.
-    x -= layer->x;
-    y -= layer->y;
+    int32_t ly = y - layer->y;
 
     // Bounds check.
-    if ((x < 0) || (x >= layer->width << 4) ||
-            (y < 0) || (y >= layer->height << 4)) {
-        return TRANSPARENT;
+    if ((ly < 0) || (ly >= layer->height << 4)) {
+        return;
     }
 
-    // Get the tile from the grid location or from sprite frame.
-    uint8_t frame = layer->frame;
-    if (layer->map) {
-        uint8_t tx = x >> 4;
-        uint8_t ty = y >> 4;
-
-        frame = layer->map[(ty * layer->width + tx) >> 1];
-        if (tx & 0x01) {
-            frame &= 0x0f;
-        } else {
-            frame >>= 4;
-        }
+    // The part of the row covered by the layer.
+    int32_t start = layer->x - x0;
+    int32_t end = start + (layer->width << 4);
+    if (start < 0) {
+        start = 0;
+    }
+    if (end > width) {
+        end = width;
+    }
+    if (start >= end) {
+        return;
     }
 
-    // Get the position within the tile.
-    x &= 0x0f;
-    y &= 0x0f;
+    // Convert the palette to 16-bit colors once for the whole row.
+    uint16_t colors[16];
+    for (uint8_t i = 0; i < 16; ++i) {
+        colors[i] = layer->palette[i << 1] | layer->palette[(i << 1) + 1] << 8;
+    }
 
-    // Rotate the image.
-    uint8_t ty = y; // Temporary variable for swapping.
+    // Rotating the image only changes which pixel of the tile comes first in
+    // the row and how far along the tile each next pixel is, counted in
+    // 4-bit pixels.
+    uint8_t ty = ly & 0x0f;
+    int16_t first;
+    int16_t step;
     switch (layer->rotation) {
         case 1: // 90 degrees clockwise
-            y = 15 - x;
-            x = ty;
+            first = (15 << 4) + ty;
+            step = -16;
             break;
         case 2: // 180 degrees
-            y = 15 - ty;
-            x = 15 - x;
+            first = ((15 - ty) << 4) + 15;
+            step = -1;
             break;
         case 3: // 90 degrees counter-clockwise
-            y = x;
-            x = 15 - ty;
+            first = 15 - ty;
+            step = 16;
             break;
         case 4: // 0 degrees, mirrored
-            x = 15 - x;
+            first = (ty << 4) + 15;
+            step = -1;
             break;
         case 5: // 90 degrees clockwise, mirrored
-            y = x;
-            x = ty;
+            first = ty;
+            step = 16;
             break;
         case 6: // 180 degrees, mirrored
-            y = 15 - ty;
+            first = (15 - ty) << 4;
+            step = 1;
             break;
         case 7: // 90 degrees counter-clockwise, mirrored
-            y = 15 - x;
-            x = 15 - ty;
+            first = (15 << 4) + 15 - ty;
+            step = -16;
             break;
         default: // 0 degrees
+            first = ty << 4;
+            step = 1;
             break;
     }
 
-    // Get the value of the pixel.
-    uint8_t pixel = layer->graphic[(frame << 7) + (y << 3) + (x >> 1)];
-    if (x & 0x01) {
-        pixel &= 0x0f;
-    } else {
-        pixel >>= 4;
-    }
+    uint16_t x = start;
+    while (x < end) {
+        uint16_t lx = x + x0 - layer->x;
 
-    // Convert to 16-bit color using the palette.
-    return layer->palette[pixel << 1] | layer->palette[(pixel << 1) + 1] << 8;
+        // Get the tile from the grid location or from sprite frame.
+        uint8_t frame = layer->frame;
+        if (layer->map) {
+            uint8_t tx = lx >> 4;
+            uint8_t my = ly >> 4;
+
+            frame = layer->map[(my * layer->width + tx) >> 1];
+            if (tx & 0x01) {
+                frame &= 0x0f;
+            } else {
+                frame >>= 4;
+            }
+        }
+        const uint8_t *tile = layer->graphic + (frame << 7);
+
+        // Draw the rest of the tile's row.
+        uint8_t tx = lx & 0x0f;
+        uint16_t run_end = x + 16 - tx;
+        if (run_end > end) {
+            run_end = end;
+        }
+        int16_t index = first + step * tx;
+        for (; x < run_end; ++x, index += step) {
+            if (line[x] != TRANSPARENT) {
+                continue;
+            }
+            uint8_t pixel = tile[index >> 1];
+            if (index & 0x01) {
+                pixel &= 0x0f;
+            } else {
+                pixel >>= 4;
+            }
+            line[x] = colors[pixel];
+        }
+    }
 }
@@ -28,40 +28,71 @@
 #include "__init__.h"
 
 
-// Get the color of the pixel on the text.
-uint16_t get_text_pixel(text_obj_t *text, uint16_t x, uint16_t y) {
+// Fill in the transparent pixels of a row of the screen with the text's pixels.
+void fill_text_row(text_obj_t *text, uint16_t x0, uint16_t y,
+        uint16_t *line, uint16_t width) {
 
     // Shift by the text's position offset.
-    x -= text->x;
-    y -= text->y;
+    int32_t ty = y - text->y;
 
     // Bounds check.
-    if ((x < 0) || (x >= text->width << 3) ||
-            (y < 0) || (y >= text->height << 3)) {
-        return TRANSPARENT;
+    if ((ty < 0) || (ty >= text->height << 3)) {
+        return;
     }
 
-    // Get the tile from the grid location or from sprite frame.
-    uint8_t tx = x >> 3;
-    uint8_t ty = y >> 3;
-    uint8_t c = text->chars[ty * text->width + tx];
-    uint8_t color_offset = 0;
-    if (c & 0x80) {
-        color_offset = 4;
+    // The part of the row covered by the text.
+    int32_t start = text->x - x0;
+    int32_t end = start + (text->width << 3);
+    if (start < 0) {
+        start = 0;
     }
-    c &= 0x7f;
-    if (!c) {
-        return TRANSPARENT;
+    if (end > width) {
+        end = width;
+    }
+    if (start >= end) {
+        return;
+    }
+
+    // Convert the palette to 16-bit colors once for the whole row.
+    uint16_t colors[8];
+    for (uint8_t i = 0; i < 8; ++i) {
+        colors[i] = text->palette[i << 1] | text->palette[(i << 1) + 1] << 8;
     }
 
-    // Get the position within the char.
-    x &= 0x07;
-    y &= 0x07;
+    const uint8_t *chars = text->chars + (ty >> 3) * text->width;
+    // The row within each char.
+    const uint8_t *font = text->font + ((ty & 0x07) << 1);
 
-    // Get the value of the pixel.
-    uint8_t pixel = text->font[(c << 4) + (y << 1) + (x >> 2)];
-    pixel = ((pixel >> ((x & 0x03) << 1)) & 0x03) + color_offset;
+    uint16_t x = start;
+    while (x < end) {
+        uint16_t tx = x + x0 - text->x;
 
-    // Convert to 16-bit color using the palette.
-    return text->palette[pixel << 1] | text->palette[(pixel << 1) + 1] << 8;
+        // Get the char from the grid location.
+        uint8_t c = chars[tx >> 3];
+        uint8_t color_offset = 0;
+        if (c & 0x80) {
+            color_offset = 4;
+        }
+        c &= 0x7f;
+
+        uint8_t cx = tx & 0x07;
+        uint16_t run_end = x + 8 - cx;
+        if (run_end > end) {
+            run_end = end;
+        }
+        if (!c) {
+            // Empty chars are transparent.
+            x = run_end;
+            continue;
+        }
+
+        // Draw the rest of the char's row. Each byte holds four 2-bit pixels.
+        uint16_t bits = font[c << 4] | font[(c << 4) + 1] << 8;
+        bits >>= cx << 1;
+        for (; x < run_end; ++x, bits >>= 2) {
+            if (line[x] == TRANSPARENT) {
+                line[x] = colors[(bits & 0x03) + color_offset];
+            }
+        }
+    }
 }
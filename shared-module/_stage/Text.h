@@ -41,6 +41,7 @@ typedef struct {
     uint8_t width, height;
 } text_obj_t;
 
-uint16_t get_text_pixel(text_obj_t *text, uint16_t x, uint16_t y);
+void fill_text_row(text_obj_t *text, uint16_t x0, uint16_t y,
+        uint16_t *line, uint16_t width);
 
 #endif  // MICROPY_INCLUDED_SHARED_MODULE__STAGE_TEXT
@@ -31,34 +31,47 @@
 #include "shared-bindings/_stage/Text.h"
 
 
+// Renders one row of the screen, front layer first.
+STATIC void render_row(uint16_t x0, uint16_t y, mp_obj_t *layers, size_t layers_size,
+        uint16_t *line, uint16_t width) {
+    for (uint16_t x = 0; x < width; ++x) {
+        line[x] = TRANSPARENT;
+    }
+    for (size_t layer = 0; layer < layers_size; ++layer) {
+        layer_obj_t *obj = MP_OBJ_TO_PTR(layers[layer]);
+        if (obj->base.type == &mp_type_layer) {
+            fill_layer_row(obj, x0, y, line, width);
+        } else if (obj->base.type == &mp_type_text) {
+            fill_text_row((text_obj_t *)obj, x0, y, line, width);
+        }
+    }
+}
+
 void render_stage(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
         mp_obj_t *layers, size_t layers_size,
         uint16_t *buffer, size_t buffer_size,
         displayio_display_obj_t *display, uint8_t scale) {
 
+    if (x1 <= x0) {
+        return;
+    }
+    uint16_t width = x1 - x0;
+    uint16_t line[width];
+
     size_t index = 0;
     for (uint16_t y = y0; y < y1; ++y) {
+        render_row(x0, y, layers, layers_size, line, width);
+        // Repeat the same row for scaling instead of rendering it again.
         for (uint8_t yscale = 0; yscale < scale; ++yscale) {
-            for (uint16_t x = x0; x < x1; ++x) {
-                uint16_t c = TRANSPARENT;
-                for (size_t layer = 0; layer < layers_size; ++layer) {
-                    layer_obj_t *obj = MP_OBJ_TO_PTR(layers[layer]);
-                    if (obj->base.type == &mp_type_layer) {
-                        c = get_layer_pixel(obj, x, y);
-                    } else if (obj->base.type == &mp_type_text) {
-                        c = get_text_pixel((text_obj_t *)obj, x, y);
-                    }
-                    if (c != TRANSPARENT) {
-                        break;
-                    }
-                }
+            for (uint16_t x = 0; x < width; ++x) {
+                uint16_t c = line[x];
                 for (uint8_t xscale = 0; xscale < scale; ++xscale) {
                     buffer[index] = c;
                     index += 1;
                     // The buffer is full, send it.
                     if (index >= buffer_size) {
-                        display->core.send(display->core.bus, DISPLAY_DATA, CHIP_SELECT_UNTOUCHED, ((uint8_t*)buffer),
-                                      buffer_size * 2);
+                        display->core.send(display->core.bus, DISPLAY_DATA, CHIP_SELECT_UNTOUCHED,
+                                           ((uint8_t*)buffer), buffer_size * 2);
                         index = 0;
                     }
                 }
@@ -67,6 +80,7 @@ void render_stage(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
     }
     // Send the remaining data.
     if (index) {
-        display->core.send(display->core.bus, DISPLAY_DATA, CHIP_SELECT_UNTOUCHED, ((uint8_t*)buffer), index * 2);
+        display->core.send(display->core.bus, DISPLAY_DATA, CHIP_SELECT_UNTOUCHED,
+                           ((uint8_t*)buffer), index * 2);
     }
 }
@@ -27,6 +27,7 @@
 #include "shared-bindings/audiocore/Mixer.h"
 
 #include <stdint.h>
+#include <string.h>
 
 #include "py/runtime.h"
 #include "shared-module/audiocore/__init__.h"
@@ -77,37 +78,59 @@ uint32_t common_hal_audioio_mixer_get_sample_rate(audioio_mixer_obj_t* self) {
     return self->sample_rate;
 }
 
-void common_hal_audioio_mixer_play(audioio_mixer_obj_t* self, mp_obj_t sample, uint8_t v, bool loop) {
+STATIC void update_direct(audioio_mixer_obj_t* self, audioio_mixer_voice_t* voice) {
+    bool direct = voice->level == MIXER_LEVEL_FULL &&
+        voice->step == MIXER_POSITION_ONE &&
+        voice->bytes_per_sample * 8 == self->bits_per_sample &&
+        voice->channel_count == self->channel_count &&
+        voice->samples_signed == self->samples_signed;
+    if (!direct && voice->direct) {
+        // Read two frames from where the sample is to prime the resampler.
+        voice->position = 2 * MIXER_POSITION_ONE;
+    }
+    voice->direct = direct;
+}
+
+void common_hal_audioio_mixer_play(audioio_mixer_obj_t* self, mp_obj_t sample, uint8_t v, bool loop, mp_float_t level) {
     if (v >= self->voice_count) {
         mp_raise_ValueError(translate("Voice index too high"));
     }
-    if (audiosample_sample_rate(sample) != self->sample_rate) {
-        mp_raise_ValueError(translate("The sample's sample rate does not match the mixer's"));
-    }
-    if (audiosample_channel_count(sample) != self->channel_count) {
-        mp_raise_ValueError(translate("The sample's channel count does not match the mixer's"));
-    }
-    if (audiosample_bits_per_sample(sample) != self->bits_per_sample) {
-        mp_raise_ValueError(translate("The sample's bits_per_sample does not match the mixer's"));
-    }
     bool single_buffer;
     bool samples_signed;
     uint32_t max_buffer_length;
     uint8_t spacing;
     audiosample_get_buffer_structure(sample, false, &single_buffer, &samples_signed,
                                      &max_buffer_length, &spacing);
-    if (samples_signed != self->samples_signed) {
-        mp_raise_ValueError(translate("The sample's signedness does not match the mixer's"));
-    }
     audioio_mixer_voice_t* voice = &self->voice[v];
-    voice->sample = sample;
+    // Stop the voice while we set it up because get_buffer may be called from an interrupt.
+    voice->sample = NULL;
     voice->loop = loop;
+    voice->level = level * MIXER_LEVEL_FULL;
+    voice->bytes_per_sample = audiosample_bits_per_sample(sample) / 8;
+    voice->channel_count = audiosample_channel_count(sample);
+    voice->samples_signed = samples_signed;
+    voice->step = ((uint64_t) audiosample_sample_rate(sample) * MIXER_POSITION_ONE) / self->sample_rate;
+    voice->current_frame[0] = 0;
+    voice->current_frame[1] = 0;
+    voice->next_frame[0] = 0;
+    voice->next_frame[1] = 0;
+    voice->position = 2 * MIXER_POSITION_ONE;
+    voice->direct = false;
+    update_direct(self, voice);
 
     audiosample_reset_buffer(sample, false, 0);
-    audioio_get_buffer_result_t result = audiosample_get_buffer(sample, false, 0, (uint8_t**) &voice->remaining_buffer, &voice->buffer_length);
-    // Track length in terms of words.
-    voice->buffer_length /= sizeof(uint32_t);
+    audioio_get_buffer_result_t result = audiosample_get_buffer(sample, false, 0, &voice->remaining_buffer, &voice->buffer_length);
     voice->more_data = result == GET_BUFFER_MORE_DATA;
+    voice->sample = sample;
+}
+
+void common_hal_audioio_mixer_set_level(audioio_mixer_obj_t* self, uint8_t v, mp_float_t level) {
+    if (v >= self->voice_count) {
+        mp_raise_ValueError(translate("Voice index too high"));
+    }
+    audioio_mixer_voice_t* voice = &self->voice[v];
+    voice->level = level * MIXER_LEVEL_FULL;
+    update_direct(self, voice);
 }
 
 void common_hal_audioio_mixer_stop_voice(audioio_mixer_obj_t* self, uint8_t voice) {
@@ -131,88 +154,320 @@ void audioio_mixer_reset_buffer(audioio_mixer_obj_t* self,
     }
 }
 
-uint32_t add8signed(uint32_t a, uint32_t b) {
-    #if (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
-    return __QADD8(a, b);
-    #else
-    uint32_t result = 0;
-    for (int8_t i = 0; i < 4; i++) {
-        int8_t ai = a >> (sizeof(int8_t) * 8 * i);
-        int8_t bi = b >> (sizeof(int8_t) * 8 * i);
-        int32_t intermediate = (int32_t) ai + bi;
-        if (intermediate > CHAR_MAX) {
-            intermediate = CHAR_MAX;
-        } else if (intermediate < CHAR_MIN) {
-            //intermediate = CHAR_MIN;
+// Mixing kernels. Each adds count words of one voice into the output with per lane saturation.
+// Unsigned samples are offset so that 0x80 (or 0x8000) is silence.
+#if (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+STATIC void mix_add8signed(uint32_t* out, const uint32_t* in, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = __QADD8(out[i], in[i]);
+    }
+}
+
+STATIC void mix_add8unsigned(uint32_t* out, const uint32_t* in, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        // Subtract out the DC offset, add and then shift back.
+        uint32_t a = __USUB8(out[i], 0x80808080);
+        uint32_t b = __USUB8(in[i], 0x80808080);
+        out[i] = __UADD8(__QADD8(a, b), 0x80808080);
+    }
+}
+
+STATIC void mix_add16signed(uint32_t* out, const uint32_t* in, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = __QADD16(out[i], in[i]);
+    }
+}
+
+STATIC void mix_add16unsigned(uint32_t* out, const uint32_t* in, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        // Subtract out the DC offset, add and then shift back.
+        uint32_t a = __USUB16(out[i], 0x80008000);
+        uint32_t b = __USUB16(in[i], 0x80008000);
+        out[i] = __UADD16(__QADD16(a, b), 0x80008000);
+    }
+}
+#else
+// Portable versions using GCC vector extensions, four words at a time.
+typedef uint8_t mixer_u8x16_t __attribute__((vector_size(16)));
+typedef int8_t mixer_s8x16_t __attribute__((vector_size(16)));
+typedef uint16_t mixer_u16x8_t __attribute__((vector_size(16)));
+typedef int16_t mixer_s16x8_t __attribute__((vector_size(16)));
+
+STATIC inline mixer_u8x16_t qadd8(mixer_u8x16_t a, mixer_u8x16_t b) {
+    mixer_u8x16_t sum = a + b;
+    // All ones in lanes where a and b share a sign that the sum doesn't have.
+    mixer_u8x16_t overflow = (mixer_u8x16_t) (((mixer_s8x16_t) ((a ^ sum) & (b ^ sum))) >> 7);
+    // 0x7f when a is positive and 0x80 when it is negative.
+    mixer_u8x16_t limit = (a >> 7) + 0x7f;
+    return (sum & ~overflow) | (limit & overflow);
+}
+
+STATIC inline mixer_u16x8_t qadd16(mixer_u16x8_t a, mixer_u16x8_t b) {
+    mixer_u16x8_t sum = a + b;
+    mixer_u16x8_t overflow = (mixer_u16x8_t) (((mixer_s16x8_t) ((a ^ sum) & (b ^ sum))) >> 15);
+    mixer_u16x8_t limit = (a >> 15) + 0x7fff;
+    return (sum & ~overflow) | (limit & overflow);
+}
+
+// The last few words are mixed through zero padded vectors.
+STATIC inline void mix_add8(uint32_t* out, const uint32_t* in, uint32_t count, uint8_t offset) {
+    mixer_u8x16_t a;
+    mixer_u8x16_t b;
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        memcpy(&a, out + i, sizeof(a));
+        memcpy(&b, in + i, sizeof(b));
+        a = qadd8(a ^ offset, b ^ offset) ^ offset;
+        memcpy(out + i, &a, sizeof(a));
+    }
+    if (i < count) {
+        uint32_t length = (count - i) * sizeof(uint32_t);
+        a = (mixer_u8x16_t) {0};
+        b = (mixer_u8x16_t) {0};
+        memcpy(&a, out + i, length);
+        memcpy(&b, in + i, length);
+        a = qadd8(a ^ offset, b ^ offset) ^ offset;
+        memcpy(out + i, &a, length);
+    }
+}
+
+STATIC inline void mix_add16(uint32_t* out, const uint32_t* in, uint32_t count, uint16_t offset) {
+    mixer_u16x8_t a;
+    mixer_u16x8_t b;
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        memcpy(&a, out + i, sizeof(a));
+        memcpy(&b, in + i, sizeof(b));
+        a = qadd16(a ^ offset, b ^ offset) ^ offset;
+        memcpy(out + i, &a, sizeof(a));
+    }
+    if (i < count) {
+        uint32_t length = (count - i) * sizeof(uint32_t);
+        a = (mixer_u16x8_t) {0};
+        b = (mixer_u16x8_t) {0};
+        memcpy(&a, out + i, length);
+        memcpy(&b, in + i, length);
+        a = qadd16(a ^ offset, b ^ offset) ^ offset;
+        memcpy(out + i, &a, length);
+    }
+}
+
+STATIC void mix_add8signed(uint32_t* out, const uint32_t* in, uint32_t count) {
+    mix_add8(out, in, count, 0);
+}
+
+STATIC void mix_add8unsigned(uint32_t* out, const uint32_t* in, uint32_t count) {
+    mix_add8(out, in, count, 0x80);
+}
+
+STATIC void mix_add16signed(uint32_t* out, const uint32_t* in, uint32_t count) {
+    mix_add16(out, in, count, 0);
+}
+
+STATIC void mix_add16unsigned(uint32_t* out, const uint32_t* in, uint32_t count) {
+    mix_add16(out, in, count, 0x8000);
+}
+#endif
+
+typedef void (*mix_kernel_t)(uint32_t* out, const uint32_t* in, uint32_t count);
+
+// Loads the voice's next buffer. Returns false when there is nothing to mix from it for now,
+// either because the sample is done or it returned no data.
+STATIC bool load_next_buffer(audioio_mixer_voice_t* voice) {
+    if (!voice->more_data) {
+        if (!voice->loop) {
+            voice->sample = NULL;
+            return false;
+        }
+        audiosample_reset_buffer(voice->sample, false, 0);
+    }
+    audioio_get_buffer_result_t result = audiosample_get_buffer(voice->sample, false, 0, &voice->remaining_buffer, &voice->buffer_length);
+    voice->more_data = result == GET_BUFFER_MORE_DATA;
+    // Try again next time rather than spinning on an empty sample.
+    return voice->buffer_length > 0;
+}
+
+// Reads the voice's next word a byte at a time, continuing into the next buffer if this one ends
+// part way through it. A partial word at the end of the sample is dropped.
+STATIC bool read_word_bytewise(audioio_mixer_voice_t* voice, uint32_t* word) {
+    uint8_t* bytes = (uint8_t*) word;
+    for (uint8_t b = 0; b < sizeof(uint32_t); b++) {
+        while (voice->buffer_length == 0) {
+            if (!load_next_buffer(voice)) {
+                return false;
+            }
         }
-        result |= (((uint32_t) intermediate) & 0xff) << (sizeof(int8_t) * 8 * i);
+        bytes[b] = *voice->remaining_buffer;
+        voice->remaining_buffer++;
+        voice->buffer_length--;
     }
-    return result;
-    #endif
+    return true;
 }
 
-uint32_t add8unsigned(uint32_t a, uint32_t b) {
-    #if (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
-    // Subtract out the DC offset, add and then shift back.
-    a = __USUB8(a, 0x80808080);
-    b = __USUB8(b, 0x80808080);
-    uint32_t sum = __QADD8(a, b);
-    return __UADD8(sum, 0x80808080);
-    #else
-    uint32_t result = 0;
-    for (int8_t i = 0; i < 4; i++) {
-        int8_t ai = (a >> (sizeof(uint8_t) * 8 * i)) - 128;
-        int8_t bi = (b >> (sizeof(uint8_t) * 8 * i)) - 128;
-        int32_t intermediate = (int32_t) ai + bi;
-        if (intermediate > UCHAR_MAX) {
-            intermediate = UCHAR_MAX;
+// Mixes the voice's buffers into word_buffer as they are, or copies them when no other voice has
+// been mixed yet. Returns the number of bytes filled.
+STATIC uint32_t mix_voice_direct(audioio_mixer_voice_t* voice, mix_kernel_t mix,
+                                 bool voices_active, uint32_t* word_buffer, uint32_t length) {
+    uint32_t i = 0;
+    while (voice->sample != NULL && i < length) {
+        if (voice->buffer_length == 0 && !load_next_buffer(voice)) {
+            break;
+        }
+        // After converted playback, such as before a level change back to full, the buffer may be
+        // part way through a word. Those words, and a partial one at the end of a buffer, are put
+        // together a byte at a time until the buffer is aligned again.
+        if ((uintptr_t) voice->remaining_buffer % sizeof(uint32_t) != 0 ||
+            voice->buffer_length < sizeof(uint32_t)) {
+            uint32_t word;
+            if (!read_word_bytewise(voice, &word)) {
+                break;
+            }
+            if (!voices_active) {
+                word_buffer[i] = word;
+            } else {
+                mix(word_buffer + i, &word, 1);
+            }
+            i++;
+            continue;
+        }
+        uint32_t span = length - i;
+        if (voice->buffer_length / sizeof(uint32_t) < span) {
+            span = voice->buffer_length / sizeof(uint32_t);
+        }
+        // First active voice gets copied over verbatim.
+        if (!voices_active) {
+            memcpy(word_buffer + i, voice->remaining_buffer, span * sizeof(uint32_t));
+        } else {
+            mix(word_buffer + i, (uint32_t*) voice->remaining_buffer, span);
         }
-        result |= ((uint8_t) intermediate + 128) << (sizeof(uint8_t) * 8 * i);
+        voice->buffer_length -= span * sizeof(uint32_t);
+        voice->remaining_buffer += span * sizeof(uint32_t);
+        i += span;
     }
-    return result;
-    #endif
+    return i * sizeof(uint32_t);
 }
 
-uint32_t add16signed(uint32_t a, uint32_t b) {
-    #if (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
-    return __QADD16(a, b);
-    #else
-    uint32_t result = 0;
-    for (int8_t i = 0; i < 2; i++) {
-        int16_t ai = a >> (sizeof(int16_t) * 8 * i);
-        int16_t bi = b >> (sizeof(int16_t) * 8 * i);
-        int32_t intermediate = (int32_t) ai + bi;
-        if (intermediate > SHRT_MAX) {
-            intermediate = SHRT_MAX;
-        } else if (intermediate < SHRT_MIN) {
-            intermediate = SHRT_MIN;
+// Reads the next source frame as signed 16 bit values. Mono samples fill both channels.
+STATIC bool read_frame(audioio_mixer_voice_t* voice, int16_t* frame) {
+    uint8_t frame_size = voice->bytes_per_sample * voice->channel_count;
+    // Partial frames at the end of a buffer are dropped.
+    while (voice->buffer_length < frame_size) {
+        if (!load_next_buffer(voice)) {
+            return false;
+        }
+    }
+    uint8_t* data = voice->remaining_buffer;
+    for (uint8_t c = 0; c < voice->channel_count; c++) {
+        uint16_t value;
+        if (voice->bytes_per_sample == 1) {
+            value = data[c] << 8;
+        } else {
+            value = data[2 * c] | data[2 * c + 1] << 8;
+        }
+        if (!voice->samples_signed) {
+            value ^= 0x8000;
         }
-        result |= (((uint32_t) intermediate) & 0xffff) << (sizeof(int16_t) * 8 * i);
+        frame[c] = value;
+    }
+    if (voice->channel_count == 1) {
+        frame[1] = frame[0];
     }
-    return result;
-    #endif
+    voice->remaining_buffer += frame_size;
+    voice->buffer_length -= frame_size;
+    return true;
 }
 
-uint32_t add16unsigned(uint32_t a, uint32_t b) {
-    #if (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
-    // Subtract out the DC offset, add and then shift back.
-    a = __USUB16(a, 0x80008000);
-    b = __USUB16(b, 0x80008000);
-    uint32_t sum = __QADD16(a, b);
-    return __UADD16(sum, 0x80008000);
-    #else
-    uint32_t result = 0;
-    for (int8_t i = 0; i < 2; i++) {
-        int16_t ai = (a >> (sizeof(uint16_t) * 8 * i)) - 0x8000;
-        int16_t bi = (b >> (sizeof(uint16_t) * 8 * i)) - 0x8000;
-        int32_t intermediate = (int32_t) ai + bi;
-        if (intermediate > USHRT_MAX) {
-            intermediate = USHRT_MAX;
+// Converts the voice's sample to the mixer's encoding and rate at its level while mixing it in.
+// Returns the number of bytes filled.
+STATIC uint32_t mix_voice_converted(audioio_mixer_obj_t* self, audioio_mixer_voice_t* voice,
+                                    bool voices_active, uint32_t* word_buffer, uint32_t length) {
+    uint8_t* out = (uint8_t*) word_buffer;
+    uint8_t bytes_per_sample = self->bits_per_sample / 8;
+    uint8_t frame_size = bytes_per_sample * self->channel_count;
+    uint32_t frame_count = length * sizeof(uint32_t) / frame_size;
+    uint16_t sample_offset = self->samples_signed ? 0 : 0x8000;
+    uint32_t i = 0;
+    for (; i < frame_count; i++) {
+        while (voice->position >= MIXER_POSITION_ONE) {
+            int16_t frame[2];
+            if (voice->sample == NULL || !read_frame(voice, frame)) {
+                return i * frame_size;
+            }
+            voice->current_frame[0] = voice->next_frame[0];
+            voice->current_frame[1] = voice->next_frame[1];
+            voice->next_frame[0] = frame[0];
+            voice->next_frame[1] = frame[1];
+            voice->position -= MIXER_POSITION_ONE;
+        }
+        int32_t value[2];
+        for (uint8_t c = 0; c < 2; c++) {
+            int32_t current = voice->current_frame[c];
+            int32_t delta = voice->next_frame[c] - current;
+            value[c] = current + ((delta * (int32_t) (voice->position >> 1)) >> 15);
+            value[c] = (value[c] * voice->level) >> 15;
+        }
+        voice->position += voice->step;
+        if (self->channel_count == 1) {
+            value[0] = (value[0] + value[1]) / 2;
+        }
+        for (uint8_t c = 0; c < self->channel_count; c++) {
+            int32_t sample = value[c];
+            uint8_t* lane = out + i * frame_size + c * bytes_per_sample;
+            if (voices_active) {
+                uint16_t mixed;
+                if (bytes_per_sample == 1) {
+                    mixed = lane[0] << 8;
+                } else {
+                    mixed = lane[0] | lane[1] << 8;
+                }
+                sample += (int16_t) (mixed ^ sample_offset);
+            }
+            if (sample > INT16_MAX) {
+                sample = INT16_MAX;
+            } else if (sample < INT16_MIN) {
+                sample = INT16_MIN;
+            }
+            uint16_t encoded = ((uint16_t) sample) ^ sample_offset;
+            if (bytes_per_sample == 1) {
+                lane[0] = encoded >> 8;
+            } else {
+                lane[0] = encoded;
+                lane[1] = encoded >> 8;
+            }
         }
-        result |= ((uint16_t) intermediate + 0x8000) << (sizeof(int16_t) * 8 * i);
     }
-    return result;
-    #endif
+    return i * frame_size;
+}
+
+// Fills word_buffer with the voice's samples, mixing them in if another voice already filled it.
+// Returns false if the voice is done and nothing was written.
+STATIC bool mix_voice(audioio_mixer_obj_t* self, audioio_mixer_voice_t* voice, mix_kernel_t mix,
+                      bool voices_active, uint32_t* word_buffer, uint32_t length) {
+    uint32_t filled = 0;
+    if (voice->sample != NULL) {
+        if (voice->direct) {
+            filled = mix_voice_direct(voice, mix, voices_active, word_buffer, length);
+        } else {
+            filled = mix_voice_converted(self, voice, voices_active, word_buffer, length);
+        }
+    }
+    if (voices_active) {
+        return filled > 0;
+    }
+    // Another voice already set all samples once so only the first needs to fill in silence.
+    uint32_t silence = 0;
+    if (!self->samples_signed) {
+        if (self->bits_per_sample == 8) {
+            silence = 0x7f7f7f7f;
+        } else {
+            silence = 0x7fff7fff;
+        }
+    }
+    uint8_t* bytes = (uint8_t*) word_buffer;
+    for (; filled < length * sizeof(uint32_t); filled++) {
+        bytes[filled] = silence >> (8 * (filled % sizeof(uint32_t)));
+    }
+    return true;
 }
 
 audioio_get_buffer_result_t audioio_mixer_get_buffer(audioio_mixer_obj_t* self,
@@ -241,73 +496,18 @@ audioio_get_buffer_result_t audioio_mixer_get_buffer(audioio_mixer_obj_t* self,
             word_buffer = self->second_buffer;
         }
         self->use_first_buffer = !self->use_first_buffer;
+
+        mix_kernel_t mix;
+        if (self->bits_per_sample == 8) {
+            mix = self->samples_signed ? mix_add8signed : mix_add8unsigned;
+        } else {
+            mix = self->samples_signed ? mix_add16signed : mix_add16unsigned;
+        }
         bool voices_active = false;
         for (int32_t v = 0; v < self->voice_count; v++) {
-            audioio_mixer_voice_t* voice = &self->voice[v];
-
-            uint32_t j = 0;
-            bool voice_done = voice->sample == NULL;
-            for (uint32_t i = 0; i < self->len / sizeof(uint32_t); i++) {
-                if (!voice_done && j >= voice->buffer_length) {
-                    if (!voice->more_data) {
-                        if (voice->loop) {
-                            audiosample_reset_buffer(voice->sample, false, 0);
-                        } else {
-                            voice->sample = NULL;
-                            voice_done = true;
-                        }
-                    }
-                    if (!voice_done) {
-                        // Load another buffer
-                        audioio_get_buffer_result_t result = audiosample_get_buffer(voice->sample, false, 0, (uint8_t**) &voice->remaining_buffer, &voice->buffer_length);
-                        // Track length in terms of words.
-                        voice->buffer_length /= sizeof(uint32_t);
-                        voice->more_data = result == GET_BUFFER_MORE_DATA;
-                        j = 0;
-                    }
-                }
-                // First active voice gets copied over verbatim.
-                uint32_t sample_value;
-                if (voice_done) {
-                    // Exit early if another voice already set all samples once.
-                    if (voices_active) {
-                        continue;
-                    }
-                    sample_value = 0;
-                    if (!self->samples_signed) {
-                        if (self->bits_per_sample == 8) {
-                            sample_value = 0x7f7f7f7f;
-                        } else {
-                            sample_value = 0x7fff7fff;
-                        }
-                    }
-                } else {
-                    sample_value = voice->remaining_buffer[j];
-                }
-
-                if (!voices_active) {
-                    word_buffer[i] = sample_value;
-                } else {
-                    if (self->bits_per_sample == 8) {
-                        if (self->samples_signed) {
-                            word_buffer[i] = add8signed(word_buffer[i], sample_value);
-                        } else {
-                            word_buffer[i] = add8unsigned(word_buffer[i], sample_value);
-                        }
-                    } else {
-                        if (self->samples_signed) {
-                            word_buffer[i] = add16signed(word_buffer[i], sample_value);
-                        } else {
-                            word_buffer[i] = add16unsigned(word_buffer[i], sample_value);
-                        }
-                    }
-                }
-                j++;
+            if (mix_voice(self, &self->voice[v], mix, voices_active, word_buffer, self->len / sizeof(uint32_t))) {
+                voices_active = true;
             }
-            voice->buffer_length -= j;
-            voice->remaining_buffer += j;
-
-            voices_active = true;
         }
 
         self->read_count += 1;
@@ -31,12 +31,31 @@
 
 #include "shared-module/audiocore/__init__.h"
 
+// Full level for a voice as a Q15 fixed point value.
+#define MIXER_LEVEL_FULL (1 << 15)
+// Fixed point one for the 16.16 resampling position.
+#define MIXER_POSITION_ONE (1 << 16)
+
 typedef struct {
     mp_obj_t sample;
     bool loop;
     bool more_data;
-    uint32_t* remaining_buffer;
-    uint32_t buffer_length;
+    // True when the sample matches the mixer's encoding and plays at full level so its buffers
+    // can be mixed in as they are.
+    bool direct;
+    uint8_t* remaining_buffer;
+    uint32_t buffer_length; // in bytes
+    uint16_t level;
+    uint8_t bytes_per_sample;
+    uint8_t channel_count;
+    bool samples_signed;
+    // Resampling state. Output frames are interpolated between the current and next source
+    // frames. position is how far past the current frame the next output is. Once it reaches
+    // MIXER_POSITION_ONE, the next source frame is read.
+    uint32_t step; // Source frames per output frame in 16.16.
+    uint32_t position;
+    int16_t current_frame[2];
+    int16_t next_frame[2];
 } audioio_mixer_voice_t;
 
 typedef struct {
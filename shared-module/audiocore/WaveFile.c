@@ -48,7 +48,8 @@ struct wave_format_chunk {
 void common_hal_audioio_wavefile_construct(audioio_wavefile_obj_t* self,
                                            pyb_file_obj_t* file,
                                            uint8_t *buffer,
-                                           size_t buffer_size) {
+                                           size_t buffer_size,
+                                           uint8_t buffer_count) {
     // Load the wave
     self->file = file;
     uint8_t chunk_header[16];
@@ -110,33 +111,23 @@ void common_hal_audioio_wavefile_construct(audioio_wavefile_obj_t* self,
     self->file_length = data_length;
     self->data_start = self->file->fp.fptr;
 
-    // Try to allocate two buffers, one will be loaded from file and the other
-    // DMAed to DAC.
+    // Split the buffer into a ring so that some can be loaded from file while others are DMAed
+    // to the DAC.
+    self->buffer_count = buffer_count;
+    self->buffers_in_use = 2;
     if (buffer_size) {
-        self->len = buffer_size / 2;
+        self->len = buffer_size / buffer_count;
+        // Keep each buffer word aligned.
+        self->len -= self->len % sizeof(uint32_t);
         self->buffer = buffer;
-        self->second_buffer = buffer + self->len;
     } else {
         self->len = 256;
-        self->buffer = m_malloc(self->len, false);
-        if (self->buffer == NULL) {
-            common_hal_audioio_wavefile_deinit(self);
-            mp_raise_msg(&mp_type_MemoryError,
-                         translate("Couldn't allocate first buffer"));
-        }
-
-        self->second_buffer = m_malloc(self->len, false);
-        if (self->second_buffer == NULL) {
-            common_hal_audioio_wavefile_deinit(self);
-            mp_raise_msg(&mp_type_MemoryError,
-                         translate("Couldn't allocate second buffer"));
-        }
+        self->buffer = m_malloc(self->len * buffer_count, false);
     }
 }
 
 void common_hal_audioio_wavefile_deinit(audioio_wavefile_obj_t* self) {
     self->buffer = NULL;
-    self->second_buffer = NULL;
 }
 
 bool common_hal_audioio_wavefile_deinited(audioio_wavefile_obj_t* self) {
@@ -160,12 +151,16 @@ uint8_t common_hal_audioio_wavefile_get_channel_count(audioio_wavefile_obj_t* se
     return self->channel_count;
 }
 
+uint32_t common_hal_audioio_wavefile_get_underruns(audioio_wavefile_obj_t* self) {
+    return self->underruns;
+}
+
 bool audioio_wavefile_samples_signed(audioio_wavefile_obj_t* self) {
     return self->bits_per_sample > 8;
 }
 
 uint32_t audioio_wavefile_max_buffer_length(audioio_wavefile_obj_t* self) {
-    return 512;
+    return self->len;
 }
 
 void audioio_wavefile_reset_buffer(audioio_wavefile_obj_t* self,
@@ -178,11 +173,46 @@ void audioio_wavefile_reset_buffer(audioio_wavefile_obj_t* self,
     // loads
     self->bytes_remaining = self->file_length;
     f_lseek(&self->file->fp, self->data_start);
+    // Anything read ahead is from before the seek.
+    self->buffers_loaded = 0;
+    self->buffers_in_use = 2;
     self->read_count = 0;
     self->left_read_count = 0;
     self->right_read_count = 0;
 }
 
+// Reads the next part of the file into the given ring buffer.
+STATIC bool load_buffer(audioio_wavefile_obj_t* self, uint8_t index) {
+    uint32_t num_bytes_to_load = self->len;
+    if (num_bytes_to_load > self->bytes_remaining) {
+        num_bytes_to_load = self->bytes_remaining;
+    }
+    uint8_t* buffer = self->buffer + index * self->len;
+    UINT length_read;
+    if (f_read(&self->file->fp, buffer, num_bytes_to_load, &length_read) != FR_OK) {
+        return false;
+    }
+    self->bytes_remaining -= length_read;
+    // Pad the last buffer to word align it.
+    if (self->bytes_remaining == 0 && length_read % sizeof(uint32_t) != 0) {
+        uint32_t pad = length_read % sizeof(uint32_t);
+        length_read += pad;
+        if (self->bits_per_sample == 8) {
+            for (uint32_t i = 0; i < pad; i++) {
+                buffer[length_read / sizeof(uint8_t) - i - 1] = 0x80;
+            }
+        } else if (self->bits_per_sample == 16) {
+            // We know the buffer is aligned because every buffer length is a multiple of four.
+            #pragma GCC diagnostic push
+            #pragma GCC diagnostic ignored "-Wcast-align"
+            ((int16_t*) buffer)[length_read / sizeof(int16_t) - 1] = 0;
+            #pragma GCC diagnostic pop
+        }
+    }
+    self->buffer_lengths[index] = length_read;
+    return true;
+}
+
 audioio_get_buffer_result_t audioio_wavefile_get_buffer(audioio_wavefile_obj_t* self,
                                                         bool single_channel,
                                                         uint8_t channel,
@@ -195,65 +225,40 @@ audioio_get_buffer_result_t audioio_wavefile_get_buffer(audioio_wavefile_obj_t*
     uint32_t channel_read_count = self->left_read_count;
     if (channel == 1) {
         channel_read_count = self->right_read_count;
+        // The right channel trails the left so one more buffer may still be playing.
+        self->buffers_in_use = 3;
     }
 
     bool need_more_data = self->read_count == channel_read_count;
 
-    if (self->bytes_remaining == 0 && need_more_data) {
+    if (self->bytes_remaining == 0 && self->buffers_loaded == 0 && need_more_data) {
         *buffer = NULL;
         *buffer_length = 0;
         return GET_BUFFER_DONE;
     }
 
     if (need_more_data) {
-        uint16_t num_bytes_to_load = self->len;
-        if (num_bytes_to_load > self->bytes_remaining) {
-            num_bytes_to_load = self->bytes_remaining;
-        }
-        UINT length_read;
-        if (self->buffer_index % 2 == 1) {
-            *buffer = self->second_buffer;
-        } else {
-            *buffer = self->buffer;
-        }
-        if (f_read(&self->file->fp, *buffer, num_bytes_to_load, &length_read) != FR_OK) {
-            return GET_BUFFER_ERROR;
-        }
-        self->bytes_remaining -= length_read;
-        // Pad the last buffer to word align it.
-        if (self->bytes_remaining == 0 && length_read % sizeof(uint32_t) != 0) {
-            uint32_t pad = length_read % sizeof(uint32_t);
-            length_read += pad;
-            if (self->bits_per_sample == 8) {
-                for (uint32_t i = 0; i < pad; i++) {
-                    ((uint8_t*) (*buffer))[length_read / sizeof(uint8_t) - i - 1] = 0x80;
-                }
-            } else if (self->bits_per_sample == 16) {
-                // We know the buffer is aligned because we allocated it onto the heap ourselves.
-                #pragma GCC diagnostic push
-                #pragma GCC diagnostic ignored "-Wcast-align"
-                ((int16_t*) (*buffer))[length_read / sizeof(int16_t) - 1] = 0;
-                #pragma GCC diagnostic pop
+        if (self->buffers_loaded == 0) {
+            // The first buffers after a reset are always read on demand. Any later ones should
+            // have been read ahead if there is room for them.
+            if (self->read_count >= self->buffers_in_use &&
+                self->buffer_count > self->buffers_in_use) {
+                self->underruns += 1;
             }
+            if (!load_buffer(self, self->buffer_index)) {
+                return GET_BUFFER_ERROR;
+            }
+            self->buffers_loaded = 1;
         }
-        *buffer_length = length_read;
-        if (self->buffer_index % 2 == 1) {
-            self->second_buffer_length = length_read;
-        } else {
-            self->buffer_length = length_read;
-        }
-        self->buffer_index += 1;
+        self->buffer_index = (self->buffer_index + 1) % self->buffer_count;
+        self->buffers_loaded -= 1;
         self->read_count += 1;
     }
 
     uint32_t buffers_back = self->read_count - 1 - channel_read_count;
-    if ((self->buffer_index - buffers_back) % 2 == 0) {
-        *buffer = self->second_buffer;
-        *buffer_length = self->second_buffer_length;
-    } else {
-        *buffer = self->buffer;
-        *buffer_length = self->buffer_length;
-    }
+    uint8_t index = (self->buffer_index + self->buffer_count - 1 - buffers_back) % self->buffer_count;
+    *buffer = self->buffer + index * self->len;
+    *buffer_length = self->buffer_lengths[index];
 
     if (channel == 0) {
         self->left_read_count += 1;
@@ -262,7 +267,27 @@ audioio_get_buffer_result_t audioio_wavefile_get_buffer(audioio_wavefile_obj_t*
         *buffer = *buffer + self->bits_per_sample / 8;
     }
 
-    return self->bytes_remaining == 0 ? GET_BUFFER_DONE : GET_BUFFER_MORE_DATA;
+    if (self->bytes_remaining == 0 && self->buffers_loaded == 0) {
+        return GET_BUFFER_DONE;
+    }
+    return GET_BUFFER_MORE_DATA;
+}
+
+// Reads ahead into the buffers that aren't waiting to be played. Called from background tasks
+// while playing so that get_buffer rarely has to wait on the filesystem.
+void audioio_wavefile_prefetch(audioio_wavefile_obj_t* self) {
+    if (self->buffer == NULL) {
+        return;
+    }
+    while (self->bytes_remaining > 0 &&
+           self->buffers_loaded + self->buffers_in_use < self->buffer_count) {
+        uint8_t index = (self->buffer_index + self->buffers_loaded) % self->buffer_count;
+        // Errors are left for get_buffer to report when it reads the buffer itself.
+        if (!load_buffer(self, index)) {
+            return;
+        }
+        self->buffers_loaded += 1;
+    }
 }
 
 void audioio_wavefile_get_buffer_structure(audioio_wavefile_obj_t* self, bool single_channel,
@@ -270,7 +295,7 @@ void audioio_wavefile_get_buffer_structure(audioio_wavefile_obj_t* self, bool si
                                            uint32_t* max_buffer_length, uint8_t* spacing) {
     *single_buffer = false;
     *samples_signed = self->bits_per_sample > 8;
-    *max_buffer_length = 512;
+    *max_buffer_length = self->len;
     if (single_channel) {
         *spacing = self->channel_count;
     } else {
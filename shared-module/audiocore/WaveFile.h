@@ -32,17 +32,23 @@
 
 #include "shared-module/audiocore/__init__.h"
 
+// Most buffers a WaveFile can read into. They are used as a ring so that buffers can be read ahead
+// of playback.
+#define AUDIOIO_WAVEFILE_MAX_BUFFERS (8)
+
 typedef struct {
     mp_obj_base_t base;
-    uint8_t* buffer;
-    uint32_t buffer_length;
-    uint8_t* second_buffer;
-    uint32_t second_buffer_length;
+    uint8_t* buffer; // buffer_count buffers of len bytes each
+    uint32_t buffer_lengths[AUDIOIO_WAVEFILE_MAX_BUFFERS];
     uint32_t file_length; // In bytes
     uint16_t data_start; // Where the data values start
     uint8_t bits_per_sample;
-    uint16_t buffer_index;
+    uint8_t buffer_count;
+    uint8_t buffer_index; // Next buffer to hand out.
+    uint8_t buffers_loaded; // Buffers read ahead starting at buffer_index.
+    uint8_t buffers_in_use; // Handed out buffers that may still be playing.
     uint32_t bytes_remaining;
+    uint32_t underruns;
 
     uint8_t channel_count;
     uint32_t sample_rate;
@@ -64,6 +70,7 @@ audioio_get_buffer_result_t audioio_wavefile_get_buffer(audioio_wavefile_obj_t*
                                                         uint8_t channel,
                                                         uint8_t** buffer,
                                                         uint32_t* buffer_length); // length in bytes
+void audioio_wavefile_prefetch(audioio_wavefile_obj_t* self);
 void audioio_wavefile_get_buffer_structure(audioio_wavefile_obj_t* self, bool single_channel,
                                            bool* single_buffer, bool* samples_signed,
                                            uint32_t* max_buffer_length, uint8_t* spacing);
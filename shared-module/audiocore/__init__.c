@@ -106,6 +106,23 @@ audioio_get_buffer_result_t audiosample_get_buffer(mp_obj_t sample_obj,
     return GET_BUFFER_DONE;
 }
 
+// Lets samples that stream from storage read ahead. Called from background tasks while the sample
+// is playing.
+void audiosample_prefetch(mp_obj_t sample_obj) {
+    if (MP_OBJ_IS_TYPE(sample_obj, &audioio_wavefile_type)) {
+        audioio_wavefile_obj_t* file = MP_OBJ_TO_PTR(sample_obj);
+        audioio_wavefile_prefetch(file);
+    } else if (MP_OBJ_IS_TYPE(sample_obj, &audioio_mixer_type)) {
+        audioio_mixer_obj_t* mixer = MP_OBJ_TO_PTR(sample_obj);
+        for (uint8_t v = 0; v < mixer->voice_count; v++) {
+            mp_obj_t voice_sample = mixer->voice[v].sample;
+            if (voice_sample != NULL) {
+                audiosample_prefetch(voice_sample);
+            }
+        }
+    }
+}
+
 void audiosample_get_buffer_structure(mp_obj_t sample_obj, bool single_channel,
                                       bool* single_buffer, bool* samples_signed,
                                       uint32_t* max_buffer_length, uint8_t* spacing) {
@@ -46,6 +46,7 @@ audioio_get_buffer_result_t audiosample_get_buffer(mp_obj_t sample_obj,
                                                    bool single_channel,
                                                    uint8_t channel,
                                                    uint8_t** buffer, uint32_t* buffer_length);
+void audiosample_prefetch(mp_obj_t sample_obj);
 void audiosample_get_buffer_structure(mp_obj_t sample_obj, bool single_channel,
                                       bool* single_buffer, bool* samples_signed,
                                       uint32_t* max_buffer_length, uint8_t* spacing);
@@ -120,6 +120,13 @@ bool displayio_colorconverter_convert(displayio_colorconverter_t *self, const _d
     return false;
 }
 
+// Returns true when every input color converts to an opaque pixel in the given colorspace. This
+// must match the cases handled by displayio_colorconverter_convert.
+bool displayio_colorconverter_is_opaque(displayio_colorconverter_t *self, const _displayio_colorspace_t* colorspace) {
+    return colorspace->depth == 16 || colorspace->tricolor ||
+        (colorspace->grayscale && colorspace->depth <= 8);
+}
+
 void common_hal_displayio_colorconverter_convert(displayio_colorconverter_t *self, const _displayio_colorspace_t* colorspace, uint32_t input_color, uint32_t* output_color) {
     displayio_colorconverter_convert(self, colorspace, input_color, output_color);
 }
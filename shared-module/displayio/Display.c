@@ -26,6 +26,7 @@
 
 #include "shared-bindings/displayio/Display.h"
 
+#include "py/gc.h"
 #include "py/runtime.h"
 #include "shared-bindings/displayio/FourWire.h"
 #include "shared-bindings/displayio/I2CDisplay.h"
@@ -71,6 +72,11 @@ void common_hal_displayio_display_construct(displayio_display_obj_t* self,
     self->native_frames_per_second = native_frames_per_second;
     self->native_ms_per_frame = 1000 / native_frames_per_second;
 
+    // Always clear the refresh buffer in case we're reusing memory.
+    self->refresh_buffer_allocation = NULL;
+    self->refresh_buffer = NULL;
+    displayio_display_allocate_refresh_buffer(self);
+
     uint32_t i = 0;
     while (i < init_sequence_len) {
         uint8_t *cmd = init_sequence + i;
@@ -190,12 +196,17 @@ mp_obj_t common_hal_displayio_display_get_bus(displayio_display_obj_t* self) {
     return self->core.bus;
 }
 
+const displayio_refresh_stats_t* common_hal_displayio_display_get_refresh_stats(displayio_display_obj_t* self) {
+    return &self->refresh_stats;
+}
+
 STATIC const displayio_area_t* _get_refresh_areas(displayio_display_obj_t *self) {
     if (self->core.full_refresh) {
         self->core.area.next = NULL;
         return &self->core.area;
     } else if (self->core.current_group != NULL) {
-        return displayio_group_get_refresh_areas(self->core.current_group, NULL);
+        const displayio_area_t* areas = displayio_group_get_refresh_areas(self->core.current_group, NULL);
+        return displayio_display_core_plan_refresh_areas(&self->core, areas);
     }
     return NULL;
 }
@@ -207,8 +218,19 @@ STATIC void _send_pixels(displayio_display_obj_t* self, uint8_t* pixels, uint32_
     self->core.send(self->core.bus, DISPLAY_DATA, CHIP_SELECT_UNTOUCHED, pixels, length);
 }
 
+STATIC void _fill_subrectangle(displayio_display_obj_t* self, displayio_area_t* subrectangle,
+        uint32_t* mask, uint32_t mask_length, uint32_t* buffer, uint16_t buffer_size) {
+    memset(mask, 0, mask_length * sizeof(mask[0]));
+    memset(buffer, 0, buffer_size * sizeof(buffer[0]));
+
+    displayio_display_core_fill_area(&self->core, subrectangle, mask, buffer);
+}
+
 STATIC bool _refresh_area(displayio_display_obj_t* self, const displayio_area_t* area) {
     uint16_t buffer_size = 128; // In uint32_ts
+    if (self->refresh_buffer != NULL) {
+        buffer_size = self->refresh_buffer_size;
+    }
 
     displayio_area_t clipped;
     // Clip the area to the display by overlapping the areas. If there is no overlap then we're done.
@@ -218,7 +240,7 @@ STATIC bool _refresh_area(displayio_display_obj_t* self, const displayio_area_t*
     uint16_t subrectangles = 1;
     uint16_t rows_per_buffer = displayio_area_height(&clipped);
     uint8_t pixels_per_word = (sizeof(uint32_t) * 8) / self->core.colorspace.depth;
-    uint16_t pixels_per_buffer = displayio_area_size(&clipped);
+    uint32_t pixels_per_buffer = displayio_area_size(&clipped);
     if (displayio_area_size(&clipped) > buffer_size * pixels_per_word) {
         rows_per_buffer = buffer_size * pixels_per_word / displayio_area_width(&clipped);
         if (rows_per_buffer == 0) {
@@ -241,49 +263,63 @@ STATIC bool _refresh_area(displayio_display_obj_t* self, const displayio_area_t*
             buffer_size += 1;
         }
     }
-
-    // Allocated and shared as a uint32_t array so the compiler knows the
-    // alignment everywhere.
-    uint32_t buffer[buffer_size];
     uint32_t mask_length = (pixels_per_buffer / 32) + 1;
-    uint32_t mask[mask_length];
-    uint16_t remaining_rows = displayio_area_height(&clipped);
+
+    // Allocated and shared as uint32_t arrays so the compiler knows the alignment everywhere. The
+    // stack is only used when the refresh buffer couldn't be allocated.
+    uint32_t stack_buffer[self->refresh_buffer == NULL ? buffer_size + mask_length : 1];
+    uint32_t* buffer;
+    uint32_t* mask;
+    if (self->refresh_buffer != NULL) {
+        buffer = self->refresh_buffer;
+        mask = buffer + self->refresh_buffer_size;
+    } else {
+        buffer = stack_buffer;
+        mask = stack_buffer + buffer_size;
+    }
+
+    displayio_area_t subrectangle = {
+        .x1 = clipped.x1,
+        .y1 = clipped.y1,
+        .x2 = clipped.x2,
+        .y2 = clipped.y1 + rows_per_buffer
+    };
+    if (subrectangle.y2 > clipped.y2) {
+        subrectangle.y2 = clipped.y2;
+    }
+    _fill_subrectangle(self, &subrectangle, mask, mask_length, buffer, buffer_size);
 
     for (uint16_t j = 0; j < subrectangles; j++) {
-        displayio_area_t subrectangle = {
-            .x1 = clipped.x1,
-            .y1 = clipped.y1 + rows_per_buffer * j,
-            .x2 = clipped.x2,
-            .y2 = clipped.y1 + rows_per_buffer * (j + 1)
-        };
-        if (remaining_rows < rows_per_buffer) {
-            subrectangle.y2 = subrectangle.y1 + remaining_rows;
+        // Can't acquire display bus; skip the rest of the data.
+        if (!displayio_display_core_bus_free(&self->core)) {
+            return false;
         }
-        remaining_rows -= rows_per_buffer;
 
         displayio_display_core_set_region_to_update(&self->core, self->set_column_command, self->set_row_command, NO_COMMAND, NO_COMMAND, self->data_as_commands, false, &subrectangle);
 
-        uint16_t subrectangle_size_bytes;
+        uint32_t subrectangle_size_bytes;
         if (self->core.colorspace.depth >= 8) {
             subrectangle_size_bytes = displayio_area_size(&subrectangle) * (self->core.colorspace.depth / 8);
         } else {
             subrectangle_size_bytes = displayio_area_size(&subrectangle) / (8 / self->core.colorspace.depth);
         }
 
-        memset(mask, 0, mask_length * sizeof(mask[0]));
-        memset(buffer, 0, buffer_size * sizeof(buffer[0]));
-
-        displayio_display_core_fill_area(&self->core, &subrectangle, mask, buffer);
-
-        // Can't acquire display bus; skip the rest of the data.
-        if (!displayio_display_core_bus_free(&self->core)) {
-            return false;
-        }
-
         displayio_display_core_begin_transaction(&self->core);
         _send_pixels(self, (uint8_t*) buffer, subrectangle_size_bytes);
+        self->refresh_stats.pixels += displayio_area_size(&subrectangle);
+        self->refresh_stats.bytes += subrectangle_size_bytes;
+
         displayio_display_core_end_transaction(&self->core);
 
+        if (j + 1 < subrectangles) {
+            subrectangle.y1 = subrectangle.y2;
+            subrectangle.y2 = subrectangle.y1 + rows_per_buffer;
+            if (subrectangle.y2 > clipped.y2) {
+                subrectangle.y2 = clipped.y2;
+            }
+            _fill_subrectangle(self, &subrectangle, mask, mask_length, buffer, buffer_size);
+        }
+
         // TODO(tannewt): Make refresh displays faster so we don't starve other
         // background tasks.
         usb_background();
@@ -297,8 +333,12 @@ STATIC void _refresh_display(displayio_display_obj_t* self) {
         return;
     }
     displayio_display_core_start_refresh(&self->core);
+    self->refresh_stats.areas = 0;
+    self->refresh_stats.pixels = 0;
+    self->refresh_stats.bytes = 0;
     const displayio_area_t* current_area = _get_refresh_areas(self);
     while (current_area != NULL) {
+        self->refresh_stats.areas++;
         _refresh_area(self, current_area);
         current_area = current_area->next;
     }
@@ -368,6 +408,11 @@ void displayio_display_background(displayio_display_obj_t* self) {
 
 void release_display(displayio_display_obj_t* self) {
     release_display_core(&self->core);
+    if (self->refresh_buffer_allocation != NULL) {
+        free_memory(self->refresh_buffer_allocation);
+        self->refresh_buffer_allocation = NULL;
+    }
+    self->refresh_buffer = NULL;
     if (self->backlight_pwm.base.type == &pulseio_pwmout_type) {
         common_hal_pulseio_pwmout_reset_ok(&self->backlight_pwm);
         common_hal_pulseio_pwmout_deinit(&self->backlight_pwm);
@@ -380,8 +425,40 @@ void reset_display(displayio_display_obj_t* self) {
     self->auto_refresh = true;
     self->auto_brightness = true;
     common_hal_displayio_display_show(self, NULL);
+    // A refresh buffer on the heap goes away with it. supervisor_move_memory() replaces it.
+    if (self->refresh_buffer_allocation == NULL) {
+        self->refresh_buffer = NULL;
+    }
+}
+
+void displayio_display_allocate_refresh_buffer(displayio_display_obj_t* self) {
+    if (self->refresh_buffer != NULL) {
+        return;
+    }
+    // Each pixel buffer holds at least one full row so subrectangles never outgrow it.
+    uint8_t pixels_per_word = (sizeof(uint32_t) * 8) / self->core.colorspace.depth;
+    uint16_t max_row = self->core.width > self->core.height ? self->core.width : self->core.height;
+    uint16_t buffer_size = CIRCUITPY_DISPLAY_REFRESH_BUFFER_SIZE;
+    if (buffer_size * pixels_per_word < max_row) {
+        buffer_size = (max_row + pixels_per_word - 1) / pixels_per_word;
+    }
+    uint32_t mask_length = (buffer_size * pixels_per_word / 32) + 1;
+    uint32_t length = (buffer_size + mask_length) * sizeof(uint32_t);
+
+    self->refresh_buffer_allocation = allocate_memory(length, false);
+    if (self->refresh_buffer_allocation != NULL) {
+        self->refresh_buffer = self->refresh_buffer_allocation->ptr;
+    } else {
+        // The supervisor can't allocate while the VM is running so use the heap until it stops.
+        // _refresh_area falls back to the stack when this fails too.
+        self->refresh_buffer = m_malloc_maybe(length, true);
+    }
+    self->refresh_buffer_size = buffer_size;
 }
 
 void displayio_display_collect_ptrs(displayio_display_obj_t* self) {
     displayio_display_core_collect_ptrs(&self->core);
+    if (self->refresh_buffer_allocation == NULL) {
+        gc_collect_ptr(self->refresh_buffer);
+    }
 }
@@ -33,6 +33,13 @@
 
 #include "shared-module/displayio/area.h"
 #include "shared-module/displayio/display_core.h"
+#include "supervisor/memory.h"
+
+typedef struct {
+    uint32_t areas;
+    uint32_t pixels;
+    uint32_t bytes; // Pixel data only.
+} displayio_refresh_stats_t;
 
 typedef struct {
     mp_obj_base_t base;
@@ -41,6 +48,10 @@ typedef struct {
         digitalio_digitalinout_obj_t backlight_inout;
         pulseio_pwmout_obj_t backlight_pwm;
     };
+    supervisor_allocation* refresh_buffer_allocation; // NULL when refresh_buffer is on the heap.
+    uint32_t* refresh_buffer;
+    uint16_t refresh_buffer_size; // In uint32_ts per pixel buffer.
+    displayio_refresh_stats_t refresh_stats; // Of the last refresh.
     uint64_t last_backlight_refresh;
     uint64_t last_refresh_call;
     mp_float_t current_brightness;
@@ -60,6 +71,7 @@ typedef struct {
 void displayio_display_background(displayio_display_obj_t* self);
 void release_display(displayio_display_obj_t* self);
 void reset_display(displayio_display_obj_t* self);
+void displayio_display_allocate_refresh_buffer(displayio_display_obj_t* self);
 
 void displayio_display_collect_ptrs(displayio_display_obj_t* self);
 
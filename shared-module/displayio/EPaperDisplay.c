@@ -114,7 +114,7 @@ const displayio_area_t* displayio_epaperdisplay_get_refresh_areas(displayio_epap
         self->core.area.next = NULL;
         return &self->core.area;
     }
-    return first_area;
+    return displayio_display_core_plan_refresh_areas(&self->core, first_area);
 }
 
 uint16_t common_hal_displayio_epaperdisplay_get_width(displayio_epaperdisplay_obj_t* self){
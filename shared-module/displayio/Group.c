@@ -274,13 +274,30 @@ bool displayio_group_fill_area(displayio_group_t *self, const _displayio_colorsp
     // Track if any of the layers finishes filling in the given area. We can ignore any remaining
     // layers at that point.
     bool full_coverage = false;
+    // The largest region of the area covered by an opaque TileGrid so far. Anything beneath that is
+    // entirely within it is hidden and can be skipped.
+    displayio_area_t opaque_area;
+    bool has_opaque_area = false;
     for (int32_t i = self->size - 1; i >= 0 ; i--) {
         mp_obj_t layer = self->children[i].native;
         if (MP_OBJ_IS_TYPE(layer, &displayio_tilegrid_type)) {
-            if (displayio_tilegrid_fill_area(layer, colorspace, area, mask, buffer)) {
+            displayio_tilegrid_t* tilegrid = layer;
+            displayio_area_t overlap;
+            if (!displayio_area_compute_overlap(area, &tilegrid->current_area, &overlap)) {
+                continue;
+            }
+            if (has_opaque_area && displayio_area_contains(&opaque_area, &overlap)) {
+                continue;
+            }
+            if (displayio_tilegrid_fill_area(tilegrid, colorspace, area, mask, buffer)) {
                 full_coverage = true;
                 break;
             }
+            if (displayio_tilegrid_is_opaque(tilegrid, colorspace) &&
+                (!has_opaque_area || displayio_area_size(&overlap) > displayio_area_size(&opaque_area))) {
+                displayio_area_copy(&overlap, &opaque_area);
+                has_opaque_area = true;
+            }
         } else if (MP_OBJ_IS_TYPE(layer, &displayio_group_type)) {
             if (displayio_group_fill_area(layer, colorspace, area, mask, buffer)) {
                 full_coverage = true;
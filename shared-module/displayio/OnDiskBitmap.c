@@ -35,7 +35,7 @@ static uint32_t read_word(uint16_t* bmp_header, uint16_t index) {
     return bmp_header[index] | bmp_header[index + 1] << 16;
 }
 
-void common_hal_displayio_ondiskbitmap_construct(displayio_ondiskbitmap_t *self, pyb_file_obj_t* file) {
+void common_hal_displayio_ondiskbitmap_construct(displayio_ondiskbitmap_t *self, pyb_file_obj_t* file, uint16_t cached_rows) {
     // Load the wave
     self->file = file;
     uint16_t bmp_header[69];
@@ -114,6 +114,101 @@ void common_hal_displayio_ondiskbitmap_construct(displayio_ondiskbitmap_t *self,
         self->stride = (bit_stride / 8);
     }
 
+    if (self->data_offset + (uint32_t) self->height * self->stride > f_size(&self->file->fp)) {
+        mp_raise_ValueError(translate("Invalid BMP file"));
+    }
+
+    // Decoding happens in place so a row must also fit the raw data. It always does because the
+    // stride is at most four bytes per pixel.
+    self->row_cache = NULL;
+    self->row_cache_y = NULL;
+    self->cached_rows = 0;
+    self->last_x = -1;
+    self->last_y = -1;
+    if (cached_rows > self->height) {
+        cached_rows = self->height;
+    }
+    if (cached_rows > 0) {
+        // Without a cache we fall back to reading each pixel from the file.
+        uint32_t* row_cache = m_new_maybe(uint32_t, (size_t) cached_rows * self->width);
+        int16_t* row_cache_y = m_new_maybe(int16_t, cached_rows);
+        if (row_cache != NULL && row_cache_y != NULL) {
+            for (uint16_t i = 0; i < cached_rows; i++) {
+                row_cache_y[i] = -1;
+            }
+            self->row_cache = row_cache;
+            self->row_cache_y = row_cache_y;
+            self->cached_rows = cached_rows;
+        }
+    }
+}
+
+// Decodes the raw file data at the start of row into 24-bit colors. We go right to left so each
+// decoded pixel only overwrites raw data that has already been used.
+STATIC void _decode_row(displayio_ondiskbitmap_t *self, uint32_t* row) {
+    uint8_t* raw = (uint8_t*) row;
+    if (self->bits_per_pixel < 8) {
+        uint8_t pixels_per_byte = 8 / self->bits_per_pixel;
+        uint8_t mask = (1 << self->bits_per_pixel) - 1;
+        for (int32_t x = self->width - 1; x >= 0; x--) {
+            uint8_t offset = (x % pixels_per_byte) * self->bits_per_pixel;
+            uint8_t index = (raw[x / pixels_per_byte] >> ((8 - self->bits_per_pixel) - offset)) & mask;
+            if (self->bits_per_pixel == 1) {
+                row[x] = index == 1 ? 0xFFFFFF : 0x000000;
+            } else {
+                row[x] = self->palette_data[index];
+            }
+        }
+    } else if (self->bits_per_pixel == 8) {
+        for (int32_t x = self->width - 1; x >= 0; x--) {
+            row[x] = self->palette_data[raw[x]];
+        }
+    } else if (self->bits_per_pixel == 16) {
+        uint8_t red_shift = 10;
+        uint8_t green_shift = 4;
+        if (self->g_bitmask == 0x07e0) { // 565
+            red_shift = 11;
+            green_shift = 5;
+        }
+        for (int32_t x = self->width - 1; x >= 0; x--) {
+            uint32_t pixel_data = raw[2 * x] | raw[2 * x + 1] << 8;
+            uint8_t red = (pixel_data & self->r_bitmask) >> red_shift;
+            uint8_t green = (pixel_data & self->g_bitmask) >> green_shift;
+            uint8_t blue = pixel_data & self->b_bitmask;
+            row[x] = red << 19 | green << 10 | blue << 3;
+        }
+    } else if (self->bits_per_pixel == 24) {
+        for (int32_t x = self->width - 1; x >= 0; x--) {
+            row[x] = raw[3 * x] | raw[3 * x + 1] << 8 | raw[3 * x + 2] << 16;
+        }
+    } else if (self->bitfield_compressed) {
+        for (int32_t x = self->width - 1; x >= 0; x--) {
+            row[x] &= 0x00FFFFFF;
+        }
+    }
+}
+
+// Returns the decoded row y, or NULL when it isn't cached and reading it is not worthwhile or
+// fails.
+STATIC uint32_t* _get_cached_row(displayio_ondiskbitmap_t *self, int16_t y, bool load) {
+    uint16_t slot = y % self->cached_rows;
+    uint32_t* row = self->row_cache + slot * self->width;
+    if (self->row_cache_y[slot] == y) {
+        return row;
+    }
+    if (!load) {
+        return NULL;
+    }
+    uint32_t location = self->data_offset + (self->height - y - 1) * self->stride;
+    f_lseek(&self->file->fp, location);
+    UINT bytes_read;
+    if (f_read(&self->file->fp, row, self->stride, &bytes_read) != FR_OK || bytes_read != self->stride) {
+        self->row_cache_y[slot] = -1;
+        return NULL;
+    }
+    _decode_row(self, row);
+    self->row_cache_y[slot] = y;
+    return row;
 }
 
 
@@ -122,6 +217,17 @@ uint32_t common_hal_displayio_ondiskbitmap_get_pixel(displayio_ondiskbitmap_t *s
     if (x < 0 || x >= self->width || y < 0 || y >= self->height) {
         return 0;
     }
+    if (self->row_cache != NULL) {
+        // Only load rows that are being read along. Going down a column, such as for a rotated
+        // display, would read a whole row for each pixel so those pixels are read singly below.
+        bool along_row = x != self->last_x || y == self->last_y;
+        self->last_x = x;
+        self->last_y = y;
+        uint32_t* row = _get_cached_row(self, y, along_row);
+        if (row != NULL) {
+            return row[x];
+        }
+    }
 
     uint32_t location;
     uint8_t bytes_per_pixel = (self->bits_per_pixel / 8)  ? (self->bits_per_pixel /8) : 1;
@@ -136,7 +242,7 @@ uint32_t common_hal_displayio_ondiskbitmap_get_pixel(displayio_ondiskbitmap_t *s
     UINT bytes_read;
     uint32_t pixel_data = 0;
     uint32_t result = f_read(&self->file->fp, &pixel_data, bytes_per_pixel, &bytes_read);
-    if (result == FR_OK) {
+    if (result == FR_OK && bytes_read == bytes_per_pixel) {
         uint32_t tmp = 0;
         uint8_t red;
         uint8_t green;
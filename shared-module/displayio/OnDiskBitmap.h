@@ -47,6 +47,13 @@ typedef struct {
     pyb_file_obj_t* file;
     uint8_t bits_per_pixel;
     uint32_t* palette_data;
+    // Decoded rows of 24-bit color, cached_rows * width long. NULL when not caching.
+    uint32_t* row_cache;
+    int16_t* row_cache_y; // Bitmap row held in each cache slot or -1.
+    uint16_t cached_rows;
+    // Last pixel read through the cache, to tell reads along a row from reads down a column.
+    int16_t last_x;
+    int16_t last_y;
 } displayio_ondiskbitmap_t;
 
 #endif // MICROPY_INCLUDED_SHARED_MODULE_DISPLAYIO_ONDISKBITMAP_H
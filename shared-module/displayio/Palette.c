@@ -31,14 +31,28 @@
 void common_hal_displayio_palette_construct(displayio_palette_t* self, uint16_t color_count) {
     self->color_count = color_count;
     self->colors = (_displayio_color_t *) m_malloc(color_count * sizeof(_displayio_color_t), false);
+    for (uint32_t i = 0; i < color_count; i++) {
+        self->colors[i].transparent = false;
+    }
+    self->transparent_count = 0;
 }
 
 void common_hal_displayio_palette_make_opaque(displayio_palette_t* self, uint32_t palette_index) {
+    if (!self->colors[palette_index].transparent) {
+        return;
+    }
     self->colors[palette_index].transparent = false;
+    self->transparent_count--;
+    self->needs_refresh = true;
 }
 
 void common_hal_displayio_palette_make_transparent(displayio_palette_t* self, uint32_t palette_index) {
+    if (self->colors[palette_index].transparent) {
+        return;
+    }
     self->colors[palette_index].transparent = true;
+    self->transparent_count++;
+    self->needs_refresh = true;
 }
 
 uint32_t common_hal_displayio_palette_get_len(displayio_palette_t* self) {
@@ -64,7 +78,7 @@ uint32_t common_hal_displayio_palette_get_color(displayio_palette_t* self, uint3
 }
 
 bool displayio_palette_get_color(displayio_palette_t *self, const _displayio_colorspace_t* colorspace, uint32_t palette_index, uint32_t* color) {
-    if (palette_index > self->color_count || self->colors[palette_index].transparent) {
+    if (palette_index >= self->color_count || self->colors[palette_index].transparent) {
         return false; // returns opaque
     }
 
@@ -89,6 +103,10 @@ bool displayio_palette_get_color(displayio_palette_t *self, const _displayio_col
     return true;
 }
 
+bool displayio_palette_is_opaque(displayio_palette_t *self) {
+    return self->transparent_count == 0;
+}
+
 bool displayio_palette_needs_refresh(displayio_palette_t *self) {
     return self->needs_refresh;
 }
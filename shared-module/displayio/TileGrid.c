@@ -296,6 +296,136 @@ void common_hal_displayio_tilegrid_set_top_left(displayio_tilegrid_t *self, uint
     self->full_change = true;
 }
 
+// Reads a value out of a bitmap row without bounds checks. The caller guarantees x is within
+// the bitmap.
+static inline uint32_t _bitmap_row_get_value(const displayio_bitmap_t *bitmap, const size_t* row, uint16_t x) {
+    if (bitmap->bits_per_value < 8) {
+        size_t word = row[x >> bitmap->x_shift];
+        return (word >> (sizeof(size_t) * 8 - ((x & bitmap->x_mask) + 1) * bitmap->bits_per_value)) & bitmap->bitmask;
+    } else if (bitmap->bits_per_value == 8) {
+        return ((uint8_t*) row)[x];
+    } else if (bitmap->bits_per_value == 16) {
+        return ((uint16_t*) row)[x];
+    }
+    return ((uint32_t*) row)[x];
+}
+
+// Returns true when the mask has no pixels set yet.
+static bool _mask_is_clear(const uint32_t* mask, uint32_t pixels) {
+    for (uint32_t i = 0; i < (pixels + 31) / 32; i++) {
+        if (mask[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool displayio_tilegrid_is_opaque(displayio_tilegrid_t *self, const _displayio_colorspace_t* colorspace) {
+    if (!self->inline_tiles && self->tiles == NULL) {
+        return false;
+    }
+    if (self->pixel_shader == mp_const_none) {
+        return true;
+    } else if (MP_OBJ_IS_TYPE(self->pixel_shader, &displayio_palette_type)) {
+        displayio_palette_t* palette = self->pixel_shader;
+        if (!displayio_palette_is_opaque(palette)) {
+            return false;
+        }
+        // Values outside of the palette are transparent so make sure the source can't produce any.
+        if (MP_OBJ_IS_TYPE(self->bitmap, &displayio_bitmap_type)) {
+            displayio_bitmap_t* bitmap = self->bitmap;
+            return bitmap->bits_per_value <= 8 && (1U << bitmap->bits_per_value) <= palette->color_count;
+        } else if (MP_OBJ_IS_TYPE(self->bitmap, &displayio_shape_type)) {
+            return palette->color_count >= 2;
+        }
+    } else if (MP_OBJ_IS_TYPE(self->pixel_shader, &displayio_colorconverter_type)) {
+        return displayio_colorconverter_is_opaque(self->pixel_shader, colorspace);
+    }
+    return false;
+}
+
+// Fast path for an in-memory Bitmap shaded by a Palette or ColorConverter into a 16 bit
+// colorspace. Rows are walked one tile span at a time so the tile lookup is done once per span
+// instead of once per pixel. Returns false if any pixel was transparent.
+static bool _fill_area_rgb565(displayio_tilegrid_t *self, uint8_t* tiles, bool palette_shader,
+                              int16_t start_x, int16_t end_x, int16_t start_y, int16_t end_y,
+                              int16_t start, int16_t x_shift, int16_t y_shift,
+                              int16_t x_stride, int16_t y_stride,
+                              bool check_mask, bool update_mask,
+                              uint32_t* mask, uint16_t* buffer) {
+    displayio_bitmap_t* bitmap = self->bitmap;
+    displayio_palette_t* palette = self->pixel_shader;
+    uint8_t scale = self->absolute_transform->scale;
+    bool opaque = true;
+
+    // The ColorConverter is a pure function of the input so cache the last conversion. Rows
+    // commonly repeat the same color.
+    uint32_t last_value = 0;
+    uint16_t last_pixel = displayio_colorconverter_compute_rgb565(last_value);
+
+    for (int16_t y = start_y; y < end_y; y++) {
+        int16_t offset = start + (y - start_y + y_shift) * y_stride + x_shift * x_stride; // in pixels
+        int16_t local_y = y / scale;
+        uint16_t tile_row = ((local_y / self->tile_height + self->top_left_y) % self->height_in_tiles) * self->width_in_tiles;
+        uint16_t tile_y_offset = local_y % self->tile_height;
+
+        int16_t x = start_x;
+        while (x < end_x) {
+            int16_t local_x = x / scale;
+            uint16_t tile_column = local_x / self->tile_width;
+            uint8_t tile = tiles[tile_row + (tile_column + self->top_left_x) % self->width_in_tiles];
+            uint16_t bitmap_x = (tile % self->bitmap_width_in_tiles) * self->tile_width + local_x % self->tile_width;
+            uint16_t bitmap_y = (tile / self->bitmap_width_in_tiles) * self->tile_height + tile_y_offset;
+            const size_t* row = bitmap->data + bitmap_y * bitmap->stride;
+
+            int32_t span_end = (tile_column + 1) * self->tile_width * scale;
+            if (span_end > end_x) {
+                span_end = end_x;
+            }
+            // Number of destination pixels left that share the current bitmap pixel.
+            uint8_t repeat = scale - x % scale;
+            if (palette_shader) {
+                for (; x < span_end; x++, offset += x_stride) {
+                    if (!check_mask || (mask[offset / 32] & (1 << (offset % 32))) == 0) {
+                        uint32_t value = _bitmap_row_get_value(bitmap, row, bitmap_x);
+                        if (value >= palette->color_count || palette->colors[value].transparent) {
+                            opaque = false;
+                        } else {
+                            if (update_mask) {
+                                mask[offset / 32] |= 1 << (offset % 32);
+                            }
+                            buffer[offset] = palette->colors[value].rgb565;
+                        }
+                    }
+                    if (--repeat == 0) {
+                        repeat = scale;
+                        bitmap_x++;
+                    }
+                }
+            } else {
+                for (; x < span_end; x++, offset += x_stride) {
+                    if (!check_mask || (mask[offset / 32] & (1 << (offset % 32))) == 0) {
+                        uint32_t value = _bitmap_row_get_value(bitmap, row, bitmap_x);
+                        if (value != last_value) {
+                            last_value = value;
+                            last_pixel = displayio_colorconverter_compute_rgb565(value);
+                        }
+                        if (update_mask) {
+                            mask[offset / 32] |= 1 << (offset % 32);
+                        }
+                        buffer[offset] = last_pixel;
+                    }
+                    if (--repeat == 0) {
+                        repeat = scale;
+                        bitmap_x++;
+                    }
+                }
+            }
+        }
+    }
+    return opaque;
+}
+
 bool displayio_tilegrid_fill_area(displayio_tilegrid_t *self, const _displayio_colorspace_t* colorspace, const displayio_area_t* area, uint32_t* mask, uint32_t *buffer) {
     // If no tiles are present we have no impact.
     uint8_t* tiles = self->tiles;
@@ -337,11 +467,13 @@ bool displayio_tilegrid_fill_area(displayio_tilegrid_t *self, const _displayio_c
     // layers at that point.
     bool full_coverage = displayio_area_equal(area, &overlap);
 
-    // TODO(tannewt): Skip coverage tracking if all pixels outside the overlap have already been
-    // set and our palette is all opaque.
+    // Nothing has been drawn into the area yet when the mask is clear so there is no need to test
+    // each pixel against it.
+    bool check_mask = !_mask_is_clear(mask, displayio_area_size(area));
+    // An opaque layer that covers the whole area is the last one drawn into it so nothing will
+    // read the mask after us.
+    bool update_mask = !(full_coverage && displayio_tilegrid_is_opaque(self, colorspace));
 
-    // TODO(tannewt): Check to see if the pixel_shader has any transparency. If it doesn't then we
-    // can either return full coverage or bulk update the mask.
     displayio_area_t transformed;
     displayio_area_transform_within(flip_x != (self->absolute_transform->dx < 0), flip_y != (self->absolute_transform->dy < 0), self->transpose_xy != self->absolute_transform->transpose_xy,
                                     &overlap,
@@ -376,6 +508,24 @@ bool displayio_tilegrid_fill_area(displayio_tilegrid_t *self, const _displayio_c
         y_shift = temp_shift;
     }
 
+    // Resolve the bitmap and pixel shader types once rather than for every pixel.
+    bool bitmap_source = MP_OBJ_IS_TYPE(self->bitmap, &displayio_bitmap_type);
+    bool shape_source = MP_OBJ_IS_TYPE(self->bitmap, &displayio_shape_type);
+    bool ondiskbitmap_source = MP_OBJ_IS_TYPE(self->bitmap, &displayio_ondiskbitmap_type);
+    bool no_shader = self->pixel_shader == mp_const_none;
+    bool palette_shader = MP_OBJ_IS_TYPE(self->pixel_shader, &displayio_palette_type);
+    bool colorconverter_shader = MP_OBJ_IS_TYPE(self->pixel_shader, &displayio_colorconverter_type);
+
+    if (bitmap_source && (palette_shader || colorconverter_shader) &&
+        colorspace->depth == 16 && !colorspace->grayscale && !colorspace->tricolor) {
+        if (!_fill_area_rgb565(self, tiles, palette_shader, start_x, end_x, start_y, end_y,
+                               start, x_shift, y_shift, x_stride, y_stride,
+                               check_mask, update_mask, mask, (uint16_t*) buffer)) {
+            full_coverage = false;
+        }
+        return full_coverage;
+    }
+
     uint8_t pixels_per_byte = 8 / colorspace->depth;
     for (int16_t y = start_y; y < end_y; y++) {
         int16_t row_start = start + (y - start_y + y_shift) * y_stride; // in pixels
@@ -390,7 +540,7 @@ bool displayio_tilegrid_fill_area(displayio_tilegrid_t *self, const _displayio_c
             // }
 
             // Check the mask first to see if the pixel has already been set.
-            if ((mask[offset / 32] & (1 << (offset % 32))) != 0) {
+            if (check_mask && (mask[offset / 32] & (1 << (offset % 32))) != 0) {
                 continue;
             }
             int16_t local_x = x / self->absolute_transform->scale;
@@ -402,28 +552,30 @@ bool displayio_tilegrid_fill_area(displayio_tilegrid_t *self, const _displayio_c
             uint32_t value = 0;
             // We always want to read bitmap pixels by row first and then transpose into the destination
             // buffer because most bitmaps are row associated.
-            if (MP_OBJ_IS_TYPE(self->bitmap, &displayio_bitmap_type)) {
+            if (bitmap_source) {
                 value = common_hal_displayio_bitmap_get_pixel(self->bitmap, tile_x, tile_y);
-            } else if (MP_OBJ_IS_TYPE(self->bitmap, &displayio_shape_type)) {
+            } else if (shape_source) {
                 value = common_hal_displayio_shape_get_pixel(self->bitmap, tile_x, tile_y);
-            } else if (MP_OBJ_IS_TYPE(self->bitmap, &displayio_ondiskbitmap_type)) {
+            } else if (ondiskbitmap_source) {
                 value = common_hal_displayio_ondiskbitmap_get_pixel(self->bitmap, tile_x, tile_y);
             }
 
             uint32_t pixel;
             bool opaque = true;
-            if (self->pixel_shader == mp_const_none) {
+            if (no_shader) {
                 pixel = value;
-            } else if (MP_OBJ_IS_TYPE(self->pixel_shader, &displayio_palette_type)) {
+            } else if (palette_shader) {
                 opaque = displayio_palette_get_color(self->pixel_shader, colorspace, value, &pixel);
-            } else if (MP_OBJ_IS_TYPE(self->pixel_shader, &displayio_colorconverter_type)) {
+            } else if (colorconverter_shader) {
                 opaque = displayio_colorconverter_convert(self->pixel_shader, colorspace, value, &pixel);
             }
             if (!opaque) {
                 // A pixel is transparent so we haven't fully covered the area ourselves.
                 full_coverage = false;
             } else {
-                mask[offset / 32] |= 1 << (offset % 32);
+                if (update_mask) {
+                    mask[offset / 32] |= 1 << (offset % 32);
+                }
                 if (colorspace->depth == 16) {
                     *(((uint16_t*) buffer) + offset) = pixel;
                 } else if (colorspace->depth == 8) {
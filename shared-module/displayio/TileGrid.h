@@ -74,6 +74,8 @@ displayio_area_t* displayio_tilegrid_get_refresh_areas(displayio_tilegrid_t *sel
 // Area is always in absolute screen coordinates. Update transform is used to inform TileGrids how
 // they relate to it.
 bool displayio_tilegrid_fill_area(displayio_tilegrid_t *self, const _displayio_colorspace_t* colorspace, const displayio_area_t* area, uint32_t* mask, uint32_t *buffer);
+// Returns true if every pixel of the TileGrid will be drawn opaque in the given colorspace.
+bool displayio_tilegrid_is_opaque(displayio_tilegrid_t *self, const _displayio_colorspace_t* colorspace);
 void displayio_tilegrid_update_transform(displayio_tilegrid_t *group, const displayio_buffer_transform_t* parent_transform);
 
 // Fills in area with the maximum bounds of all related pixels in the last rendered frame. Returns
@@ -273,6 +273,14 @@ bool displayio_area_equal(const displayio_area_t* a, const displayio_area_t* b)
 }
 
 // Original and whole must be in the same coordinate space.
+// Returns true if inner is entirely within outer.
+bool displayio_area_contains(const displayio_area_t* outer, const displayio_area_t* inner) {
+    return outer->x1 <= inner->x1 &&
+           outer->y1 <= inner->y1 &&
+           inner->x2 <= outer->x2 &&
+           inner->y2 <= outer->y2;
+}
+
 void displayio_area_transform_within(bool mirror_x, bool mirror_y, bool transpose_xy,
                                      const displayio_area_t* original,
                                      const displayio_area_t* whole,
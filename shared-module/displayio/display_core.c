@@ -323,3 +323,44 @@ bool displayio_display_core_clip_area(displayio_display_core_t *self, const disp
     }
     return true;
 }
+
+const displayio_area_t* displayio_display_core_plan_refresh_areas(displayio_display_core_t* self, const displayio_area_t* areas) {
+    displayio_area_t* planned = self->planned_areas;
+    uint8_t count = 0;
+    const displayio_area_t* area = areas;
+    for (; area != NULL && count < DISPLAYIO_MAX_PLANNED_AREAS; area = area->next) {
+        displayio_area_t clipped;
+        if (!displayio_display_core_clip_area(self, area, &clipped)) {
+            continue;
+        }
+        // Merging can make the area cover others that weren't worth merging before so repeat until
+        // nothing changes.
+        uint8_t i = 0;
+        while (i < count) {
+            displayio_area_t u;
+            displayio_area_union(&planned[i], &clipped, &u);
+            // Overlapping pixels are drawn twice when the areas are kept apart.
+            int32_t growth = (int32_t) displayio_area_size(&u) - (int32_t) displayio_area_size(&planned[i]) -
+                (int32_t) displayio_area_size(&clipped);
+            if (growth > DISPLAYIO_AREA_OVERHEAD_PIXELS) {
+                i++;
+                continue;
+            }
+            displayio_area_copy(&u, &clipped);
+            count--;
+            displayio_area_copy(&planned[count], &planned[i]);
+            i = 0;
+        }
+        displayio_area_copy(&clipped, &planned[count]);
+        count++;
+    }
+    if (count == 0) {
+        return area;
+    }
+    for (uint8_t i = 0; i < count - 1; i++) {
+        planned[i].next = &planned[i + 1];
+    }
+    // Areas left over once planned_areas is full are refreshed as they are.
+    planned[count - 1].next = area;
+    return planned;
+}
@@ -34,6 +34,12 @@
 
 #define NO_COMMAND 0x100
 
+// Most separate areas planned for a single refresh. Any further areas are refreshed as they are.
+#define DISPLAYIO_MAX_PLANNED_AREAS (16)
+// Estimated cost, in pixels, of refreshing an area on its own: its region commands and the
+// transaction around them. Areas are merged when the extra pixels drawn cost less than this.
+#define DISPLAYIO_AREA_OVERHEAD_PIXELS (64)
+
 typedef struct {
     mp_obj_t bus;
     displayio_group_t *current_group;
@@ -45,6 +51,7 @@ typedef struct {
     display_bus_end_transaction end_transaction;
     displayio_buffer_transform_t transform;
     displayio_area_t area;
+    displayio_area_t planned_areas[DISPLAYIO_MAX_PLANNED_AREAS];
     uint16_t width;
     uint16_t height;
     uint16_t rotation;
@@ -80,6 +87,10 @@ void displayio_display_core_collect_ptrs(displayio_display_core_t* self);
 
 bool displayio_display_core_fill_area(displayio_display_core_t *self, displayio_area_t* area, uint32_t* mask, uint32_t *buffer);
 
+// Clips and merges the given areas so that each pixel is drawn at most once and nearby areas share
+// their overhead. The returned list is stored in the core and valid until the next call.
+const displayio_area_t* displayio_display_core_plan_refresh_areas(displayio_display_core_t* self, const displayio_area_t* areas);
+
 bool displayio_display_core_clip_area(displayio_display_core_t *self, const displayio_area_t* area, displayio_area_t* clipped);
 
 #endif // MICROPY_INCLUDED_SHARED_MODULE_DISPLAYIO_DISPLAY_CORE_H
@@ -32,6 +32,7 @@
 #include "shared-bindings/displayio/Group.h"
 #include "shared-bindings/displayio/Palette.h"
 #include "shared-bindings/displayio/TileGrid.h"
+#include "shared-module/displayio/__init__.h"
 #include "supervisor/memory.h"
 
 extern size_t blinka_bitmap_data[];
@@ -97,20 +98,26 @@ void supervisor_stop_terminal(void) {
 void supervisor_display_move_memory(void) {
     #if CIRCUITPY_DISPLAYIO
     displayio_tilegrid_t* grid = &supervisor_terminal_text_grid;
-    if (MP_STATE_VM(terminal_tilegrid_tiles) == NULL || grid->tiles != MP_STATE_VM(terminal_tilegrid_tiles)) {
-        return;
+    if (MP_STATE_VM(terminal_tilegrid_tiles) != NULL && grid->tiles == MP_STATE_VM(terminal_tilegrid_tiles)) {
+        uint16_t total_tiles = grid->width_in_tiles * grid->height_in_tiles;
+
+        tilegrid_tiles = allocate_memory(align32_size(total_tiles), false);
+        if (tilegrid_tiles != NULL) {
+            memcpy(tilegrid_tiles->ptr, grid->tiles, total_tiles);
+            grid->tiles = (uint8_t*) tilegrid_tiles->ptr;
+        } else {
+            grid->tiles = NULL;
+            grid->inline_tiles = false;
+        }
+        MP_STATE_VM(terminal_tilegrid_tiles) = NULL;
     }
-    uint16_t total_tiles = grid->width_in_tiles * grid->height_in_tiles;
 
-    tilegrid_tiles = allocate_memory(align32_size(total_tiles), false);
-    if (tilegrid_tiles != NULL) {
-        memcpy(tilegrid_tiles->ptr, grid->tiles, total_tiles);
-        grid->tiles = (uint8_t*) tilegrid_tiles->ptr;
-    } else {
-        grid->tiles = NULL;
-        grid->inline_tiles = false;
+    // Displays created by the VM had their refresh buffers on the heap.
+    for (uint8_t i = 0; i < CIRCUITPY_DISPLAY_LIMIT; i++) {
+        if (displays[i].display.base.type == &displayio_display_type) {
+            displayio_display_allocate_refresh_buffer(&displays[i].display);
+        }
     }
-    MP_STATE_VM(terminal_tilegrid_tiles) = NULL;
     #endif
 }
 
@@ -201,6 +208,7 @@ displayio_palette_t blinka_palette = {
     .base = {.type = &displayio_palette_type },
     .colors = blinka_colors,
     .color_count = 7,
+    .transparent_count = 1,
     .needs_refresh = false
 };
 
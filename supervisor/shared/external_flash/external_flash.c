@@ -42,16 +42,25 @@
 
 #define NO_SECTOR_LOADED 0xFFFFFFFF
 
-// The currently cached sector in the cache, ram or flash based.
-static uint32_t current_sector;
+// The currently cached sectors in the cache, ram or flash based. The flash based cache only holds
+// one sector.
+static uint32_t cached_sectors[EXTERNAL_FLASH_CACHE_SECTORS];
+
+// How many sectors the current cache can hold.
+static uint8_t cache_sector_count;
 
 const external_flash_device possible_devices[EXTERNAL_FLASH_DEVICE_COUNT] = {EXTERNAL_FLASH_DEVICES};
 
 static const external_flash_device* flash_device = NULL;
 
-// Track which blocks (up to 32) in the current sector currently live in the
+// Track which blocks (up to 32) in each cached sector currently live in the
 // cache.
-static uint32_t dirty_mask;
+static uint32_t dirty_masks[EXTERNAL_FLASH_CACHE_SECTORS];
+
+// When each cached sector was last written to so the least recently used one is written back
+// first.
+static uint32_t last_writes[EXTERNAL_FLASH_CACHE_SECTORS];
+static uint32_t write_count;
 
 static supervisor_allocation* supervisor_cache = NULL;
 
@@ -89,22 +98,22 @@ static bool write_flash(uint32_t address, const uint8_t* data, uint32_t data_len
     if (flash_device == NULL) {
         return false;
     }
-    // Don't bother writing if the data is all 1s. Thats equivalent to the flash
-    // state after an erase.
-    bool all_ones = true;
-    for (uint16_t i = 0; i < data_length; i++) {
-        if (data[i] != 0xff) {
-            all_ones = false;
-            break;
-        }
-    }
-    if (all_ones) {
-        return true;
-    }
-
     for (uint32_t bytes_written = 0;
         bytes_written < data_length;
         bytes_written += SPI_FLASH_PAGE_SIZE) {
+        // Don't bother writing pages that are all 1s. Thats equivalent to the flash
+        // state after an erase.
+        bool all_ones = true;
+        for (uint16_t i = 0; i < SPI_FLASH_PAGE_SIZE; i++) {
+            if (data[bytes_written + i] != 0xff) {
+                all_ones = false;
+                break;
+            }
+        }
+        if (all_ones) {
+            continue;
+        }
+
         if (!wait_for_flash_ready() || !write_enable()) {
             return false;
         }
@@ -135,7 +144,7 @@ static bool page_erased(uint32_t sector_address) {
     uint8_t full_buffer[FILESYSTEM_BLOCK_SIZE];
     if (read_flash(sector_address, full_buffer, FILESYSTEM_BLOCK_SIZE)) {
         for (uint16_t i = 0; i < FILESYSTEM_BLOCK_SIZE; i++) {
-            if (short_buffer[i] != 0xff) {
+            if (full_buffer[i] != 0xff) {
                 return false;
             }
         }
@@ -252,8 +261,11 @@ void supervisor_flash_init(void) {
 
     wait_for_flash_ready();
 
-    current_sector = NO_SECTOR_LOADED;
-    dirty_mask = 0;
+    for (uint8_t i = 0; i < EXTERNAL_FLASH_CACHE_SECTORS; i++) {
+        cached_sectors[i] = NO_SECTOR_LOADED;
+        dirty_masks[i] = 0;
+    }
+    cache_sector_count = 0;
     MP_STATE_VM(flash_ram_cache) = NULL;
 }
 
@@ -272,15 +284,17 @@ uint32_t supervisor_flash_get_block_count(void) {
 // Flush the cache that was written to the scratch portion of flash. Only used
 // when ram is tight.
 static bool flush_scratch_flash(void) {
+    uint32_t current_sector = cached_sectors[0];
     if (current_sector == NO_SECTOR_LOADED) {
         return true;
     }
+    cached_sectors[0] = NO_SECTOR_LOADED;
     // First, copy out any blocks that we haven't touched from the sector we've
     // cached.
     bool copy_to_scratch_ok = true;
     uint32_t scratch_sector = flash_device->total_size - SPI_FLASH_ERASE_SIZE;
     for (uint8_t i = 0; i < SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE; i++) {
-        if ((dirty_mask & (1 << i)) == 0) {
+        if ((dirty_masks[0] & (1 << i)) == 0) {
             copy_to_scratch_ok = copy_to_scratch_ok &&
                 copy_block(current_sector + i * FILESYSTEM_BLOCK_SIZE,
                            scratch_sector + i * FILESYSTEM_BLOCK_SIZE);
@@ -301,149 +315,154 @@ static bool flush_scratch_flash(void) {
     return true;
 }
 
-// Attempts to allocate a new set of page buffers for caching a full sector in
-// ram. Each page is allocated separately so that the GC doesn't need to provide
-// one huge block. We can free it as we write if we want to also.
-static bool allocate_ram_cache(void) {
-    uint8_t blocks_per_sector = SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE;
-    uint8_t pages_per_block = FILESYSTEM_BLOCK_SIZE / SPI_FLASH_PAGE_SIZE;
+// Attempts to allocate a new set of page buffers for caching the given number
+// of sectors in ram. Each page is allocated separately so that the GC doesn't
+// need to provide one huge block.
+static bool allocate_ram_cache_sectors(uint8_t sector_count) {
+    uint16_t page_count = sector_count * (SPI_FLASH_ERASE_SIZE / SPI_FLASH_PAGE_SIZE);
 
-    uint32_t table_size = blocks_per_sector * pages_per_block * sizeof(uint32_t);
+    uint32_t table_size = page_count * sizeof(uint8_t*);
     // Attempt to allocate outside the heap first.
-    supervisor_cache = allocate_memory(table_size + SPI_FLASH_ERASE_SIZE, false);
+    supervisor_cache = allocate_memory(table_size + sector_count * SPI_FLASH_ERASE_SIZE, false);
     if (supervisor_cache != NULL) {
         MP_STATE_VM(flash_ram_cache) = (uint8_t **) supervisor_cache->ptr;
         uint8_t* page_start = (uint8_t *) supervisor_cache->ptr + table_size;
 
-        for (uint8_t i = 0; i < blocks_per_sector; i++) {
-            for (uint8_t j = 0; j < pages_per_block; j++) {
-                uint32_t offset = i * pages_per_block + j;
-                MP_STATE_VM(flash_ram_cache)[offset] = page_start + offset * SPI_FLASH_PAGE_SIZE;
-            }
+        for (uint16_t i = 0; i < page_count; i++) {
+            MP_STATE_VM(flash_ram_cache)[i] = page_start + i * SPI_FLASH_PAGE_SIZE;
         }
         return true;
     }
 
-    MP_STATE_VM(flash_ram_cache) = m_malloc_maybe(blocks_per_sector * pages_per_block * sizeof(uint32_t), false);
+    MP_STATE_VM(flash_ram_cache) = m_malloc_maybe(table_size, false);
     if (MP_STATE_VM(flash_ram_cache) == NULL) {
         return false;
     }
-    // Declare i and j outside the loops in case we fail to allocate everything
-    // we need. In that case we'll give it back.
-    uint8_t i = 0;
-    uint8_t j = 0;
-    bool success = true;
-    for (i = 0; i < blocks_per_sector; i++) {
-        for (j = 0; j < pages_per_block; j++) {
-            uint8_t *page_cache = m_malloc_maybe(SPI_FLASH_PAGE_SIZE, false);
-            if (page_cache == NULL) {
-                success = false;
-                break;
+    for (uint16_t i = 0; i < page_count; i++) {
+        uint8_t *page_cache = m_malloc_maybe(SPI_FLASH_PAGE_SIZE, false);
+        if (page_cache == NULL) {
+            // We couldn't allocate enough so give back what we got.
+            while (i > 0) {
+                i--;
+                m_free(MP_STATE_VM(flash_ram_cache)[i]);
             }
-            MP_STATE_VM(flash_ram_cache)[i * pages_per_block + j] = page_cache;
-        }
-        if (!success) {
-            break;
+            m_free(MP_STATE_VM(flash_ram_cache));
+            MP_STATE_VM(flash_ram_cache) = NULL;
+            return false;
         }
+        MP_STATE_VM(flash_ram_cache)[i] = page_cache;
     }
-    // We couldn't allocate enough so give back what we got.
-    if (!success) {
-        // We add 1 so that we delete 0 when i is 1. Going to zero (i >= 0)
-        // would never stop because i is unsigned.
-        i++;
-        for (; i > 0; i--) {
-            for (; j > 0; j--) {
-                m_free(MP_STATE_VM(flash_ram_cache)[(i - 1) * pages_per_block + (j - 1)]);
-            }
-            j = pages_per_block;
+    return true;
+}
+
+// Allocates a ram cache for as many sectors as will fit, up to
+// EXTERNAL_FLASH_CACHE_SECTORS.
+static bool allocate_ram_cache(void) {
+    for (uint8_t sector_count = EXTERNAL_FLASH_CACHE_SECTORS; sector_count > 0; sector_count--) {
+        if (allocate_ram_cache_sectors(sector_count)) {
+            cache_sector_count = sector_count;
+            return true;
         }
-        m_free(MP_STATE_VM(flash_ram_cache));
-        MP_STATE_VM(flash_ram_cache) = NULL;
     }
-    return success;
+    return false;
 }
 
 static void release_ram_cache(void) {
     if (supervisor_cache != NULL) {
         free_memory(supervisor_cache);
         supervisor_cache = NULL;
-    } else {
+    } else if (MP_STATE_VM(flash_ram_cache) != NULL) {
+        uint16_t page_count = cache_sector_count * (SPI_FLASH_ERASE_SIZE / SPI_FLASH_PAGE_SIZE);
+        for (uint16_t i = 0; i < page_count; i++) {
+            m_free(MP_STATE_VM(flash_ram_cache)[i]);
+        }
         m_free(MP_STATE_VM(flash_ram_cache));
     }
+    // Anything a failed write back left behind is gone with the cache.
+    for (uint8_t slot = 0; slot < cache_sector_count; slot++) {
+        cached_sectors[slot] = NO_SECTOR_LOADED;
+        dirty_masks[slot] = 0;
+    }
     MP_STATE_VM(flash_ram_cache) = NULL;
+    cache_sector_count = 0;
 }
 
-// Flush the cached sector from ram onto the flash. We'll free the cache unless
-// keep_cache is true.
-static bool flush_ram_cache(bool keep_cache) {
-    if (current_sector == NO_SECTOR_LOADED) {
-        if (!keep_cache) {
-            release_ram_cache();
-        }
+// Writes the sector cached in the given ram cache slot back onto the flash. The slot is only
+// freed once that succeeds so a failed write back doesn't lose the cached data.
+static bool write_back_ram_sector(uint8_t slot) {
+    uint32_t sector = cached_sectors[slot];
+    if (sector == NO_SECTOR_LOADED) {
         return true;
     }
+    uint8_t** pages = MP_STATE_VM(flash_ram_cache) + slot * (SPI_FLASH_ERASE_SIZE / SPI_FLASH_PAGE_SIZE);
     // First, copy out any blocks that we haven't touched from the sector
     // we've cached. If we don't do this we'll erase the data during the sector
     // erase below.
-    bool copy_to_ram_ok = true;
     uint8_t pages_per_block = FILESYSTEM_BLOCK_SIZE / SPI_FLASH_PAGE_SIZE;
     for (uint8_t i = 0; i < SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE; i++) {
-        if ((dirty_mask & (1 << i)) == 0) {
+        if ((dirty_masks[slot] & (1 << i)) == 0) {
             for (uint8_t j = 0; j < pages_per_block; j++) {
-                copy_to_ram_ok = read_flash(
-                    current_sector + (i * pages_per_block + j) * SPI_FLASH_PAGE_SIZE,
-                    MP_STATE_VM(flash_ram_cache)[i * pages_per_block + j],
-                    SPI_FLASH_PAGE_SIZE);
-                if (!copy_to_ram_ok) {
-                    break;
+                if (!read_flash(sector + (i * pages_per_block + j) * SPI_FLASH_PAGE_SIZE,
+                                pages[i * pages_per_block + j],
+                                SPI_FLASH_PAGE_SIZE)) {
+                    return false;
                 }
             }
         }
-        if (!copy_to_ram_ok) {
-            break;
-        }
     }
 
-    if (!copy_to_ram_ok) {
-        return false;
-    }
-    // Second, erase the current sector.
-    erase_sector(current_sector);
+    // Second, erase the sector.
+    erase_sector(sector);
     // Lastly, write all the data in ram that we've cached.
-    for (uint8_t i = 0; i < SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE; i++) {
-        for (uint8_t j = 0; j < pages_per_block; j++) {
-            write_flash(current_sector + (i * pages_per_block + j) * SPI_FLASH_PAGE_SIZE,
-                        MP_STATE_VM(flash_ram_cache)[i * pages_per_block + j],
-                        SPI_FLASH_PAGE_SIZE);
-            if (!keep_cache && supervisor_cache == NULL) {
-                m_free(MP_STATE_VM(flash_ram_cache)[i * pages_per_block + j]);
-            }
-        }
+    bool write_ok = true;
+    for (uint8_t i = 0; i < SPI_FLASH_ERASE_SIZE / SPI_FLASH_PAGE_SIZE; i++) {
+        write_ok = write_flash(sector + i * SPI_FLASH_PAGE_SIZE, pages[i], SPI_FLASH_PAGE_SIZE) &&
+                   write_ok;
+    }
+    if (write_ok) {
+        cached_sectors[slot] = NO_SECTOR_LOADED;
+    }
+    return write_ok;
+}
+
+// Flush the cached sectors from ram onto the flash. We'll free the cache unless
+// keep_cache is true.
+static bool flush_ram_cache(bool keep_cache) {
+    bool ok = true;
+    for (uint8_t slot = 0; slot < cache_sector_count; slot++) {
+        ok = write_back_ram_sector(slot) && ok;
     }
     // We're done with the cache for now so give it back.
     if (!keep_cache) {
         release_ram_cache();
     }
-    return true;
+    return ok;
 }
 
-// Delegates to the correct flash flush method depending on the existing cache.
-static void spi_flash_flush_keep_cache(bool keep_cache) {
+static void begin_flash_write(void) {
     #ifdef MICROPY_HW_LED_MSC
         port_pin_set_output_level(MICROPY_HW_LED_MSC, true);
     #endif
     temp_status_color(ACTIVE_WRITE);
+}
+
+static void end_flash_write(void) {
+    clear_temp_status();
+    #ifdef MICROPY_HW_LED_MSC
+        port_pin_set_output_level(MICROPY_HW_LED_MSC, false);
+    #endif
+}
+
+// Delegates to the correct flash flush method depending on the existing cache.
+static void spi_flash_flush_keep_cache(bool keep_cache) {
+    begin_flash_write();
     // If we've cached to the flash itself flush from there.
     if (MP_STATE_VM(flash_ram_cache) == NULL) {
         flush_scratch_flash();
     } else {
         flush_ram_cache(keep_cache);
     }
-    current_sector = NO_SECTOR_LOADED;
-    clear_temp_status();
-    #ifdef MICROPY_HW_LED_MSC
-        port_pin_set_output_level(MICROPY_HW_LED_MSC, false);
-    #endif
+    end_flash_write();
 }
 
 void supervisor_flash_flush(void) {
@@ -463,6 +482,49 @@ static int32_t convert_block_to_flash_addr(uint32_t block) {
     return -1;
 }
 
+// Returns the cache slot holding the given sector or -1 if it isn't cached.
+static int8_t find_cached_sector(uint32_t sector) {
+    for (uint8_t slot = 0; slot < cache_sector_count; slot++) {
+        if (cached_sectors[slot] == sector) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+// Makes room in the cache for another sector and returns its slot. Once the
+// cache is full, the least recently written sector is written back to flash.
+// Returns -1 if that fails.
+static int8_t claim_cache_slot(void) {
+    if (MP_STATE_VM(flash_ram_cache) == NULL) {
+        if (cached_sectors[0] != NO_SECTOR_LOADED) {
+            supervisor_flash_flush();
+        }
+        if (!allocate_ram_cache()) {
+            cache_sector_count = 1;
+            erase_sector(flash_device->total_size - SPI_FLASH_ERASE_SIZE);
+            wait_for_flash_ready();
+            return 0;
+        }
+    }
+    uint8_t oldest = 0;
+    for (uint8_t slot = 0; slot < cache_sector_count; slot++) {
+        if (cached_sectors[slot] == NO_SECTOR_LOADED) {
+            return slot;
+        }
+        if (last_writes[slot] < last_writes[oldest]) {
+            oldest = slot;
+        }
+    }
+    begin_flash_write();
+    bool ok = write_back_ram_sector(oldest);
+    end_flash_write();
+    if (!ok) {
+        return -1;
+    }
+    return oldest;
+}
+
 bool external_flash_read_block(uint8_t *dest, uint32_t block) {
     int32_t address = convert_block_to_flash_addr(block);
     if (address == -1) {
@@ -474,13 +536,15 @@ bool external_flash_read_block(uint8_t *dest, uint32_t block) {
     uint32_t this_sector = address & (~(SPI_FLASH_ERASE_SIZE - 1));
     uint8_t block_index = (address / FILESYSTEM_BLOCK_SIZE) % (SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE);
     uint8_t mask = 1 << (block_index);
-    // We're reading from the currently cached sector.
-    if (current_sector == this_sector && (mask & dirty_mask) > 0) {
+    int8_t slot = find_cached_sector(this_sector);
+    // We're reading from a cached sector.
+    if (slot >= 0 && (mask & dirty_masks[slot]) > 0) {
         if (MP_STATE_VM(flash_ram_cache) != NULL) {
             uint8_t pages_per_block = FILESYSTEM_BLOCK_SIZE / SPI_FLASH_PAGE_SIZE;
+            uint8_t** pages = MP_STATE_VM(flash_ram_cache) + slot * (SPI_FLASH_ERASE_SIZE / SPI_FLASH_PAGE_SIZE);
             for (int i = 0; i < pages_per_block; i++) {
                 memcpy(dest + i * SPI_FLASH_PAGE_SIZE,
-                       MP_STATE_VM(flash_ram_cache)[block_index * pages_per_block + i],
+                       pages[block_index * pages_per_block + i],
                        SPI_FLASH_PAGE_SIZE);
             }
             return true;
@@ -505,30 +569,34 @@ bool external_flash_write_block(const uint8_t *data, uint32_t block) {
     uint32_t this_sector = address & (~(SPI_FLASH_ERASE_SIZE - 1));
     uint8_t block_index = (address / FILESYSTEM_BLOCK_SIZE) % (SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE);
     uint8_t mask = 1 << (block_index);
-    // Flush the cache if we're moving onto a sector or we're writing the
-    // same block again.
-    if (current_sector != this_sector || (mask & dirty_mask) > 0) {
+    int8_t slot = find_cached_sector(this_sector);
+    // Blocks cached in ram are simply replaced when they are written again but
+    // the scratch sector would need another erase so flush it instead.
+    if (slot >= 0 && MP_STATE_VM(flash_ram_cache) == NULL && (mask & dirty_masks[slot]) > 0) {
+        supervisor_flash_flush();
+        slot = -1;
+    }
+    if (slot < 0) {
         // Check to see if we'd write to an erased page. In that case we
         // can write directly.
         if (page_erased(address)) {
             return write_flash(address, data, FILESYSTEM_BLOCK_SIZE);
         }
-        if (current_sector != NO_SECTOR_LOADED) {
-            supervisor_flash_flush();
-        }
-        if (MP_STATE_VM(flash_ram_cache) == NULL && !allocate_ram_cache()) {
-            erase_sector(flash_device->total_size - SPI_FLASH_ERASE_SIZE);
-            wait_for_flash_ready();
+        slot = claim_cache_slot();
+        if (slot < 0) {
+            return false;
         }
-        current_sector = this_sector;
-        dirty_mask = 0;
+        cached_sectors[slot] = this_sector;
+        dirty_masks[slot] = 0;
     }
-    dirty_mask |= mask;
+    dirty_masks[slot] |= mask;
+    last_writes[slot] = ++write_count;
     // Copy the block to the appropriate cache.
     if (MP_STATE_VM(flash_ram_cache) != NULL) {
         uint8_t pages_per_block = FILESYSTEM_BLOCK_SIZE / SPI_FLASH_PAGE_SIZE;
+        uint8_t** pages = MP_STATE_VM(flash_ram_cache) + slot * (SPI_FLASH_ERASE_SIZE / SPI_FLASH_PAGE_SIZE);
         for (int i = 0; i < pages_per_block; i++) {
-            memcpy(MP_STATE_VM(flash_ram_cache)[block_index * pages_per_block + i],
+            memcpy(pages[block_index * pages_per_block + i],
                    data + i * SPI_FLASH_PAGE_SIZE,
                    SPI_FLASH_PAGE_SIZE);
         }
@@ -539,6 +607,28 @@ bool external_flash_write_block(const uint8_t *data, uint32_t block) {
     }
 }
 
+// Writes a whole erase sector starting at the given block. Nothing in the
+// sector needs to be kept so it is erased and programmed directly.
+static bool external_flash_write_sector(const uint8_t *data, uint32_t block) {
+    int32_t address = convert_block_to_flash_addr(block);
+    uint8_t blocks_per_sector = SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE;
+    if (address == -1 || convert_block_to_flash_addr(block + blocks_per_sector - 1) == -1) {
+        // bad block number
+        return false;
+    }
+    // Any cached copy of the sector is stale now.
+    int8_t slot = find_cached_sector(address);
+    if (slot >= 0) {
+        cached_sectors[slot] = NO_SECTOR_LOADED;
+        dirty_masks[slot] = 0;
+    }
+    begin_flash_write();
+    erase_sector(address);
+    bool ok = write_flash(address, data, SPI_FLASH_ERASE_SIZE);
+    end_flash_write();
+    return ok;
+}
+
 mp_uint_t supervisor_flash_read_blocks(uint8_t *dest, uint32_t block_num, uint32_t num_blocks) {
     for (size_t i = 0; i < num_blocks; i++) {
         if (!external_flash_read_block(dest + i * FILESYSTEM_BLOCK_SIZE, block_num + i)) {
@@ -549,9 +639,20 @@ mp_uint_t supervisor_flash_read_blocks(uint8_t *dest, uint32_t block_num, uint32
 }
 
 mp_uint_t supervisor_flash_write_blocks(const uint8_t *src, uint32_t block_num, uint32_t num_blocks) {
-    for (size_t i = 0; i < num_blocks; i++) {
-        if (!external_flash_write_block(src + i * FILESYSTEM_BLOCK_SIZE, block_num + i)) {
-            return 1; // error
+    uint8_t blocks_per_sector = SPI_FLASH_ERASE_SIZE / FILESYSTEM_BLOCK_SIZE;
+    size_t i = 0;
+    while (i < num_blocks) {
+        // Whole sectors skip the cache and its read-modify-write.
+        if ((block_num + i) % blocks_per_sector == 0 && num_blocks - i >= blocks_per_sector) {
+            if (!external_flash_write_sector(src + i * FILESYSTEM_BLOCK_SIZE, block_num + i)) {
+                return 1; // error
+            }
+            i += blocks_per_sector;
+        } else {
+            if (!external_flash_write_block(src + i * FILESYSTEM_BLOCK_SIZE, block_num + i)) {
+                return 1; // error
+            }
+            i++;
         }
     }
     return 0; // success
@@ -45,4 +45,11 @@
 #define SPI_FLASH_MAX_BAUDRATE 8000000
 #endif
 
+// Number of erase sectors the ram write cache can hold before writing one back. Fewer are used if
+// there isn't enough memory for all of them. Each one takes SPI_FLASH_ERASE_SIZE of the heap so
+// boards with RAM to spare may set this higher.
+#ifndef EXTERNAL_FLASH_CACHE_SECTORS
+#define EXTERNAL_FLASH_CACHE_SECTORS (1)
+#endif
+
 #endif  // MICROPY_INCLUDED_SUPERVISOR_SHARED_EXTERNAL_FLASH_EXTERNAL_FLASH_H
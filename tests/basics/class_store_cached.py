@@ -0,0 +1,56 @@
+# test that changing a class is seen by lookups that have already been done
+
+class A:
+    x = 1
+    def f(self):
+        return 'A.f'
+
+class B(A):
+    pass
+
+b = B()
+for i in range(2):
+    print(b.x, b.f(), B.x)
+
+# store to the class that defines the attribute
+A.x = 2
+A.f = lambda self: 'A.f2'
+print(b.x, b.f(), B.x)
+
+# shadow it in the subclass
+B.x = 3
+B.f = lambda self: 'B.f'
+print(b.x, b.f(), B.x)
+
+# and remove it again
+del B.x
+del B.f
+print(b.x, b.f(), B.x)
+
+# an attribute that wasn't found before
+for i in range(2):
+    print(hasattr(b, 'y'))
+A.y = 4
+print(hasattr(b, 'y'), b.y)
+
+# instance members still take precedence
+b.f = lambda: 'b.f'
+print(b.f())
+
+# special methods
+class C:
+    pass
+c = C()
+for i in range(2):
+    try:
+        len(c)
+    except TypeError:
+        print('TypeError')
+C.__len__ = lambda self: 5
+print(len(c))
+
+# a miss found without an instance doesn't hide a native base's attribute
+class E(Exception):
+    pass
+hasattr(E, 'args')
+print(E(1, 2).args)
@@ -0,0 +1,80 @@
+# test that opcodes specialised on the types they first see still behave
+# correctly when later given other types
+
+def arith(a, b):
+    x = a + b
+    x -= b
+    x += a
+    return x - b
+
+def compare(a, b):
+    return a + b, a < b, a > b, a == b, a <= b, a >= b, a != b
+
+# small ints first, then types that must go through the generic path
+for a, b in ((1, 2), (3, 3), (-5, 4), (1.5, 2), (2, 0.5), (True, 2), (7, 8),
+             (2**29, 2**29), (-2**29, 2**29), (2**62, 2**62), (9, -9)):
+    print(arith(a, b), compare(a, b))
+for a, b in ((1, 2), ("a", "b"), ([1], [2]), ((1,), (2,)), (3, 3)):
+    print(compare(a, b))
+
+# in-place ops on mutable types must not be turned into a plain add
+def inplace(x, y):
+    x += y
+    return x
+
+for i in range(3):
+    print(inplace(i, 1))
+l = [1]
+print(inplace(l, [2]), l)
+print(inplace(3, 4))
+
+# overflow of small int add/sub
+def add(a, b):
+    return a + b
+def sub(a, b):
+    return a - b
+big = 1
+while add(big, big) > 0 and big < 2**70:
+    big = add(big, big)
+print(big, sub(-big, big), add(big, 1) - big)
+
+def load(seq, i):
+    return seq[i]
+
+def store(seq, i, v):
+    seq[i] = v
+
+class L(list):
+    def __getitem__(self, i):
+        return ("L", i)
+    def __setitem__(self, i, v):
+        print("set", i, v)
+
+lst = [10, 20, 30]
+for seq, i in ((lst, 0), (lst, 2), (lst, -1), (lst, -3), ((1, 2, 3), 1), ("abc", 2),
+               ({1: "one"}, 1), (L([1, 2]), 0), (lst, 1), (lst, 3), (lst, -4),
+               (lst, 1.0), (lst, slice(1, 2)), (lst, True)):
+    try:
+        print(load(seq, i))
+    except (IndexError, TypeError) as e:
+        print(type(e).__name__)
+
+for seq, i in ((lst, 0), (lst, -1), ({}, 1), (L(), 5), (lst, 1), (lst, 3), (lst, -4),
+               (bytearray(2), 1), (lst, "x")):
+    try:
+        store(seq, i, 99)
+        print(seq)
+    except (IndexError, TypeError) as e:
+        print(type(e).__name__)
+
+# a comparison used in a loop whose operand changes type part way
+def count(limit):
+    n = 0
+    i = 0
+    while i < limit:
+        i += 1
+        n += 1
+        if n == 5:
+            i = float(i)
+    return n, i
+print(count(10))
@@ -0,0 +1,83 @@
+# test that fused instruction sequences behave like the individual opcodes
+
+# augmented subscript assignment on various container types
+class L(list):
+    pass
+
+class C:
+    def __init__(self):
+        self.d = {}
+    def __getitem__(self, i):
+        return self.d.get(i, 10)
+    def __setitem__(self, i, v):
+        self.d[i] = v
+
+def aug_subscr(o, i):
+    o[i] += 1
+    o[i] -= 2
+    return o
+
+print(aug_subscr([1, 2, 3], 0))
+print(aug_subscr([1, 2, 3], -1))
+print(aug_subscr({"a": 5}, "a"))
+print(aug_subscr(bytearray(b"ab"), 1))
+print(aug_subscr(L([1, 2]), 1))
+print(aug_subscr(C(), 3).d)
+try:
+    aug_subscr([1], 2)
+except IndexError:
+    print("IndexError")
+try:
+    aug_subscr((1, 2), 0)
+except TypeError:
+    print("TypeError")
+
+# delete goes through the same rotated store path
+def delete(o, i):
+    del o[i]
+    return o
+
+print(delete([1, 2, 3], 1), delete({1: 2, 3: 4}, 3))
+
+# binary ops with a small int operand, including ones that overflow
+def small_int_ops(x):
+    return x + 1, x - 1, x * 3, x // 2, x % 7, x << 2, x >> 1, x & 5, x | 8, x ^ 3
+
+def small_int_arith(x):
+    return x + 1, x - 1, x * 3, x < 2, x >= 2
+
+for x in (0, 5, -5, 2**30 - 1, -2**30, 2**62, True):
+    print(small_int_ops(x))
+print(small_int_arith(1.5), small_int_arith(2))
+
+# comparisons fused with a conditional jump
+def cmp_jump(a, b):
+    r = []
+    if a < b:
+        r.append("lt")
+    if a == b:
+        r.append("eq")
+    if not a >= 3:
+        r.append("lt3")
+    while a > 0:
+        a -= 1
+    if a != 0:
+        r.append("ne")
+    return r
+
+for a, b in ((1, 2), (2, 2), (5, 1), (1.5, 2), (-1, -1)):
+    print(cmp_jump(a, b))
+
+try:
+    cmp_jump([], 1)
+except TypeError:
+    print("TypeError")
+
+# pairs of local loads
+def load_pair(a, b):
+    print(a, b, a + b)
+    if a:
+        c = 1
+    return c, b
+
+print(load_pair(1, 2))
@@ -0,0 +1,12 @@
+# test that a fused pair of local loads checks for unbound locals
+
+def load_pair(a, b):
+    if a:
+        c = 1
+    return c, b
+
+print(load_pair(1, 2))
+try:
+    load_pair(0, 2)
+except NameError:
+    print("NameError")
@@ -0,0 +1,45 @@
+# test OrderedDict big enough to be looked up through a hash index
+
+try:
+    from collections import OrderedDict
+except ImportError:
+    try:
+        from ucollections import OrderedDict
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+d = OrderedDict()
+for i in range(100):
+    d["k%d" % i] = i
+print(len(d), list(d)[:3], list(d)[-3:])
+print(all([d["k%d" % i] == i for i in range(100)]))
+print("k100" in d, "k99" in d)
+
+# deleting keeps the order of the others
+for i in range(0, 100, 3):
+    del d["k%d" % i]
+print(len(d), list(d)[:3], list(d)[-3:])
+print(all([("k%d" % i in d) == (i % 3 != 0) for i in range(100)]))
+
+# re-adding goes to the end
+d["k0"] = "again"
+print(list(d.items())[-2:])
+
+# int keys, and keys mixed with ones that can't use the index
+d = OrderedDict([(i, i * i) for i in range(50)])
+print(d[7], d[49], 50 in d)
+d[(1, 2)] = "tuple"
+d[2.5] = "float"
+for i in range(50, 80):
+    d[i] = i * i
+print(len(d), d[(1, 2)], d[2.5], d[79], list(d)[48:53])
+
+# copies and popitem
+d = OrderedDict([("a%d" % i, i) for i in range(40)])
+c = d.copy()
+for i in range(40, 60):
+    c["a%d" % i] = i
+print(len(d), len(c), c["a59"], "a59" in d)
+k, v = c.popitem()
+print(c.get(k), len(c), all([c[k] == int(k[1:]) for k in c]))
@@ -0,0 +1,24 @@
+import bench
+
+# Integer moving-average filter over a ring buffer of sensor samples, the kind
+# of loop that is bound by small-int arithmetic and list subscripts.
+
+def test(num):
+    n = 8
+    buf = [0] * n
+    total = 0
+    pos = 0
+    out = 0
+    sample = 0
+    for i in range(num // 4):
+        sample = (sample + 37) & 1023
+        total -= buf[pos]
+        buf[pos] = sample
+        total += sample
+        pos += 1
+        if pos >= n:
+            pos = 0
+        if total > out:
+            out = total
+
+bench.run(test)
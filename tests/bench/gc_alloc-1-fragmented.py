@@ -0,0 +1,43 @@
+import bench
+import gc
+
+# Allocate from a heap whose free space has been broken up into small holes,
+# so that every allocation bigger than a hole has to skip over all of them.
+# Per-allocation latency percentiles are written to stderr when ticks_us is
+# available; the total time is the benchmark result.
+
+try:
+    import sys
+    from utime import ticks_us, ticks_diff
+except ImportError:
+    ticks_us = None
+
+def fragment():
+    keep = []
+    drop = []
+    while gc.mem_free() > 32 * 1024:
+        keep.append(bytearray(16))
+        drop.append(bytearray(16))
+    drop = None
+    gc.collect()
+    return keep
+
+def test(num):
+    n = num // 10000
+    times = [0] * n
+    keep = fragment()
+    for i in range(n):
+        t = ticks_us() if ticks_us else 0
+        b = bytearray(48 + (i & 3) * 16)
+        if ticks_us:
+            times[i] = ticks_diff(ticks_us(), t)
+        b = None
+        if i & 127 == 0:
+            gc.collect()
+    if ticks_us:
+        times.sort()
+        sys.stderr.write("p50 %dus p90 %dus p99 %dus max %dus\n" % (
+            times[n // 2], times[n * 9 // 10], times[n * 99 // 100], times[-1]))
+    keep = None
+
+bench.run(test)
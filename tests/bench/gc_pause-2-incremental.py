@@ -0,0 +1,32 @@
+import bench
+import gc
+
+# Churn through short-lived allocations next to a large live structure so that
+# automatic collections keep happening, with collections split as given to
+# gc.incremental().  The worst allocation latency seen by the program and the
+# longest slice are written to stderr when ticks_us is available.
+
+try:
+    import sys
+    from utime import ticks_us, ticks_diff
+except ImportError:
+    ticks_us = None
+
+def test(num):
+    try:
+        gc.incremental(4096, 1000)
+    except AttributeError:
+        pass
+    live = [[i] * 8 for i in range(4000)]
+    worst = 0
+    for i in range(num // 100):
+        t = ticks_us() if ticks_us else 0
+        b = [i, i]
+        if ticks_us:
+            worst = max(worst, ticks_diff(ticks_us(), t))
+    if ticks_us and hasattr(gc, "pause_stats"):
+        slices, max_pause = gc.pause_stats()
+        sys.stderr.write("worst alloc %dus, %d slices, longest %dus\n" % (worst, slices, max_pause))
+    live = None
+
+bench.run(test)
@@ -0,0 +1,21 @@
+import bench
+
+try:
+    from collections import OrderedDict
+except ImportError:
+    from ucollections import OrderedDict
+
+# Look up every key of a 32-entry OrderedDict, which keeps insertion order.
+
+def test(num):
+    keys = ["key%d" % i for i in range(32)]
+    d = OrderedDict((k, 1) for k in keys)
+    for i in range(num // 20 // 32):
+        for k in keys:
+            d[k]
+            d[k]
+            d[k]
+            d[k]
+            d[k]
+
+bench.run(test)
@@ -0,0 +1,21 @@
+import bench
+
+try:
+    from collections import OrderedDict
+except ImportError:
+    from ucollections import OrderedDict
+
+# Look up every key of a 128-entry OrderedDict, which keeps insertion order.
+
+def test(num):
+    keys = ["key%d" % i for i in range(128)]
+    d = OrderedDict((k, 1) for k in keys)
+    for i in range(num // 20 // 128):
+        for k in keys:
+            d[k]
+            d[k]
+            d[k]
+            d[k]
+            d[k]
+
+bench.run(test)
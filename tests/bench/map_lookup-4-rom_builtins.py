@@ -0,0 +1,11 @@
+import bench
+
+# Look up names that fall through to the ROM table of the builtins module,
+# which is a fixed ordered map of about 80 entries.
+
+def test(num):
+    for i in range(num // 100):
+        zip; sorted; setattr; repr; round
+        zip; sorted; setattr; repr; round
+
+bench.run(test)
@@ -0,0 +1,16 @@
+import bench
+
+# Look up a string that isn't interned after growing the runtime qstr pools
+# to 10000 entries; str() of bytes looks for an existing qstr first.
+
+def intern(n):
+    for i in range(n):
+        getattr(bench, "qstr_find_%d" % i, None)
+
+def test(num):
+    intern(10000)
+    key = b"qstr_find_miss"
+    for i in iter(range(num // 20)):
+        str(key, "utf-8")
+
+bench.run(test)
@@ -0,0 +1,17 @@
+import bench
+import usocket as socket
+import uselect as select
+
+# Poll a single registered stream, which is ready.
+
+def test(num):
+    addr = socket.getaddrinfo("127.0.0.1", 0)[0][-1]
+    u = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    u.bind(addr)
+    p = select.poll()
+    p.register(u, select.POLLOUT)
+    for i in range(num // 100):
+        p.poll(0)
+    u.close()
+
+bench.run(test)
@@ -0,0 +1,26 @@
+import bench
+import usocket as socket
+import uselect as select
+
+# Poll 64 registered streams, of which only one is ready.
+
+def test(num):
+    addr = socket.getaddrinfo("127.0.0.1", 0)[0][-1]
+    idle = []
+    p = select.poll()
+    for i in range(63):
+        s = socket.socket()
+        s.bind(addr)
+        s.listen(1)
+        idle.append(s)
+        p.register(s, select.POLLIN)
+    u = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    u.bind(addr)
+    p.register(u, select.POLLOUT)
+    for i in range(num // 100):
+        p.poll(0)
+    for s in idle:
+        s.close()
+    u.close()
+
+bench.run(test)
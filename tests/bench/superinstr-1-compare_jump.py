@@ -0,0 +1,14 @@
+import bench
+
+# Comparisons against small constants that feed straight into a branch; each
+# "if"/"while" test fuses into a single compare-and-jump instruction.
+
+def test(num):
+    i = 0
+    n = 0
+    while i < num:
+        if i & 3 == 0:
+            n += 1
+        i += 1
+
+bench.run(test)
@@ -0,0 +1,15 @@
+import bench
+
+# Expressions over pairs of locals; consecutive local loads fuse into one
+# instruction.
+
+def test(num):
+    a = 1
+    b = 2
+    c = 0
+    for i in range(num // 4):
+        c = a + b
+        c = a * b - c
+        a, b = b, a
+
+bench.run(test)
@@ -0,0 +1,12 @@
+import bench
+
+# Augmented assignment to list items, where the subscript load and store each
+# fuse with the stack shuffling around them.
+
+def test(num):
+    hist = [0] * 16
+    for i in range(num // 4):
+        hist[i & 15] += 1
+        hist[i & 7] -= 1
+
+bench.run(test)
@@ -0,0 +1,20 @@
+import bench
+import ujson
+
+# Parse a config document of about 5KB that is already in memory.
+
+DOC = ujson.dumps({
+    "device": "sensor-node",
+    "version": [1, 4, 2],
+    "channels": [
+        {"name": "channel%d" % i, "enabled": i % 3 != 0, "rate": 100 * i, "gain": i / 4,
+         "label": "Temperature probe number %d on the north wall" % i}
+        for i in range(40)
+    ],
+})
+
+def test(num):
+    for i in range(num // 4000):
+        ujson.loads(DOC)
+
+bench.run(test)
@@ -0,0 +1,24 @@
+import bench
+import ujson
+try:
+    from uio import BytesIO
+except ImportError:
+    from io import BytesIO
+
+# Parse a config document of about 5KB that is read from a stream.
+
+DOC = ujson.dumps({
+    "device": "sensor-node",
+    "version": [1, 4, 2],
+    "channels": [
+        {"name": "channel%d" % i, "enabled": i % 3 != 0, "rate": 100 * i, "gain": i / 4,
+         "label": "Temperature probe number %d on the north wall" % i}
+        for i in range(40)
+    ],
+}).encode()
+
+def test(num):
+    for i in range(num // 4000):
+        ujson.load(BytesIO(DOC))
+
+bench.run(test)
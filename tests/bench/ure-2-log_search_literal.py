@@ -0,0 +1,19 @@
+import bench
+import ure
+
+# Find a field that starts with a fixed string somewhere in each log line.
+
+LINES = [
+    "2019-03-14 12:01:33 INFO  wifi: connected to ap-7 rssi=-61",
+    "2019-03-14 12:01:34 WARN  sensor: retry 3 on i2c addr=0x44",
+    "2019-03-14 12:01:35 ERROR main: timeout after 1500 ms",
+    "2019-03-14 12:01:36 DEBUG display: refresh 240x135 in 38 ms",
+]
+
+def test(num):
+    r = ure.compile(r"addr=(0x\w+)")
+    for i in range(num // 1000):
+        for line in LINES:
+            r.search(line)
+
+bench.run(test)
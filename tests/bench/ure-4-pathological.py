@@ -0,0 +1,13 @@
+import bench
+import ure
+
+# Nested repeats that fail to match only at the very end; a backtracking
+# matcher tries every way of splitting up the run of "a"s.
+
+def test(num):
+    r = ure.compile("(a|aa)*c")
+    s = "a" * 20
+    for i in range(num // 200000):
+        r.match(s)
+
+bench.run(test)
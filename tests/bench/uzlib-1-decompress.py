@@ -0,0 +1,18 @@
+import bench
+import uzlib
+import uio
+
+# Decompress log-like text to about five times the size of the input, which
+# needs the output buffer to grow several times.
+
+def test(num):
+    buf = uio.BytesIO()
+    out = uzlib.CompIO(buf)
+    for i in range(1000):
+        out.write(b"2019-03-14 12:01:%02d INFO sensor: temp=%d.%d\n" % (i % 60, 20 + i % 7, i % 10))
+    out.close()
+    data = buf.getvalue()
+    for i in range(num // 4000):
+        uzlib.decompress(data)
+
+bench.run(test)
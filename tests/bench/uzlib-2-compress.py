@@ -0,0 +1,15 @@
+import bench
+import uzlib
+import uio
+
+# Compress log-like text written a line at a time.
+
+def test(num):
+    lines = [b"2019-03-14 12:01:%02d INFO sensor: temp=%d.%d\n" % (i % 60, 20 + i % 7, i % 10) for i in range(1000)]
+    for i in range(num // 40000):
+        out = uzlib.CompIO(uio.BytesIO())
+        for l in lines:
+            out.write(l)
+        out.close()
+
+bench.run(test)
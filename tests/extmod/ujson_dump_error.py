@@ -0,0 +1,19 @@
+# test that ujson.dump writes what it printed before an error
+
+try:
+    from uio import StringIO
+    import ujson as json
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+class A:
+    def __repr__(self):
+        raise ValueError('bad repr')
+
+s = StringIO()
+try:
+    json.dump([1, "abc", {"x": None}, A()], s)
+except ValueError as e:
+    print('ValueError', e)
+print(s.getvalue())
@@ -0,0 +1,34 @@
+# test parsing documents longer than what ujson.load reads at a time
+
+try:
+    from uio import StringIO, BytesIO
+    import ujson as json
+except:
+    try:
+        from io import StringIO, BytesIO
+        import json
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+doc = '{"name": "%s", "path": "a\\\\b\\"c\\u0041\\n", "values": [%s], "nested": {"x": [-1.5e3, 2.25, -7, null, true, false]}}' % (
+    "x" * 100, ", ".join([str(i * 12345) for i in range(40)]))
+
+for d in (doc, doc.replace(" ", "")):
+    obj = json.load(StringIO(d))
+    print(obj["name"] == "x" * 100, obj["path"], sum(obj["values"]), obj["nested"])
+    print(json.loads(d) == obj, json.loads(d.encode()) == obj)
+    print(json.load(BytesIO(d.encode())) == obj)
+
+# trailing whitespace after a long document, and junk after it
+print(len(json.load(StringIO("[" + "1," * 100 + "2]   \n"))))
+try:
+    json.load(StringIO("[" + "1," * 100 + "2] x"))
+except ValueError:
+    print("ValueError")
+
+# a string cut short at the end of the input
+try:
+    json.loads('"' + "a" * 200)
+except ValueError:
+    print("ValueError")
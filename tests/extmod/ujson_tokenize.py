@@ -0,0 +1,42 @@
+# test parsing a JSON stream a piece at a time
+
+try:
+    from uio import StringIO
+    import ujson as json
+    json.tokenize
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+def test(s):
+    try:
+        print(list(json.tokenize(StringIO(s))))
+    except ValueError:
+        print("ValueError")
+
+test('null')
+test(' "abc\\u0064e" ')
+test('[]')
+test('{}')
+test('[false, true, 1, -2.5, "x"]')
+test('{"a": [1, {"b": null}], "c": {}}')
+test('[[], [[]], {"d": []}]')
+
+# a document longer than what is read at a time
+print(len(list(json.tokenize(StringIO('[' + '{"key": "value"}, ' * 40 + '0]')))))
+
+# errors are found as the stream is read
+for s in ('', '[', '[1,]', '[1 2]', '[1,,2]', '{"a"}', '{"a":}', '{"a":1,}', '{1: 2}',
+          '{"a" 1}', '{"a", 1}', '[}', '{]', '[1]]', '1 2', '[:1]'):
+    test(s)
+it = json.tokenize(StringIO('[1, 2] x'))
+print(next(it), next(it), next(it), next(it))
+try:
+    next(it)
+except ValueError:
+    print("ValueError")
+
+try:
+    list(json.tokenize(StringIO('[' * 1000)))
+except RuntimeError:
+    print("RuntimeError")
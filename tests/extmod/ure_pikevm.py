@@ -0,0 +1,61 @@
+# test matching that needs the Pike VM, which takes time linear in the subject
+
+try:
+    import ure as re
+except ImportError:
+    try:
+        import re
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+# the backtracking matcher runs out of stack on this
+try:
+    re.match("(a*)*", "aaa")
+except RuntimeError:
+    print("SKIP")
+    raise SystemExit
+
+def print_groups(match):
+    print('----')
+    try:
+        if match is not None:
+            i = 0
+            while True:
+                print(match.group(i))
+                i += 1
+    except IndexError:
+        pass
+
+print(re.match("(a*)*", "aaa").group(0))
+print_groups(re.match("(a|b)*c", "ab" * 1000 + "c"))
+print_groups(re.match("(ab)*c", "ab" * 1000 + "c"))
+print_groups(re.match("(a|aa)*c", "a" * 25))
+print_groups(re.match("(a|aa)*c", "a" * 25 + "c"))
+print_groups(re.match("(a+)+b", "a" * 30))
+
+# earliest match, leftmost alternative
+print_groups(re.search("a|ab", "xxab"))
+print_groups(re.search("(a+?)(a*)", "baaa"))
+print_groups(re.search("x*", "abc"))
+
+# searching for a literal prefix, with candidates that fail first
+print_groups(re.search("abc(d|e)", "abcx abcf abce"))
+print_groups(re.search("abc(d|e)", "ab abc abcx"))
+print_groups(re.search("a(b|c)+d", "ab ac abbbd"))
+print_groups(re.search("(a)(b|c)*", "xxx"))
+print_groups(re.search("hello( world)?", "say hello"))
+
+# anchors
+print_groups(re.search("^(a|b)+", "ab"))
+print_groups(re.search("^(a|b)+", "xab"))
+print_groups(re.search("(a|b)+$", "abxab"))
+print_groups(re.search("(a|b)*$", "abx"))
+print_groups(re.match("(a|b)*$", ""))
+
+# a compiled pattern reused, and the module functions that compile one per call
+r = re.compile("(a|b)+(c)")
+for s in ("xx", "abc", "bbc", "ac"):
+    print_groups(r.search(s))
+for i in range(3):
+    print_groups(re.match("(a|b)+(c)", "ab" * i + "c"))
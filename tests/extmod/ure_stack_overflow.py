@@ -11,3 +11,6 @@ try:
     re.match("(a*)*", "aaa")
 except RuntimeError:
     print("RuntimeError")
+else:
+    # matched without recursing, by the Pike VM
+    print("SKIP")
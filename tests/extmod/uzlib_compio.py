@@ -0,0 +1,71 @@
+try:
+    import uzlib as zlib
+    import uio as io
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    zlib.CompIO
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+
+def compress(data, *args, flush_at=None):
+    buf = io.BytesIO()
+    out = zlib.CompIO(buf, *args)
+    if flush_at is not None:
+        out.write(data[:flush_at])
+        out.flush()
+        data = data[flush_at:]
+    out.write(data)
+    out.close()
+    return buf.getvalue()
+
+
+# fixed Huffman codes, so the output for short inputs is known exactly
+print(compress(b''))
+print(compress(b'hello'))
+print(compress(b'hello', -10))
+print(compress(b'hello', 16 + 10))
+
+PATTERNS = [
+    b'0' * 100,
+    bytes(range(64)),
+    b'13371813150|13764518736|12345678901' * 20,
+    bytes([i * 7 & 0xff for i in range(1000)]) * 3,
+]
+
+for data in PATTERNS:
+    for wbits in (9, 10, 15):
+        packed = compress(data, wbits)
+        assert zlib.decompress(packed) == data
+    packed = compress(data, -9)
+    assert zlib.decompress(packed, -9) == data
+    # a sync flush part way through leaves a stream that can be read to there
+    packed = compress(data, 10, flush_at=len(data) // 2)
+    assert zlib.DecompIO(io.BytesIO(packed)).read() == data
+    packed = compress(data, 16 + 10)
+    assert zlib.DecompIO(io.BytesIO(packed), 16 + 10).read() == data
+    print(len(data), len(compress(data)))
+
+# bad window size
+try:
+    zlib.CompIO(io.BytesIO(), 20)
+except ValueError:
+    print('ValueError')
+
+# write after close
+out = zlib.CompIO(io.BytesIO())
+out.close()
+try:
+    out.write(b'x')
+except OSError as e:
+    print(repr(e))
+
+# context manager closes the stream
+buf = io.BytesIO()
+with zlib.CompIO(buf) as out:
+    out.write(b'hello')
+print(zlib.decompress(buf.getvalue()))
@@ -0,0 +1,32 @@
+try:
+    import uzlib as zlib
+    import uio as io
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+packed = b'x\x9c30\xa0=\x00\x00\xb3q\x12\xc1'
+
+# bufsize as the size to start with
+print(zlib.decompress(packed, 0, 1))
+print(zlib.decompress(packed, 0, 101) == b'0' * 100)
+
+# bufsize as a buffer to decompress into, which may fit the data exactly
+for size in (110, 100):
+    buf = bytearray(size)
+    n = zlib.decompress(packed, 0, buf)
+    print(n, buf[:n] == b'0' * 100)
+for size in (99, 50, 0):
+    try:
+        zlib.decompress(packed, 0, bytearray(size))
+    except ValueError:
+        print('ValueError')
+
+# DecompIO with the dictionary in a buffer that is passed in
+window = bytearray(256)
+inp = zlib.DecompIO(io.BytesIO(b'\xcbH\xcd\xc9\xc9\x07\x00'), -8, window)
+print(inp.read())
+try:
+    zlib.DecompIO(io.BytesIO(b'\xcbH\xcd\xc9\xc9\x07\x00'), -9, window)
+except ValueError:
+    print('ValueError')
@@ -0,0 +1,18 @@
+# tests attr_cache_stats function in micropython module
+import micropython
+
+if not hasattr(micropython, 'attr_cache_stats'):
+    print('SKIP')
+    raise SystemExit
+
+class A:
+    def f(self):
+        return 1
+
+a = A()
+a.f()
+hits, misses = micropython.attr_cache_stats()
+for i in range(10):
+    a.f()
+hits2, misses2 = micropython.attr_cache_stats()
+print(hits2 - hits >= 10, misses2 - misses)
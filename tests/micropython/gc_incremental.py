@@ -0,0 +1,43 @@
+# test the incremental garbage collector
+
+import gc
+
+try:
+    gc.incremental
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+old = gc.incremental()
+
+# slice size is rounded up to whole blocks, 0 means stop-the-world
+gc.incremental(0)
+print(gc.incremental()[0])
+gc.incremental(1, 0)
+print(gc.incremental()[0] > 0, gc.incremental()[1])
+
+# an explicit collection is split into many slices
+gc.incremental(64, 0)
+keep = [[i, str(i), (i, i)] for i in range(1000)]
+gc.pause_stats()
+gc.collect()
+slices, max_pause = gc.pause_stats()
+print(slices > 1, max_pause >= 0)
+
+# live objects survive collections whose sweep is left to the allocator,
+# including ones allocated while that sweep is still pending
+for i in range(20000):
+    b = bytearray(500)
+    if i % 20 == 0:
+        keep[i // 20].append(b)
+        keep.append({i: [i] * 3})
+print(all(keep[i] == [i, str(i), (i, i), keep[i][3]] for i in range(1000)))
+print(all(len(keep[i][3]) == 500 for i in range(1000)))
+print(all(keep[1000 + i] == {20 * i: [20 * i] * 3} for i in range(1000)))
+
+# mem_free() finishes any pending sweep
+free = gc.mem_free()
+gc.collect()
+print(gc.mem_free() >= free // 2)
+
+gc.incremental(*old)
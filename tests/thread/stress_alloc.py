@@ -0,0 +1,37 @@
+# allocation throughput from several threads at once: each thread makes lots of
+# small short-lived objects while keeping some alive across collections
+#
+# time this with the unix port to compare allocators, eg:
+#   time micropython stress_alloc.py
+
+try:
+    import utime as time
+except ImportError:
+    import time
+import _thread
+
+def thread_entry(n):
+    keep = 16 * [None]
+    total = 0
+    for i in range(n):
+        # tuples, small lists and floats are all single heap blocks
+        t = (i, i + 1)
+        l = [i]
+        total += t[1] - l[0] + int(float(i) - i)
+        keep[i % 16] = [i, i, i]
+    # check the objects that survived collections are intact
+    ok = all(k == [n - 16 + j] * 3 for j, k in enumerate(keep))
+    with lock:
+        print(total == n, ok)
+        global n_finished
+        n_finished += 1
+
+lock = _thread.allocate_lock()
+n_thread = 4
+n_finished = 0
+
+for i in range(n_thread):
+    _thread.start_new_thread(thread_entry, (100000,))
+
+while n_finished < n_thread:
+    time.sleep(0.01)
@@ -0,0 +1,48 @@
+# test threads matching the same compiled regex at the same time
+
+try:
+    import ure as re
+except ImportError:
+    try:
+        import re
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+import _thread
+
+# a pattern that can branch, and strings that leave different groups set
+regex = re.compile(r"(a+|b+)(c|d)*e")
+subjects = ("aaace", "bbde", "abcdcde", "xe")
+
+def thread_entry(n):
+    ok = True
+    for i in range(n):
+        s = subjects[i % len(subjects)]
+        m = regex.search(s)
+        r = m and (m.group(0), m.group(1), m.group(2))
+        if r != expected[s]:
+            ok = False
+    with lock:
+        global n_ok, n_finished
+        n_ok += ok
+        n_finished += 1
+
+expected = {}
+for s in subjects:
+    m = regex.search(s)
+    expected[s] = m and (m.group(0), m.group(1), m.group(2))
+print([expected[s] for s in subjects])
+
+lock = _thread.allocate_lock()
+n_thread = 4
+n_finished = 0
+n_ok = 0
+
+for i in range(n_thread):
+    _thread.start_new_thread(thread_entry, (200,))
+
+# busy wait for threads to finish
+while n_finished < n_thread:
+    pass
+print(n_ok == n_thread)
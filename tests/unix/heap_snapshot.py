@@ -0,0 +1,79 @@
+# test restoring the heap saved by micropython.heap_snapshot at startup
+
+import micropython
+
+try:
+    import uos
+    micropython.heap_snapshot
+    uos.system
+    pid = open('/proc/self/stat').read().split()[0]
+except (ImportError, AttributeError, OSError):
+    print("SKIP")
+    raise SystemExit
+
+exe = '/proc/%s/exe' % pid
+files = {
+    'heap_snapshot_mod.py': """
+X = [1, 2, 3]
+D = {'a': 1, 'b': (2, 3)}
+class C:
+    def __init__(self, v):
+        self.v = v
+    def f(self):
+        return self.v * 2
+def g(n):
+    return sum(C(i).f() for i in range(n))
+S = 'interned_after_boot_' + str(len(X))
+# raw data that looks like a pointer into the heap is left alone
+N = id(X)
+B = bytearray(N.to_bytes(8, 'little'))
+F = 1.5
+""",
+    'heap_snapshot_warm.py': """
+import micropython
+import heap_snapshot_mod
+with open('heap_snapshot.bin', 'wb') as f:
+    micropython.heap_snapshot(f)
+""",
+    'heap_snapshot_code.py': """
+import sys, gc
+print('heap_snapshot_mod' in sys.modules)
+import heap_snapshot_mod as m
+print(m.X, m.D['b'], m.S, m.g(10), m.C(4).f(), m.C.__name__)
+print(int.from_bytes(m.B, 'little') == m.N, m.F)
+gc.collect()
+l = [str(i) for i in range(100)]
+gc.collect()
+print(m.g(5), len(l), __name__)
+""",
+}
+for name, src in files.items():
+    with open(name, 'w') as f:
+        f.write(src)
+
+def run(opts, script):
+    uos.system('%s %s %s' % (exe, opts, script))
+
+run('', 'heap_snapshot_warm.py')
+run('-X snapshot=heap_snapshot.bin', 'heap_snapshot_code.py')
+# the heap can be a different size
+run('-X snapshot=heap_snapshot.bin -X heapsize=200k', 'heap_snapshot_code.py')
+run('', 'heap_snapshot_code.py')
+# one that is cut short isn't used
+with open('heap_snapshot.bin', 'rb') as f:
+    data = f.read()
+with open('heap_snapshot_short.bin', 'wb') as f:
+    f.write(data[:len(data) // 2])
+run('-X snapshot=heap_snapshot_short.bin', 'heap_snapshot_code.py')
+
+for name in list(files) + ['heap_snapshot.bin', 'heap_snapshot_short.bin']:
+    uos.unlink(name)
+
+# objects that can't be restored are refused before anything is written
+import sys, uio
+sys.modules['heap_snapshot_it'] = iter([])
+try:
+    micropython.heap_snapshot(uio.BytesIO())
+except RuntimeError as e:
+    print(e)
+del sys.modules['heap_snapshot_it']
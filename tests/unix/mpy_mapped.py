@@ -0,0 +1,232 @@
+# test running .mpy files in place from a mapping, and the copying fallback
+
+import sys, gc, uio
+
+try:
+    import uos
+    uos.unlink
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+# with a VFS, imports go through the VFS layer and the heap used by a module
+# no longer shows whether its file was mapped
+if hasattr(uos, 'mount'):
+    print("SKIP")
+    raise SystemExit
+
+# the same module from the current mpy-cross, which numbers the qstr slots in
+# the bytecode so it can run in place, and from an older one which does not:
+#     X = 6
+#     def f(a, b=2):
+#         return a * b + X
+#     class C:
+#         def m(self):
+#             return type(self).__name__
+#     def g():
+#         raise ValueError("boom")
+#     def h(a):
+#         a = (a * 3 + 1) % 1000  # 100 times
+#         return a
+mpy_files = {
+    'mpy_mapped_new': (
+        b'M\x03\x03\x1f7\x03\x00\x00\x00\x00\x00\x0c\x00\x00\x01\x00Eik e'
+        b'\x00\x00\xff\x86$\x02\x00\x82P\x01\x18a\x00$\x03\x00 `\x01\x16'
+        b'\x04\x00d\x02$\x05\x00`\x02$\x06\x00`\x03$\x07\x00\x11[\x08<modu'
+        b'le>\x06mod.py\x01X\x01f\x01C\x01C\x01g\x01h\x00\x04\x18\x04\x00'
+        b'\x00\x02\x00\x01\x08\x00\x00\x01\x00a\x00\x00\xff\xb0\xb1\xf3'
+        b'\x1c\x02\x00\x00\xf1[\x01f\x06mod.py\x01X\x00\x00\x01a\x01b$\x01'
+        b'\x00\x00\x00\x00\x00\t\x00\x00\x01\x00n`\x00\x00\xff\x1b\x02\x00'
+        b'\x00$\x03\x00\x16\x04\x00$\x05\x00`\x00$\x06\x00\x11[\x01C\x06mo'
+        b'd.py\x08__name__\n__module__\x01C\x0c__qualname__\x01m\x00\x01'
+        b'\x1c\x03\x00\x00\x01\x00\x00\t\x00\x00\x01\x00\x81\x07\x00\x00'
+        b'\xff\x1c\x02\x00\x00\xb0d\x01\x1d\x03\x00\x00[\x01m\x06mod.py'
+        b'\x04type\x08__name__\x00\x00\x04self\x1d\x02\x00\x00\x00\x00\x00'
+        b'\t\x00\x00\x01\x00\x81\n\x00\x00\xff\x1c\x02\x00\x00\x16\x03\x00'
+        b'd\x01\\\x01\x11[\x01g\x06mod.py\nValueError\x04boom\x00\x00\x88^'
+        b'\x03\x00\x00\x01\x00\x00m\x00\x00\x01\x00\x81\r*****************'
+        b'****************************************************************'
+        b'*******************\x00\x00\xff\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6'
+        b'\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1'
+        b'\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83'
+        b'\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0[\x01h\x06mod.py\x00\x00\x01a'
+    ),
+    'mpy_mapped_old': (
+        b'M\x03\x03\x1f7\x03\x00\x00\x00\x00\x00\x0c5\x00\x13\x01Eik e\x00'
+        b'\x00\xff\x86$\x14\x01\x82P\x01\x18a\x00$\x15\x01 `\x01\x16\x18'
+        b'\x01d\x02$\x18\x01`\x02$\x1b\x01`\x03$\x1d\x01\x11[\x08<module>'
+        b'\x06mod.py\x01X\x01f\x01C\x01C\x01g\x01h\x00\x04\x18\x04\x00\x00'
+        b'\x02\x00\x01\x08\x15\x01\x13\x01a\x00\x00\xff\xb0\xb1\xf3\x1c'
+        b'\x14\x01\x00\xf1[\x01f\x06mod.py\x01X\x00\x00\x01a\x01b$\x01\x00'
+        b'\x00\x00\x00\x00\t\x18\x01\x13\x01n`\x00\x00\xff\x1b \x00\x00$'
+        b'\x1f\x00\x16\x18\x01$$\x00`\x00$\x19\x01\x11[\x01C\x06mod.py\x08'
+        b'__name__\n__module__\x01C\x0c__qualname__\x01m\x00\x01\x1c\x03'
+        b'\x00\x00\x01\x00\x00\t\x19\x01\x13\x01\x81\x07\x00\x00\xff\x1c\t'
+        b'\x01\x00\xb0d\x01\x1d \x00\x00[\x01m\x06mod.py\x04type\x08__name'
+        b'__\x00\x00\x04self\x1d\x02\x00\x00\x00\x00\x00\t\x1b\x01\x13\x01'
+        b'\x81\n\x00\x00\xff\x1cr\x00\x00\x16\x1c\x01d\x01\\\x01\x11[\x01g'
+        b'\x06mod.py\nValueError\x04boom\x00\x00\x88^\x03\x00\x00\x01\x00'
+        b'\x00m\x1d\x01\x13\x01\x81\r*************************************'
+        b'***************************************************************'
+        b'\x00\x00\xff\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3'
+        b'\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0'
+        b'\xb0\x83\xf3\x81\xf1\x14\x87h\xf6\xc0\xb0\x83\xf3\x81\xf1\x14'
+        b'\x87h\xf6\xc0\xb0[\x01h\x06mod.py\x00\x00\x01a'
+    ),
+}
+
+buf = uio.StringIO()
+
+def run(mod):
+    gc.collect()
+    m0 = gc.mem_alloc()
+    m = __import__(mod)
+    gc.collect()
+    m1 = gc.mem_alloc()
+    print(m.f.__name__, m.f(3), m.C().m(), m.X, m.h(5))
+    try:
+        m.g()
+    except ValueError as e:
+        print(repr(e))
+        sys.print_exception(e, buf)
+    del sys.modules[mod]
+    return m1 - m0
+
+for mod, data in mpy_files.items():
+    with open(mod + '.mpy', 'wb') as f:
+        f.write(data)
+sys.path.insert(0, '')
+try:
+    # import each once so that both see the same interned qstrs
+    for mod in mpy_files:
+        run(mod)
+    new = run('mpy_mapped_new')
+    old = run('mpy_mapped_old')
+except Exception as e:
+    if type(e).__name__ != 'MpyError':
+        raise
+    print("SKIP")
+    raise SystemExit
+finally:
+    sys.path.pop(0)
+    for mod in mpy_files:
+        uos.unlink(mod + '.mpy')
+
+# tracebacks take the function and file names from the link table
+print(buf.getvalue().count('File "mod.py", line 11, in g'))
+# the bytecode run in place is not on the heap
+print(new < old)
@@ -0,0 +1,80 @@
+# test uselect.poll on sockets and files, which an epoll set can't wait on
+
+try:
+    import usocket as socket
+    import uselect as select
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+addr = socket.getaddrinfo("127.0.0.1", 0)[0][-1]
+idle = []
+for i in range(5):
+    s = socket.socket()
+    s.bind(addr)
+    s.listen(1)
+    idle.append(s)
+u = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+u.bind(addr)
+u2 = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+u2.bind(addr)
+
+p = select.poll()
+for s in idle[:2]:
+    print(p.register(s, select.POLLIN))
+p.register(u)
+for s in idle[2:]:
+    p.register(s, select.POLLIN)
+print(p.register(u, select.POLLOUT))
+
+# only the datagram socket is ready, and only for writing
+print([(s is u, ev) for s, ev in p.poll(0)])
+print([(s is u, ev) for s, ev in p.ipoll(0)])
+
+# more than one ready comes back in the order registered
+p.register(u2, select.POLLOUT)
+print([(s is u, ev) for s, ev in p.poll(0)])
+p.unregister(u)
+p.register(u, select.POLLOUT)
+print([(s is u, ev) for s, ev in p.poll(0)])
+p.unregister(u2)
+
+# one-shot polling stops reporting until the entry is modified
+print(len(p.poll(0, 1)), len(p.poll(0)))
+p.modify(u, select.POLLOUT)
+print(len(p.poll(0)))
+
+p.unregister(u)
+print(p.poll(0))
+p.register(u, select.POLLOUT)
+print(len(p.poll(0)))
+
+# a closed fd is reported with POLLNVAL, without waiting
+c = socket.socket()
+p.register(c, select.POLLIN)
+c.close()
+print(sorted([ev for s, ev in p.poll(0)]))
+print(sorted([ev for s, ev in p.poll(-1)]))
+# until the fd is opened again, for another socket
+d = socket.socket()
+print(d.fileno() == c.fileno(), sorted([ev for s, ev in p.poll(0)]))
+d.close()
+p.modify(c, select.POLLIN)
+print(sorted([ev for s, ev in p.poll(0)]))
+print(sorted([ev for s, ev in p.poll(0, 1)]))
+p.unregister(c)
+print(len(p.poll(0)))
+p.register(c.fileno(), select.POLLIN)
+print([(s == c.fileno(), ev) for s, ev in p.ipoll(0)])
+p.unregister(c.fileno())
+
+# a device file is always ready
+f = open("/dev/null", "rb")
+p.register(f, select.POLLIN)
+print(sorted([ev & select.POLLIN for s, ev in p.ipoll(0)]))
+f.close()
+
+for s in idle:
+    s.close()
+u.close()
+u2.close()
@@ -61,6 +61,7 @@ class Config:
     MICROPY_LONGINT_IMPL_NONE = 0
     MICROPY_LONGINT_IMPL_LONGLONG = 1
     MICROPY_LONGINT_IMPL_MPZ = 2
+    MICROPY_OPT_SUPERINSTRUCTIONS = False
 config = Config()
 
 MP_OPCODE_BYTE = 0
@@ -77,6 +78,13 @@ MP_BC_LOAD_NAME = 0x1c
 MP_BC_LOAD_GLOBAL = 0x1d
 MP_BC_LOAD_ATTR = 0x1e
 MP_BC_STORE_ATTR = 0x26
+# superinstructions, with 1 or 2 extra bytes:
+MP_BC_LOAD_FAST_LOAD_FAST = 0x48
+MP_BC_BINARY_OP_SMALL_INT = 0x49
+MP_BC_BINARY_OP_POP_JUMP_IF_TRUE = 0x4a
+MP_BC_BINARY_OP_POP_JUMP_IF_FALSE = 0x4b
+MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_TRUE = 0x4c
+MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_FALSE = 0x4d
 
 # load opcode names
 opcode_names = {}
@@ -118,8 +126,8 @@ def make_opcode_format():
     OC4(U, O, B, O), # 0x3c-0x3f
     OC4(O, B, B, O), # 0x40-0x43
     OC4(B, B, O, B), # 0x44-0x47
-    OC4(U, U, U, U), # 0x48-0x4b
-    OC4(U, U, U, U), # 0x4c-0x4f
+    OC4(B, B, O, O), # 0x48-0x4b
+    OC4(O, O, B, B), # 0x4c-0x4f
     OC4(V, V, U, V), # 0x50-0x53
     OC4(B, U, V, V), # 0x54-0x57
     OC4(V, V, V, B), # 0x58-0x5b
@@ -180,7 +188,7 @@ def mp_opcode_format(bytecode, ip, opcode_format=make_opcode_format()):
     if f == MP_OPCODE_QSTR:
         ip += 3
     else:
-        extra_byte = (
+        extra_bytes = int(
             opcode == MP_BC_RAISE_VARARGS
             or opcode == MP_BC_MAKE_CLOSURE
             or opcode == MP_BC_MAKE_CLOSURE_DEFARGS
@@ -191,6 +199,12 @@ def mp_opcode_format(bytecode, ip, opcode_format=make_opcode_format()):
                 or opcode == MP_BC_STORE_ATTR
             )
         )
+        if opcode in (MP_BC_LOAD_FAST_LOAD_FAST, MP_BC_BINARY_OP_POP_JUMP_IF_TRUE,
+                MP_BC_BINARY_OP_POP_JUMP_IF_FALSE):
+            extra_bytes = 1
+        elif opcode in (MP_BC_BINARY_OP_SMALL_INT, MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_TRUE,
+                MP_BC_BINARY_OP_SMALL_INT_POP_JUMP_IF_FALSE):
+            extra_bytes = 2
         ip += 1
         if f == MP_OPCODE_VAR_UINT:
             while bytecode[ip] & 0x80 != 0:
@@ -198,7 +212,7 @@ def mp_opcode_format(bytecode, ip, opcode_format=make_opcode_format()):
             ip += 1
         elif f == MP_OPCODE_OFFSET:
             ip += 2
-        ip += extra_byte
+        ip += extra_bytes
     return f, ip - ip_start
 
 def decode_uint(bytecode, ip):
@@ -489,6 +503,7 @@ def read_mpy(filename):
         feature_flags = header[2]
         config.MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE = (feature_flags & 1) != 0
         config.MICROPY_PY_BUILTINS_STR_UNICODE = (feature_flags & 2) != 0
+        config.MICROPY_OPT_SUPERINSTRUCTIONS |= (feature_flags & 4) != 0
         config.mp_small_int_bits = header[3]
         return read_raw_code(f)
 
@@ -518,6 +533,12 @@ def freeze_mpy(base_qstrs, raw_codes):
     print('#endif')
     print()
 
+    if config.MICROPY_OPT_SUPERINSTRUCTIONS:
+        print('#if !MICROPY_OPT_SUPERINSTRUCTIONS')
+        print('#error "frozen bytecode uses superinstructions but MICROPY_OPT_SUPERINSTRUCTIONS is disabled"')
+        print('#endif')
+        print()
+
     print('#if MICROPY_LONGINT_IMPL != %u' % config.MICROPY_LONGINT_IMPL)
     print('#error "incompatible MICROPY_LONGINT_IMPL"')
     print('#endif')